@@ -0,0 +1,462 @@
+/**
+ * \file   DecoderBenchmark.cpp
+ * \brief  Decoder microbenchmark: ns/frame, bytes/s and allocations/frame.
+ * Feeds pre-generated NAT_FRAMEOFDATA and NAT_MODELDEF payloads of
+ * FrameSynthesizer scenes, encoded for bitstream versions 2.0 through 4.1,
+ * through every decoder in the tree: UnpackFrameData, the FrameDecoder
+ * paths (MocapFrame, checked, subscribed sections, FrameSoA), FrameView,
+ * ValidateFrameData, DecoderContext, and PacketClient's UnpackDescription.
+ * Allocations are counted by replacing the global operator new and delete
+ * of this program. Aligned storage (FrameSoA's AlignedArray) comes from
+ * posix_memalign or _aligned_malloc and is not counted; FrameSoA only
+ * allocates when a frame outgrows it, which the warm-up round absorbs.
+ * UnpackDescription prints every description; its output is discarded
+ * while it runs, so its numbers include formatting the text.
+ * Usage:
+ *  decoderBenchmark [options]
+ *  --min-time S            seconds to run every case (default 0.2)
+ *  --filter TEXT           only cases whose name contains TEXT, e.g. "large/4.1"
+ *  --csv                   comma separated output
+ */
+
+#include "DecoderContext.h"
+#include "FrameSoA.h"
+#include "FrameSynthesizer.h"
+#include "FrameView.h"
+#include "NatNetDecoder.h"
+#include "NatNetEncoder.h"
+
+#include <NatNetTypes.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// PacketClient.cpp
+char* UnpackDescription( char* inptr, int nBytes, int major, int minor );
+
+namespace
+{
+
+uint64_t gAllocations = 0;
+
+// Not inlined into the operators below, so that the compiler does not pair
+// a new-expression with malloc/free and warn about the mismatch
+#if defined( __GNUC__ )
+__attribute__(( noinline ))
+#elif defined( _MSC_VER )
+__declspec( noinline )
+#endif
+void* CountedAlloc( std::size_t size ) noexcept
+{
+    gAllocations++;
+    return malloc( size ? size : 1 );
+}
+
+#if defined( __GNUC__ )
+__attribute__(( noinline ))
+#elif defined( _MSC_VER )
+__declspec( noinline )
+#endif
+void CountedFree( void* ptr ) noexcept
+{
+    free( ptr );
+}
+
+} // namespace
+
+// The whole replaceable family, so that every form allocates and frees alike
+void* operator new( std::size_t size )
+{
+    if( void* ptr = CountedAlloc( size ) )
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[]( std::size_t size )
+{
+    if( void* ptr = CountedAlloc( size ) )
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new( std::size_t size, const std::nothrow_t& ) noexcept
+{
+    return CountedAlloc( size );
+}
+
+void* operator new[]( std::size_t size, const std::nothrow_t& ) noexcept
+{
+    return CountedAlloc( size );
+}
+
+void operator delete( void* ptr ) noexcept
+{
+    CountedFree( ptr );
+}
+
+void operator delete[]( void* ptr ) noexcept
+{
+    CountedFree( ptr );
+}
+
+void operator delete( void* ptr, std::size_t ) noexcept
+{
+    CountedFree( ptr );
+}
+
+void operator delete[]( void* ptr, std::size_t ) noexcept
+{
+    CountedFree( ptr );
+}
+
+void operator delete( void* ptr, const std::nothrow_t& ) noexcept
+{
+    CountedFree( ptr );
+}
+
+void operator delete[]( void* ptr, const std::nothrow_t& ) noexcept
+{
+    CountedFree( ptr );
+}
+
+namespace
+{
+
+const int kFramesPerCase = 16;          // distinct frames decoded in turn
+
+struct Options
+{
+    double minTime = 0.2;
+    std::string filter;
+    bool csv = false;
+};
+
+struct Scene
+{
+    const char* name;
+    natnet::SyntheticScene scene;
+};
+
+struct Payloads
+{
+    int major;
+    int minor;
+    std::vector<std::vector<char>> frames;
+    std::vector<char> descriptions;
+};
+
+struct Result
+{
+    double nsPerFrame;
+    double bytesPerSecond;
+    double allocationsPerFrame;
+};
+
+uint64_t gSink = 0;                     // keeps decoded results alive
+
+// Sends standard output to the null device while in scope
+class DiscardStdout
+{
+public:
+    DiscardStdout()
+    {
+        fflush( stdout );
+#ifdef _WIN32
+        console_ = _dup( 1 );
+        int null = _open( "NUL", _O_WRONLY );
+        _dup2( null, 1 );
+        _close( null );
+#else
+        console_ = dup( 1 );
+        int null = open( "/dev/null", O_WRONLY );
+        dup2( null, 1 );
+        close( null );
+#endif
+    }
+    ~DiscardStdout()
+    {
+        fflush( stdout );
+#ifdef _WIN32
+        _dup2( console_, 1 );
+        _close( console_ );
+#else
+        dup2( console_, 1 );
+        close( console_ );
+#endif
+    }
+
+private:
+    int console_;
+};
+
+std::vector<Scene> Scenes()
+{
+    std::vector<Scene> scenes;
+
+    Scene small = { "small", natnet::SyntheticScene() };
+    small.scene.markerSets = 0;
+    small.scene.rigidBodies = 1;
+    small.scene.skeletons = 0;
+    small.scene.labeledMarkers = 4;
+    scenes.push_back( small );
+
+    scenes.push_back( Scene{ "default", natnet::SyntheticScene() } );
+
+    // 2000 markers: 10 marker sets of 100, 1000 labeled, plus four skeletons
+    Scene large = { "large", natnet::SyntheticScene() };
+    large.scene.markerSets = 10;
+    large.scene.markerSetMarkers = 100;
+    large.scene.rigidBodies = 40;
+    large.scene.skeletons = 4;
+    large.scene.labeledMarkers = 1000;
+    large.scene.forcePlates = 2;
+    large.scene.devices = 2;
+    scenes.push_back( large );
+
+    return scenes;
+}
+
+Payloads Encode( const natnet::SyntheticScene& scene, int major, int minor )
+{
+    Payloads payloads;
+    payloads.major = major;
+    payloads.minor = minor;
+    natnet::FrameSynthesizer synthesizer( scene, natnet::FrameSectionsOf( major, minor ) );
+    for( int i = 0; i < kFramesPerCase; i++ )
+    {
+        std::vector<char> payload;
+        natnet::PackFrameData( synthesizer.synthesize( i ), major, minor, payload );
+        payloads.frames.push_back( payload );
+    }
+    natnet::PackDataDescriptions( synthesizer.descriptions(), major, minor, payloads.descriptions );
+    return payloads;
+}
+
+// Run decode( i ) for i = 0, 1, ... until minTime has passed. The first
+// round over the payloads is not measured: output buffers grow there.
+Result Measure( const std::function<void( int )>& decode, size_t bytesPerRound, int rounds, double minTime )
+{
+    typedef std::chrono::steady_clock Clock;
+    for( int i = 0; i < rounds; i++ )
+    {
+        decode( i );
+    }
+
+    uint64_t iterations = 0;
+    uint64_t allocations = gAllocations;
+    Clock::time_point start = Clock::now();
+    double elapsed = 0.0;
+    int batch = rounds;
+    while( elapsed < minTime )
+    {
+        for( int i = 0; i < batch; i++ )
+        {
+            decode( i % rounds );
+        }
+        iterations += batch;
+        elapsed = std::chrono::duration<double>( Clock::now() - start ).count();
+        if( batch < ( 1 << 20 ) )
+        {
+            batch *= 2;
+        }
+    }
+    allocations = gAllocations - allocations;
+
+    Result result;
+    result.nsPerFrame = elapsed * 1e9 / iterations;
+    result.bytesPerSecond = (double) bytesPerRound / rounds * iterations / elapsed;
+    result.allocationsPerFrame = (double) allocations / iterations;
+    return result;
+}
+
+void PrintHeader( const Options& options )
+{
+    if( options.csv )
+    {
+        printf( "case,bytes,ns_per_frame,bytes_per_second,allocations_per_frame\n" );
+    }
+    else
+    {
+        printf( "allocs: operator new calls per frame; aligned FrameSoA storage is not counted\n" );
+        printf( "%-44s %8s %12s %12s %10s\n", "case", "bytes", "ns/frame", "MB/s", "allocs" );
+    }
+}
+
+void PrintResult( const Options& options, const std::string& name, size_t bytes, const Result& result )
+{
+    if( options.csv )
+    {
+        printf( "%s,%zu,%.1f,%.0f,%.3f\n", name.c_str(), bytes, result.nsPerFrame, result.bytesPerSecond,
+            result.allocationsPerFrame );
+    }
+    else
+    {
+        printf( "%-44s %8zu %12.1f %12.1f %10.3f\n", name.c_str(), bytes, result.nsPerFrame,
+            result.bytesPerSecond / 1e6, result.allocationsPerFrame );
+    }
+    fflush( stdout );
+}
+
+bool ParseArgs( int argc, char* argv[], Options& options )
+{
+    for( int i = 1; i < argc; i++ )
+    {
+        std::string arg = argv[i];
+        bool hasValue = ( i + 1 < argc );
+        if( arg == "--min-time" && hasValue )
+        {
+            options.minTime = atof( argv[++i] );
+        }
+        else if( arg == "--filter" && hasValue )
+        {
+            options.filter = argv[++i];
+        }
+        else if( arg == "--csv" )
+        {
+            options.csv = true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main( int argc, char* argv[] )
+{
+    Options options;
+    if( !ParseArgs( argc, argv, options ) )
+    {
+        printf( "Usage: decoderBenchmark [--min-time S] [--filter TEXT] [--csv]\n" );
+        return 1;
+    }
+
+    const int versions[][2] = { { 2, 0 }, { 2, 3 }, { 2, 6 }, { 2, 9 }, { 2, 11 }, { 3, 0 }, { 3, 1 }, { 4, 0 }, { 4, 1 } };
+
+    std::unique_ptr<natnet::MocapFrame> frame( new natnet::MocapFrame );
+    std::unique_ptr<natnet::FrameSoA> soa( new natnet::FrameSoA );
+    natnet::FrameView view;
+
+    PrintHeader( options );
+    for( const Scene& scene : Scenes() )
+    {
+        for( const int* version : versions )
+        {
+            const Payloads payloads = Encode( scene.scene, version[0], version[1] );
+            const int major = payloads.major;
+            const int minor = payloads.minor;
+            const std::vector<std::vector<char>>& frames = payloads.frames;
+            const natnet::FrameDecoder decoder( major, minor );
+            natnet::DecoderContext context;
+            context.setBitstreamVersion( major, minor );
+
+            size_t frameBytes = 0;
+            for( const std::vector<char>& payload : frames )
+            {
+                frameBytes += payload.size();
+            }
+            std::string prefix = std::string( scene.name ) + "/" + std::to_string( major ) + "." +
+                std::to_string( minor ) + "/";
+
+            struct Case
+            {
+                const char* name;
+                std::function<void( int )> decode;
+            };
+            const Case cases[] = {
+                { "UnpackFrameData", [&]( int i )
+                    {
+                        natnet::UnpackFrameData( frames[i].data(), (int) frames[i].size(), major, minor, *frame );
+                        gSink += frame->data.iFrame;
+                    } },
+                { "FrameDecoder", [&]( int i )
+                    {
+                        decoder.unpack( frames[i].data(), (int) frames[i].size(), *frame );
+                        gSink += frame->data.iFrame;
+                    } },
+                { "FrameDecoder checked", [&]( int i )
+                    {
+                        natnet::DecodeStatus status;
+                        decoder.unpackChecked( frames[i].data(), (int) frames[i].size(), *frame, status );
+                        gSink += frame->data.iFrame + status;
+                    } },
+                { "FrameDecoder rigid bodies", [&]( int i )
+                    {
+                        decoder.unpack( frames[i].data(), (int) frames[i].size(), *frame, natnet::FrameSection_RigidBodies );
+                        gSink += frame->data.iFrame;
+                    } },
+                { "FrameDecoder SoA", [&]( int i )
+                    {
+                        decoder.unpack( frames[i].data(), (int) frames[i].size(), *soa );
+                        gSink += soa->iFrame;
+                    } },
+                { "FrameView", [&]( int i )
+                    {
+                        view.parse( frames[i].data(), (int) frames[i].size(), major, minor );
+                        gSink += view.frameNumber();
+                    } },
+                { "ValidateFrameData", [&]( int i )
+                    {
+                        gSink += natnet::ValidateFrameData( frames[i].data(), (int) frames[i].size(), major, minor );
+                    } },
+                { "DecoderContext", [&]( int i )
+                    {
+                        context.unpackFrame( frames[i].data(), (int) frames[i].size(), *frame );
+                        gSink += frame->data.iFrame;
+                    } },
+            };
+
+            for( const Case& c : cases )
+            {
+                std::string name = prefix + c.name;
+                if( name.find( options.filter ) == std::string::npos )
+                {
+                    continue;
+                }
+                Result result = Measure( c.decode, frameBytes, kFramesPerCase, options.minTime );
+                PrintResult( options, name, frameBytes / kFramesPerCase, result );
+            }
+
+            std::string name = prefix + "UnpackDescription";
+            if( name.find( options.filter ) != std::string::npos )
+            {
+                // UnpackDescription takes a mutable pointer but does not write through it
+                std::vector<char> descriptions = payloads.descriptions;
+                Result result;
+                {
+                    DiscardStdout discard;
+                    result = Measure( [&]( int )
+                        {
+                            gSink += (uintptr_t) UnpackDescription( descriptions.data(), (int) descriptions.size(),
+                                major, minor );
+                        }, descriptions.size(), 1, options.minTime );
+                }
+                PrintResult( options, name, descriptions.size(), result );
+            }
+        }
+    }
+
+    return ( gSink == 0x5a5a5a5a5a5a5a5aull ) ? 2 : 0;
+}
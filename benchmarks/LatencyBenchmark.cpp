@@ -0,0 +1,383 @@
+/**
+ * \file   LatencyBenchmark.cpp
+ * \brief  Loopback latency from sending a frame to the receive callback.
+ * Runs a NatNetServer streaming a synthetic scene and the DataReceiver of
+ * packetClient in one process. The sender writes the wall clock time into
+ * the TransmitTimestamp of each frame immediately before sending it; the
+ * receive handler decodes the frame and takes the time again, so the
+ * distribution covers the kernel, the wake-up of the receive thread and
+ * decoding. Where the kernel timestamps datagrams in software, the latency
+ * is also split at the time the datagram arrived. The receive thread can be
+ * pinned, raised to SCHED_FIFO and made to spin, and receive on io_uring,
+ * to compare those settings against the blocking default.
+ * Usage:
+ *  latencyBenchmark [options]
+ *  --version M.m           bitstream version, 3.0 or later (default 4.1)
+ *  --rate HZ               frames per second (default 240)
+ *  --max                   send as fast as possible
+ *  --frames N              frames to measure (default 10000)
+ *  --warmup N              frames sent before measuring (default 100)
+ *  --rigid-bodies N        --labeled-markers N     --skeletons N
+ *  --marker-sets N         --marker-set-markers N  (payload size)
+ *  --cpu N                 pin the receive thread to CPU N
+ *  --fifo PRIORITY         SCHED_FIFO priority of the receive thread
+ *  --spin                  poll the socket in a loop instead of blocking
+ *  --busy-poll US          SO_BUSY_POLL time in microseconds
+ *  --rcvbuf BYTES          fixed SO_RCVBUF size (default: sized from the stream)
+ *  --io-uring              receive with io_uring instead of asio (Linux 6.0)
+ *  --interface IP          interface of the multicast group (default 127.0.0.1)
+ *  --multicast IP          multicast group (default 239.255.42.99)
+ *  --command-port N        (default 1510)
+ *  --data-port N           (default 1511)
+ */
+
+#include "DataReceiver.h"
+#include "DecoderContext.h"
+#include "FrameSynthesizer.h"
+#include "NatNetEncoder.h"
+#include "NatNetServer.h"
+#include "RecordingWriter.h"
+#include "ThreadScheduling.h"
+#include "UringReceiver.h"
+
+#include <NatNetTypes.h>
+
+#include <boost/asio.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cinttypes>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+struct BenchmarkOptions
+{
+    int version[2] = { 4, 1 };
+    double rate = 240.0;                // 0: as fast as possible
+    int frames = 10000;
+    int warmup = 100;
+    natnet::SyntheticScene scene;
+    boost::asio::ip::address interfaceAddress = boost::asio::ip::address::from_string( "127.0.0.1" );
+    boost::asio::ip::address multicastAddress = boost::asio::ip::address::from_string( "239.255.42.99" );
+    unsigned short commandPort = 1510;
+    unsigned short dataPort = 1511;
+    int cpu = -1;
+    int fifoPriority = 0;
+    bool spin = false;
+    int busyPoll = 0;
+    int receiveBuffer = 0;
+    bool uring = false;
+};
+
+// Latencies of the measured frames, in nanoseconds. Written by the receive thread only.
+struct Samples
+{
+    std::vector<int64_t> total;         // send to callback
+    std::vector<int64_t> network;       // send to kernel receive timestamp
+    std::vector<int64_t> application;   // kernel receive timestamp to callback
+    int received = 0;
+};
+
+void PrintUsage()
+{
+    printf( "Usage: latencyBenchmark [--version M.m] [--rate HZ | --max] [--frames N] [--warmup N]\n"
+            "       [--rigid-bodies N] [--labeled-markers N] [--skeletons N]\n"
+            "       [--marker-sets N] [--marker-set-markers N]\n"
+            "       [--cpu N] [--fifo PRIORITY] [--spin] [--busy-poll US] [--rcvbuf BYTES]\n"
+            "       [--io-uring]\n"
+            "       [--interface IP] [--multicast IP] [--command-port N] [--data-port N]\n" );
+}
+
+bool ParseArgs( int argc, char* argv[], BenchmarkOptions& options )
+{
+    natnet::SyntheticScene& scene = options.scene;
+    struct Count
+    {
+        const char* name;
+        int* value;
+    };
+    const Count counts[] = {
+        { "--frames", &options.frames },
+        { "--warmup", &options.warmup },
+        { "--rigid-bodies", &scene.rigidBodies },
+        { "--labeled-markers", &scene.labeledMarkers },
+        { "--skeletons", &scene.skeletons },
+        { "--marker-sets", &scene.markerSets },
+        { "--marker-set-markers", &scene.markerSetMarkers },
+        { "--cpu", &options.cpu },
+        { "--fifo", &options.fifoPriority },
+        { "--busy-poll", &options.busyPoll },
+        { "--rcvbuf", &options.receiveBuffer },
+    };
+
+    for( int i = 1; i < argc; i++ )
+    {
+        std::string arg = argv[i];
+        bool hasValue = ( i + 1 < argc );
+        bool parsed = false;
+        for( const Count& count : counts )
+        {
+            if( ( arg == count.name ) && hasValue )
+            {
+                *count.value = atoi( argv[++i] );
+                parsed = true;
+            }
+        }
+        if( parsed )
+        {
+            continue;
+        }
+
+        if( arg == "--version" && hasValue )
+        {
+            if( sscanf( argv[++i], "%d.%d", &options.version[0], &options.version[1] ) < 1 )
+            {
+                return false;
+            }
+        }
+        else if( arg == "--rate" && hasValue )
+        {
+            options.rate = atof( argv[++i] );
+            if( options.rate <= 0.0 )
+            {
+                return false;
+            }
+        }
+        else if( arg == "--max" )
+        {
+            options.rate = 0.0;
+        }
+        else if( arg == "--spin" )
+        {
+            options.spin = true;
+        }
+        else if( arg == "--io-uring" )
+        {
+            options.uring = true;
+        }
+        else if( arg == "--interface" && hasValue )
+        {
+            options.interfaceAddress = boost::asio::ip::address::from_string( argv[++i] );
+        }
+        else if( arg == "--multicast" && hasValue )
+        {
+            options.multicastAddress = boost::asio::ip::address::from_string( argv[++i] );
+        }
+        else if( arg == "--command-port" && hasValue )
+        {
+            options.commandPort = (unsigned short) atoi( argv[++i] );
+        }
+        else if( arg == "--data-port" && hasValue )
+        {
+            options.dataPort = (unsigned short) atoi( argv[++i] );
+        }
+        else
+        {
+            return false;
+        }
+    }
+    // the send time travels in TransmitTimestamp, which NatNet 3.0 introduced
+    return ( options.version[0] >= 3 ) && ( options.version[0] <= 4 ) && ( options.frames > 0 ) &&
+        ( options.warmup >= 0 );
+}
+
+// Offset of TransmitTimestamp in a frame payload: it is followed by the
+// precision timestamp (NatNet 4.1 and later), params and the end of data tag
+size_t TransmitTimestampOffset( size_t nBytes, int major, int minor )
+{
+    size_t trailer = sizeof( uint64_t ) + sizeof( int16_t ) + sizeof( int32_t );
+    if( natnet::HasSectionSizes( major, minor ) )
+    {
+        trailer += 2 * sizeof( uint32_t );
+    }
+    return nBytes - trailer;
+}
+
+void PrintDistribution( const char* name, std::vector<int64_t>& samples )
+{
+    if( samples.empty() )
+    {
+        printf( "%-22s %10s\n", name, "n/a" );
+        return;
+    }
+    std::sort( samples.begin(), samples.end() );
+    // nearest rank
+    auto percentile = [&samples]( double p )
+    {
+        size_t rank = (size_t) ( p / 100.0 * samples.size() + 0.999999 );
+        return samples[std::min( std::max<size_t>( rank, 1 ), samples.size() ) - 1] / 1000.0;
+    };
+    printf( "%-22s %10.1f %10.1f %10.1f %10.1f\n", name, percentile( 50.0 ), percentile( 99.0 ),
+        percentile( 99.9 ), samples.back() / 1000.0 );
+}
+
+} // namespace
+
+int main( int argc, char* argv[] )
+{
+    BenchmarkOptions options;
+    if( !ParseArgs( argc, argv, options ) )
+    {
+        PrintUsage();
+        return 1;
+    }
+    const int major = options.version[0];
+    const int minor = options.version[1];
+    if( options.rate > 0.0 )
+    {
+        options.scene.frameRate = options.rate;
+    }
+
+    try
+    {
+        natnet::FrameSynthesizer synthesizer( options.scene, natnet::FrameSectionsOf( major, minor ) );
+
+        natnet::ServerOptions serverOptions;
+        serverOptions.localAddress = options.interfaceAddress;
+        serverOptions.multicastAddress = options.multicastAddress;
+        serverOptions.commandPort = options.commandPort;
+        serverOptions.dataPort = options.dataPort;
+        boost::asio::io_service serverService;
+        natnet::NatNetServer server( serverService, serverOptions );
+
+        Samples samples;
+        samples.total.reserve( options.frames );
+        samples.network.reserve( options.frames );
+        samples.application.reserve( options.frames );
+
+        natnet::ReceiverOptions receiverOptions;
+        receiverOptions.multicastAddress = options.multicastAddress;
+        receiverOptions.interfaceAddress = options.interfaceAddress;
+        receiverOptions.port = options.dataPort;
+        receiverOptions.poll = options.spin;
+        receiverOptions.busyPollMicroseconds = options.busyPoll;
+        receiverOptions.receiveBufferBytes = options.receiveBuffer;
+
+        natnet::UringReceiver uring;
+        if( options.uring && !uring.open( 256, natnet::kReceiveBufferSize ) )
+        {
+            fprintf( stderr, "io_uring not available (%s), receiving with asio\n", uring.error().c_str() );
+        }
+        receiverOptions.uring = &uring;
+
+        natnet::DecoderContext context;
+        context.setBitstreamVersion( major, minor );
+        std::unique_ptr<natnet::MocapFrame> frame( new natnet::MocapFrame );
+        const int warmup = options.warmup;
+
+        boost::asio::io_service receiveService;
+        natnet::DataReceiver receiver( receiveService, receiverOptions,
+            [&]( char* data, int /*length*/, const natnet::ReceiveTimestamp& timestamp )
+            {
+                int messageID = 0;
+                int nBytes = 0;
+                int nBytesTotal = 0;
+                const char* payload = natnet::UnpackPacketHeader( data, messageID, nBytes, nBytesTotal );
+                if( ( messageID != NAT_FRAMEOFDATA ) || !context.unpackFrame( payload, nBytes, *frame ) )
+                {
+                    return;
+                }
+                int64_t now = natnet::WallClockNanoseconds();
+                if( ( frame->data.iFrame < warmup ) || ( samples.total.size() == samples.total.capacity() ) )
+                {
+                    return;
+                }
+                int64_t sent = (int64_t) frame->data.TransmitTimestamp;
+                samples.total.push_back( now - sent );
+                if( timestamp.source == natnet::ReceiveTimestamp_Software )
+                {
+                    samples.network.push_back( timestamp.nanoseconds - sent );
+                    samples.application.push_back( now - timestamp.nanoseconds );
+                }
+                samples.received++;
+            } );
+        std::atomic<bool> stopped( false );
+        std::thread receiveThread( [&]()
+            {
+                if( uring.isOpen() )
+                {
+                    while( !stopped.load( std::memory_order_relaxed ) )
+                    {
+                        uring.wait( options.spin ? 0 : 100 );
+                    }
+                }
+                else if( options.spin )
+                {
+                    while( !stopped.load( std::memory_order_relaxed ) )
+                    {
+                        receiver.poll();
+                    }
+                }
+                else
+                {
+                    receiveService.run();
+                }
+            } );
+        if( ( options.cpu >= 0 ) && !natnet::PinThread( receiveThread, options.cpu ) )
+        {
+            fprintf( stderr, "unable to pin the receive thread to CPU %d\n", options.cpu );
+        }
+        if( ( options.fifoPriority > 0 ) && !natnet::SetRealtimePriority( receiveThread, options.fifoPriority ) )
+        {
+            fprintf( stderr, "unable to set SCHED_FIFO priority %d: %s\n", options.fifoPriority, strerror( errno ) );
+        }
+
+        std::vector<char> payload;
+        const int frames = options.warmup + options.frames;
+        std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now();
+        std::chrono::nanoseconds period( options.rate > 0.0 ? (int64_t) ( 1e9 / options.rate ) : 0 );
+        for( int i = 0; i < frames; i++ )
+        {
+            natnet::PackFrameData( synthesizer.synthesize( i ), major, minor, payload );
+            std::this_thread::sleep_until( next );
+            next += period;
+
+            uint64_t now = (uint64_t) natnet::WallClockNanoseconds();
+            memcpy( payload.data() + TransmitTimestampOffset( payload.size(), major, minor ), &now, sizeof( now ) );
+            if( !server.sendFrame( payload.data(), (uint32_t) payload.size() ) )
+            {
+                fprintf( stderr, "unable to send frame %d (%zu bytes)\n", i, payload.size() );
+                break;
+            }
+        }
+
+        // let the last frames arrive
+        std::this_thread::sleep_for( std::chrono::milliseconds( 200 ) );
+        stopped = true;
+        receiveService.stop();
+        receiveThread.join();
+
+        printf( "NatNet %d.%d, %zu bytes per frame, %s, %d frames measured, %d lost\n", major, minor,
+            payload.size(), options.rate > 0.0 ? ( std::to_string( options.rate ) + " Hz" ).c_str() : "max rate",
+            samples.received, options.frames - samples.received );
+        printf( "receive thread: %s %s, CPU %s, %s\n", uring.isOpen() ? "io_uring" : "asio",
+            options.spin ? "spinning" : "blocking",
+            options.cpu >= 0 ? std::to_string( options.cpu ).c_str() : "any",
+            options.fifoPriority > 0 ? ( "SCHED_FIFO " + std::to_string( options.fifoPriority ) ).c_str() : "SCHED_OTHER" );
+        natnet::ReceiverStatistics statistics = receiver.statistics();
+        printf( "%" PRIu64 " datagrams dropped by the kernel, receive buffer %d bytes\n", statistics.kernelDrops,
+            statistics.receiveBufferBytes );
+        printf( "%-22s %10s %10s %10s %10s\n", "latency (us)", "p50", "p99", "p99.9", "max" );
+        PrintDistribution( "send to callback", samples.total );
+        PrintDistribution( "send to kernel", samples.network );
+        PrintDistribution( "kernel to callback", samples.application );
+    }
+    catch( std::exception& e )
+    {
+        fprintf( stderr, "Exception: %s\n", e.what() );
+        return 1;
+    }
+    return 0;
+}
@@ -2,12 +2,12 @@
  * \page   SampleClient.cpp
  * \file   SampleClient.cpp
  * \brief  Sample client using NatNet library
- * This program connects to a NatNet server, receives a data stream, and writes that data stream
- * to an ascii file.  The purpose is to illustrate using the NatNetClient class.
+ * This program connects to a NatNet server, receives a data stream, and records that data stream
+ * to a binary file (see src/Recording.h).  The purpose is to illustrate using the NatNetClient class.
  * Usage [optional]:
  *	SampleClient [ServerIP] [LocalIP] [OutputFilename]
  *	[ServerIP]			IP address of the server (e.g. 192.168.0.107) ( defaults to local machine)
- *	[OutputFilename]	Name of points file (pts) to write out.  defaults to Client-output.pts
+ *	[OutputFilename]	Name of recording to write out.  defaults to Client-output.natrec
  *********************************************************************/
 
  /* 
@@ -45,16 +45,21 @@ limitations under the License. */
 #include <map>
 #include <string>
 #include <vector>
-#include <deque>
 #include <thread>
-#include <mutex>
 #include <memory>
+#include <atomic>
 using namespace std;
 
 #include <NatNetTypes.h>
 #include <NatNetCAPI.h>
 #include <NatNetClient.h>
 
+#include "CompactFrame.h"
+#include "FrameRing.h"
+#include "LatestFrame.h"
+#include "NatNetEncoder.h"
+#include "RecordingWriter.h"
+
 #ifndef _WIN32
 char getch();
 int _kbhit();
@@ -66,9 +71,7 @@ void NATNET_CALLCONV DataHandler(sFrameOfMocapData* data, void* pUserData);    /
 void NATNET_CALLCONV MessageHandler(Verbosity msgType, const char* msg);      // receives NatNet error messages
 
 // Write output to file
-void WriteHeader(FILE* fp, sDataDescriptions* pDataDefs);
-void WriteFrame(FILE* fp, sFrameOfMocapData* data);
-void WriteFooter(FILE* fp);
+void RecordDataDescriptions();
 
 // Helper functions
 void ResetClient();
@@ -79,6 +82,7 @@ void PrintDataDescriptions(sDataDescriptions* pDataDefs);
 int ProcessKeyboardInput();
 int SetGetProperty(char* szSetGetCommand);
 void OutputFrameQueueToConsole();
+void OutputLatestFrameToConsole();
 
 static const ConnectionType kDefaultConnectionType = ConnectionType_Multicast;
 //static const ConnectionType kDefaultConnectionType = ConnectionType_Unicast;
@@ -104,18 +108,37 @@ string strDefaultLocal = "";
 string strDefaultMotive = "";
 
 // Frame Queue
+// Filled by DataHandler (network thread), drained by OutputFrameQueueToConsole (main thread).
+// Slots are reused: each holds a compact copy of the last frame written to it, sized to the
+// frame's actual counts. The slot buffers are reserved at startup and keep their capacity, so
+// DataHandler does not allocate. The console expands frames into gConsoleFrame.
 typedef struct MocapFrameWrapper
 {
-    shared_ptr<sFrameOfMocapData> data;
+    natnet::CompactFrame frame;
     double transitLatencyMillisec;
     double clientLatencyMillisec;
 } MocapFrameWrapper;
-std::timed_mutex gNetworkQueueMutex;
-std::deque<MocapFrameWrapper> gNetworkQueue;
 const int kMaxQueueSize = 500;
+const size_t kFrameReserveBytes = 64 * 1024;
+const natnet::FrameCapacity kFrameCapacity = { 1024, 256, 1024, 256, 1024 };
+natnet::FrameRing<MocapFrameWrapper> gNetworkQueue(kMaxQueueSize, natnet::RingOverflow_OverwriteOldest);
+natnet::MocapFrame gConsoleFrame;
+
+// Latest Frame
+// Newest frame only, for readers that want the current pose rather than every frame
+// (e.g. a control loop). Published by DataHandler, read with one atomic exchange.
+natnet::LatestFrame<natnet::CompactFrame> gLatestFrame;
+
+// Recording
+// Every frame DataHandler receives, whether or not the console keeps up. NatNetClient hands
+// out decoded frames only, so they are re-encoded as NatNet 4.1 payloads before recording.
+const int kRecordingVersion[4] = { 4, 1, 0, 0 };
+natnet::RecordingWriter g_recorder;
+vector<char> g_recordFramePayload;      // DataHandler (network thread) only
+// Set once the recording starts with the server info and version records, so no frame precedes them
+std::atomic<bool> g_recordFrames(false);
 
 // Misc
-FILE* g_outputFile = NULL;
 int g_analogSamplesPerMocapFrame = 0;
 float gSmoothingValue = 0.1f;
 bool gPauseOutput = false;
@@ -146,6 +169,17 @@ int main( int argc, char* argv[] )
     // Install logging callback
     NatNet_SetLogCallback( MessageHandler );
 
+    // Preallocate the frame queue
+    for (int i = 0; i < gNetworkQueue.frameCount(); i++)
+    {
+        gNetworkQueue.frame(i).frame.reserve(kFrameReserveBytes);
+    }
+    natnet::ReserveFrame(gConsoleFrame, kFrameCapacity);
+    for (int i = 0; i < gLatestFrame.frameCount(); i++)
+    {
+        gLatestFrame.frame(i).reserve(kFrameReserveBytes);
+    }
+
     // Create NatNet client
     g_pClient = new NatNetClient();
 
@@ -272,20 +306,24 @@ int main( int argc, char* argv[] )
     }
     else
     {
-        // Create data file for writing received stream into
-        const char* szFile = "Client-output.pts";
+        // Create recording for writing received stream into
+        const char* szFile = "Client-output.natrec";
         if (argc > 3)
         {
             szFile = argv[3];
         }
-        g_outputFile = fopen(szFile, "w");
-        if (!g_outputFile)
+        if (!g_recorder.open(szFile))
         {
-            printf("[SampleClient] Error opening output file %s.  Exiting.\n", szFile);
+            printf("[SampleClient] Error opening output file %s.\n", szFile);
         }
         else
         {
-            WriteHeader(g_outputFile, g_pDataDefs);
+            vector<char> payload;
+            natnet::PackServerInfo(g_serverDescription, payload);
+            g_recorder.write(NAT_SERVERINFO, payload.data(), (uint32_t) payload.size(), natnet::WallClockNanoseconds());
+            g_recorder.writeBitstreamVersion(kRecordingVersion, natnet::WallClockNanoseconds());
+            RecordDataDescriptions();
+            g_recordFrames.store(true, std::memory_order_release);
         }
     }
 
@@ -328,11 +366,18 @@ int main( int argc, char* argv[] )
 		delete g_pClient;
 		g_pClient = NULL;
 	}
-	if (g_outputFile)
+	if (g_recorder.isOpen())
 	{
-		WriteFooter(g_outputFile);
-		fclose(g_outputFile);
-		g_outputFile = NULL;
+		g_recordFrames.store(false, std::memory_order_relaxed);
+		g_recorder.close();
+		if (!g_recorder.ok())
+		{
+			printf("[SampleClient] Error writing output file.\n");
+		}
+		if (g_recorder.recordsDropped() > 0)
+		{
+			printf("[SampleClient] %" PRIu64 " records dropped, the disk did not keep up.\n", g_recorder.recordsDropped());
+		}
 	}
     if (g_pDataDefs)
     {
@@ -446,6 +491,10 @@ int ProcessKeyboardInput()
                     gSmoothingValue += .1f;
                 }
                 break;
+            // Print the rigid bodies of the newest frame
+            case 'l':
+                OutputLatestFrameToConsole();
+                break;
             case 'z':
                 gPauseOutput = !gPauseOutput;
                 if (gPauseOutput)
@@ -593,10 +642,28 @@ bool UpdateDataDescriptions(bool printToConsole)
     }
 
     UpdateDataToDescriptionMaps(g_pDataDefs);
+    RecordDataDescriptions();
 
     return true;
 }
 
+/**
+ * Record the current data descriptions, so frames that follow can be decoded
+ * against them on replay.
+ * 
+ */
+void RecordDataDescriptions()
+{
+    if (!g_recorder.isOpen() || !g_pDataDefs)
+    {
+        return;
+    }
+
+    vector<char> payload;
+    natnet::PackDataDescriptions(*g_pDataDefs, kRecordingVersion[0], kRecordingVersion[1], payload);
+    g_recorder.write(NAT_MODELDEF, payload.data(), (uint32_t) payload.size(), natnet::WallClockNanoseconds());
+}
+
 /**
  * Print data descriptions to std out.
  * 
@@ -864,27 +931,14 @@ void UpdateDataToDescriptionMaps(sDataDescriptions* pDataDefs)
  */
 void OutputFrameQueueToConsole()
 {
-    // Add data from the network queue into our display queue in order to quickly
-    // free up access to the network queue.
-    std::deque<MocapFrameWrapper> displayQueue;
-    if (gNetworkQueueMutex.try_lock_for(std::chrono::milliseconds(5)))
+    // Frames are read in place. The network thread does not touch the frame
+    // returned by pop() until the next pop(), and never waits for us, so we
+    // can take our time displaying it.
+    while (MocapFrameWrapper* pFrame = gNetworkQueue.pop())
     {
-        for (MocapFrameWrapper f : gNetworkQueue)
-        {
-            displayQueue.push_back(f);
-        }
-
-        // Release all frames in network queue
-        gNetworkQueue.clear();
-        gNetworkQueueMutex.unlock();
-    }
-
-
-    // Now we can take our time displaying our data without
-    // worrying about interfering with the network processing queue.
-    for (MocapFrameWrapper f : displayQueue)
-    {
-        sFrameOfMocapData* data = f.data.get();
+        const MocapFrameWrapper& f = *pFrame;
+        f.frame.copyTo(gConsoleFrame);
+        sFrameOfMocapData* data = &gConsoleFrame.data;
 
         printf("\n=====================  New Packet Arrived  =============================\n");
         printf("FrameID : %d\n", data->iFrame);
@@ -961,11 +1015,6 @@ void OutputFrameQueueToConsole()
             break;
         }
 
-        if (g_outputFile)
-        {
-            WriteFrame(g_outputFile, data);
-        }
-
         bool bIsRecording = ((data->params & 0x01) != 0);
         if (bIsRecording)
         {
@@ -1134,13 +1183,41 @@ void OutputFrameQueueToConsole()
         }
     }
 
-    // Release all frames (and frame data) in the display queue
-    for (MocapFrameWrapper f : displayQueue)
+    // Report frames the network thread had to overwrite because we fell behind
+    static uint64_t sReportedDropped = 0;
+    uint64_t dropped = gNetworkQueue.dropped();
+    if (dropped != sReportedDropped)
+    {
+        printf("\n%" PRIu64 " frames dropped (queue full)\n", dropped - sReportedDropped);
+        sReportedDropped = dropped;
+    }
+}
+
+/**
+ * Output the rigid body poses of the most recent frame to console.
+ * Reads the frame in place; frames received since the last call are skipped.
+ */
+void OutputLatestFrameToConsole()
+{
+    const natnet::CompactFrame* pFrame = gLatestFrame.read();
+    if (!pFrame)
     {
-        NatNet_FreeFrame(f.data.get());
+        printf("\nNo frame received yet.\n");
+        return;
     }
-    displayQueue.clear();
 
+    int nRigidBodies = pFrame->count(natnet::CompactSection_RigidBodies);
+    printf("\nLatest FrameID : %d\n", pFrame->header().iFrame);
+    printf("Rigid Bodies [Count=%d]\n", nRigidBodies);
+    const sRigidBodyData* rigidBodies = pFrame->rigidBodies();
+    for (int i = 0; i < nRigidBodies; i++)
+    {
+        const sRigidBodyData& rb = rigidBodies[i];
+        bool bTrackingValid = rb.params & 0x01;
+        printf("%s [ID=%d  Error(mm)=%.5f  Tracked=%d]\n", g_AssetIDtoAssetName[rb.ID].c_str(), rb.ID, rb.MeanError*1000.0f, bTrackingValid);
+        printf("\tx\ty\tz\tqx\tqy\tqz\tqw\n");
+        printf("\t%3.2f\t%3.2f\t%3.2f\t%3.2f\t%3.2f\t%3.2f\t%3.2f\n", rb.x, rb.y, rb.z, rb.qx, rb.qy, rb.qz, rb.qw);
+    }
 }
 
 /**
@@ -1159,38 +1236,31 @@ void NATNET_CALLCONV DataHandler(sFrameOfMocapData* data, void* pUserData)
 
     // Note : This function is called every 1 / mocap rate ( e.g. 100 fps = every 10 msecs )
     // We don't want to do too much here and cause the network processing thread to get behind,
-    // so let's just safely add this frame to our shared  'network' frame queue and return.
+    // so let's just add this frame to our shared 'network' frame queue and return.
+    // The queue never blocks; when it is full the oldest queued frame is overwritten.
     
     // Note : The 'data' ptr passed in is managed by NatNet and cannot be used outside this function.
     // Since we are keeping the data, we need to make a copy of it.
-    shared_ptr<sFrameOfMocapData> pDataCopy = make_shared<sFrameOfMocapData>();
-    NatNet_CopyFrame(data, pDataCopy.get());
+    // The copy overwrites the frame that last used this slot and reuses its buffer.
+    MocapFrameWrapper& f = gNetworkQueue.writeFrame();
+    f.frame.assign(*data);
 
-    MocapFrameWrapper f;
-    f.data = pDataCopy;
-    f.clientLatencyMillisec = pClient->SecondsSinceHostTimestamp(data->CameraMidExposureTimestamp) * 1000.0;
-    f.transitLatencyMillisec = pClient->SecondsSinceHostTimestamp(data->TransmitTimestamp) * 1000.0;
+    natnet::CompactFrame& latest = gLatestFrame.writeFrame();
+    latest.assign(*data);
+    gLatestFrame.publish();
 
-    if (gNetworkQueueMutex.try_lock_for(std::chrono::milliseconds(5)))
+    // Re-encoded only while recording, after the records that describe the stream
+    if (g_recordFrames.load(std::memory_order_acquire))
     {
-        gNetworkQueue.push_back(f);
-
-        // Maintain a cap on the queue size, removing oldest as necessary
-        while ((int)gNetworkQueue.size() > kMaxQueueSize)
-        {
-            f = gNetworkQueue.front();
-            NatNet_FreeFrame(f.data.get());
-            gNetworkQueue.pop_front();
-        }
-        gNetworkQueueMutex.unlock();
-    }
-    else
-    {
-        // Unable to lock the frame queue and we chose not to wait - drop the frame and notify
-        NatNet_FreeFrame(pDataCopy.get());
-        printf("\nFrame dropped (Frame : %d)\n", f.data->iFrame);
+        natnet::PackFrameData(*data, kRecordingVersion[0], kRecordingVersion[1], g_recordFramePayload);
+        g_recorder.write(NAT_FRAMEOFDATA, g_recordFramePayload.data(), (uint32_t) g_recordFramePayload.size(), natnet::WallClockNanoseconds());
     }
 
+    f.clientLatencyMillisec = pClient->SecondsSinceHostTimestamp(data->CameraMidExposureTimestamp) * 1000.0;
+    f.transitLatencyMillisec = pClient->SecondsSinceHostTimestamp(data->TransmitTimestamp) * 1000.0;
+
+    gNetworkQueue.push();
+
     return;
 }
 
@@ -1233,69 +1303,6 @@ void NATNET_CALLCONV MessageHandler( Verbosity msgType, const char* msg )
     printf( ": %s\n", msg );
 }
 
-/**
- * Write header to output file.
- * 
- * \param fp
- * \param pBodyDefs
- */
-void WriteHeader(FILE* fp, sDataDescriptions* pBodyDefs)
-{
-	int i=0;
-
-    // For now, lets just write markerset data
-    if ( pBodyDefs->arrDataDescriptions[0].type != Descriptor_MarkerSet )
-        return;
-
-	sMarkerSetDescription* pMS = pBodyDefs->arrDataDescriptions[0].Data.MarkerSetDescription;
-
-	fprintf(fp, "<MarkerSet>\n\n");
-	fprintf(fp, "<Name>\n%s\n</Name>\n\n", pMS->szName);
-
-	fprintf(fp, "<Markers>\n");
-	for(i=0; i < pMS->nMarkers; i++)
-	{
-		fprintf(fp, "%s\n", pMS->szMarkerNames[i]);
-	}
-	fprintf(fp, "</Markers>\n\n");
-
-	fprintf(fp, "<Data>\n");
-	fprintf(fp, "Frame#\t");
-	for(i=0; i < pMS->nMarkers; i++)
-	{
-		fprintf(fp, "M%dX\tM%dY\tM%dZ\t", i, i, i);
-	}
-	fprintf(fp,"\n");
-
-}
-
-/**
- * Write frame of data to output file.
- * 
- * \param fp
- * \param data
- */
-void WriteFrame(FILE* fp, sFrameOfMocapData* data)
-{
-	fprintf(fp, "%d", data->iFrame);
-	for(int i =0; i < data->MocapData->nMarkers; i++)
-	{
-		fprintf(fp, "\t%.5f\t%.5f\t%.5f", data->MocapData->Markers[i][0], data->MocapData->Markers[i][1], data->MocapData->Markers[i][2]);
-	}
-	fprintf(fp, "\n");
-}
-
-/**
- * Write footer to output file.
- * 
- * \param fp Output file pointer
- */
-void WriteFooter(FILE* fp)
-{
-	fprintf(fp, "</Data>\n\n");
-	fprintf(fp, "</MarkerSet>\n");
-}
-
 /**
  * Reset the client.
  * 
@@ -0,0 +1,364 @@
+/**
+ * \file   CompactFrame.cpp
+ * \brief  Frame of mocap data sized to its actual counts.
+ */
+
+#include "CompactFrame.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace natnet
+{
+
+namespace
+{
+
+const size_t kSectionAlignment = 8;
+
+const size_t kRecordSize[CompactSection_Count] =
+{
+    sizeof( CompactMarkerSet ),
+    sizeof( MarkerData ),
+    sizeof( MarkerData ),
+    sizeof( sRigidBodyData ),
+    sizeof( CompactSkeleton ),
+    sizeof( sRigidBodyData ),
+    sizeof( CompactAsset ),
+    sizeof( sRigidBodyData ),
+    sizeof( sMarker ),
+    sizeof( sMarker ),
+    sizeof( CompactAnalogDevice ),
+    sizeof( CompactAnalogDevice ),
+    sizeof( CompactAnalogChannel ),
+    sizeof( float )
+};
+
+size_t AlignSection( size_t offset )
+{
+    return ( offset + kSectionAlignment - 1 ) / kSectionAlignment * kSectionAlignment;
+}
+
+// memcpy that accepts the null arrays of empty SDK sections
+void CopyRecords( void* dest, const void* src, size_t bytes )
+{
+    if( bytes > 0 )
+    {
+        memcpy( dest, src, bytes );
+    }
+}
+
+/**
+ * \brief Count the analog channels and samples of force plates or devices
+ * \param devices - force plate or device records
+ * \param nDevices - number of records
+ * \param nChannels - incremented by the number of channels
+ * \param nValues - incremented by the number of samples
+*/
+template <typename Device>
+void CountAnalog( const Device* devices, int nDevices, uint32_t& nChannels, uint32_t& nValues )
+{
+    for( int i = 0; i < nDevices; i++ )
+    {
+        int channels = ClampCount( devices[i].nChannels, MAX_ANALOG_CHANNELS );
+        nChannels += channels;
+        for( int j = 0; j < channels; j++ )
+        {
+            nValues += ClampCount( devices[i].ChannelData[j].nFrames, MAX_ANALOG_SUBFRAMES );
+        }
+    }
+}
+
+/**
+ * \brief Store force plates or devices with their channels and samples
+ * \param devices - force plate or device records
+ * \param nDevices - number of records
+ * \param out - compact records
+ * \param channels - channel section
+ * \param values - sample section
+ * \param iChannel - next free channel, updated
+ * \param iValue - next free sample, updated
+*/
+template <typename Device>
+void StoreAnalog( const Device* devices, int nDevices, CompactAnalogDevice* out, CompactAnalogChannel* channels,
+    float* values, int& iChannel, int& iValue )
+{
+    for( int i = 0; i < nDevices; i++ )
+    {
+        out[i].ID = devices[i].ID;
+        out[i].nChannels = ClampCount( devices[i].nChannels, MAX_ANALOG_CHANNELS );
+        out[i].firstChannel = iChannel;
+        out[i].params = devices[i].params;
+        for( int j = 0; j < out[i].nChannels; j++ )
+        {
+            const sAnalogChannelData& channel = devices[i].ChannelData[j];
+            int nFrames = ClampCount( channel.nFrames, MAX_ANALOG_SUBFRAMES );
+            channels[iChannel].nFrames = nFrames;
+            channels[iChannel].firstValue = iValue;
+            memcpy( values + iValue, channel.Values, nFrames * sizeof( float ) );
+            iChannel++;
+            iValue += nFrames;
+        }
+    }
+}
+
+/**
+ * \brief Expand compact force plates or devices into SDK records
+ * \param in - compact records
+ * \param nDevices - number of records
+ * \param channels - channel section
+ * \param values - sample section
+ * \param devices - output records
+*/
+template <typename Device>
+void LoadAnalog( const CompactAnalogDevice* in, int nDevices, const CompactAnalogChannel* channels,
+    const float* values, Device* devices )
+{
+    for( int i = 0; i < nDevices; i++ )
+    {
+        devices[i].ID = in[i].ID;
+        devices[i].nChannels = in[i].nChannels;
+        devices[i].params = in[i].params;
+        for( int j = 0; j < in[i].nChannels; j++ )
+        {
+            const CompactAnalogChannel& channel = channels[in[i].firstChannel + j];
+            devices[i].ChannelData[j].nFrames = channel.nFrames;
+            memcpy( devices[i].ChannelData[j].Values, values + channel.firstValue, channel.nFrames * sizeof( float ) );
+        }
+    }
+}
+
+} // namespace
+
+CompactFrame::CompactFrame()
+    : buffer_( sizeof( CompactFrameHeader ) )
+{
+    CompactFrameHeader& header = mutableHeader();
+    header.size = sizeof( CompactFrameHeader );
+    for( int i = 0; i < CompactSection_Count; i++ )
+    {
+        header.offsets[i] = sizeof( CompactFrameHeader );
+    }
+}
+
+/**
+ * \brief Allocate the buffer up front, so that assigning frames up to that
+ * size does not allocate
+ * \param bytes - buffer size, header included
+*/
+void CompactFrame::reserve( size_t bytes )
+{
+    buffer_.reserve( bytes );
+}
+
+/**
+ * \brief Store a frame, replacing the previous one
+ * \param src - frame to store, e.g. the frame passed to a NatNetClient frame callback
+*/
+void CompactFrame::assign( const sFrameOfMocapData& src )
+{
+    uint32_t counts[CompactSection_Count] = {};
+
+    int nMarkerSets = ClampCount( src.nMarkerSets, MAX_MARKERSETS );
+    counts[CompactSection_MarkerSets] = nMarkerSets;
+    for( int i = 0; i < nMarkerSets; i++ )
+    {
+        counts[CompactSection_MarkerSetMarkers] += std::max( 0, src.MocapData[i].nMarkers );
+    }
+    counts[CompactSection_OtherMarkers] = std::max( 0, src.nOtherMarkers );
+    counts[CompactSection_RigidBodies] = ClampCount( src.nRigidBodies, MAX_RIGIDBODIES );
+
+    int nSkeletons = ClampCount( src.nSkeletons, MAX_SKELETONS );
+    counts[CompactSection_Skeletons] = nSkeletons;
+    for( int i = 0; i < nSkeletons; i++ )
+    {
+        counts[CompactSection_SkeletonRigidBodies] += std::max( 0, src.Skeletons[i].nRigidBodies );
+    }
+
+    int nAssets = ClampCount( src.nAssets, MAX_ASSETS );
+    counts[CompactSection_Assets] = nAssets;
+    for( int i = 0; i < nAssets; i++ )
+    {
+        counts[CompactSection_AssetRigidBodies] += std::max( 0, src.Assets[i].nRigidBodies );
+        counts[CompactSection_AssetMarkers] += std::max( 0, src.Assets[i].nMarkers );
+    }
+    counts[CompactSection_LabeledMarkers] = ClampCount( src.nLabeledMarkers, MAX_LABELED_MARKERS );
+
+    int nForcePlates = ClampCount( src.nForcePlates, MAX_FORCEPLATES );
+    int nDevices = ClampCount( src.nDevices, MAX_DEVICES );
+    counts[CompactSection_ForcePlates] = nForcePlates;
+    counts[CompactSection_Devices] = nDevices;
+    CountAnalog( src.ForcePlates, nForcePlates, counts[CompactSection_AnalogChannels], counts[CompactSection_AnalogValues] );
+    CountAnalog( src.Devices, nDevices, counts[CompactSection_AnalogChannels], counts[CompactSection_AnalogValues] );
+
+    // lay out the sections and size the buffer
+    uint32_t offsets[CompactSection_Count];
+    size_t size = sizeof( CompactFrameHeader );
+    for( int i = 0; i < CompactSection_Count; i++ )
+    {
+        size = AlignSection( size );
+        offsets[i] = (uint32_t) size;
+        size += counts[i] * kRecordSize[i];
+    }
+    buffer_.resize( size );
+
+    CompactFrameHeader& header = mutableHeader();
+    header.size = (uint32_t) size;
+    header.iFrame = src.iFrame;
+    header.Timecode = src.Timecode;
+    header.TimecodeSubframe = src.TimecodeSubframe;
+    header.fTimestamp = src.fTimestamp;
+    header.CameraMidExposureTimestamp = src.CameraMidExposureTimestamp;
+    header.CameraDataReceivedTimestamp = src.CameraDataReceivedTimestamp;
+    header.TransmitTimestamp = src.TransmitTimestamp;
+    header.PrecisionTimestampSecs = src.PrecisionTimestampSecs;
+    header.PrecisionTimestampFractionalSecs = src.PrecisionTimestampFractionalSecs;
+    header.params = src.params;
+    memcpy( header.counts, counts, sizeof( counts ) );
+    memcpy( header.offsets, offsets, sizeof( offsets ) );
+
+    CompactMarkerSet* markerSets = mutableSection<CompactMarkerSet>( CompactSection_MarkerSets );
+    MarkerData* markerSetMarkers = mutableSection<MarkerData>( CompactSection_MarkerSetMarkers );
+    int iMarker = 0;
+    for( int i = 0; i < nMarkerSets; i++ )
+    {
+        const sMarkerSetData& markerSet = src.MocapData[i];
+        memcpy( markerSets[i].szName, markerSet.szName, sizeof( markerSet.szName ) );
+        markerSets[i].nMarkers = std::max( 0, markerSet.nMarkers );
+        markerSets[i].firstMarker = iMarker;
+        CopyRecords( markerSetMarkers + iMarker, markerSet.Markers, markerSets[i].nMarkers * sizeof( MarkerData ) );
+        iMarker += markerSets[i].nMarkers;
+    }
+
+    CopyRecords( mutableSection<MarkerData>( CompactSection_OtherMarkers ), src.OtherMarkers,
+        counts[CompactSection_OtherMarkers] * sizeof( MarkerData ) );
+    memcpy( mutableSection<sRigidBodyData>( CompactSection_RigidBodies ), src.RigidBodies,
+        counts[CompactSection_RigidBodies] * sizeof( sRigidBodyData ) );
+
+    CompactSkeleton* skeletons = mutableSection<CompactSkeleton>( CompactSection_Skeletons );
+    sRigidBodyData* bones = mutableSection<sRigidBodyData>( CompactSection_SkeletonRigidBodies );
+    int iBone = 0;
+    for( int i = 0; i < nSkeletons; i++ )
+    {
+        const sSkeletonData& skeleton = src.Skeletons[i];
+        skeletons[i].skeletonID = skeleton.skeletonID;
+        skeletons[i].nRigidBodies = std::max( 0, skeleton.nRigidBodies );
+        skeletons[i].firstRigidBody = iBone;
+        CopyRecords( bones + iBone, skeleton.RigidBodyData, skeletons[i].nRigidBodies * sizeof( sRigidBodyData ) );
+        iBone += skeletons[i].nRigidBodies;
+    }
+
+    CompactAsset* assets = mutableSection<CompactAsset>( CompactSection_Assets );
+    sRigidBodyData* assetRigidBodies = mutableSection<sRigidBodyData>( CompactSection_AssetRigidBodies );
+    sMarker* assetMarkers = mutableSection<sMarker>( CompactSection_AssetMarkers );
+    int iAssetRigidBody = 0;
+    int iAssetMarker = 0;
+    for( int i = 0; i < nAssets; i++ )
+    {
+        const sAssetData& asset = src.Assets[i];
+        assets[i].assetID = asset.assetID;
+        assets[i].nRigidBodies = std::max( 0, asset.nRigidBodies );
+        assets[i].firstRigidBody = iAssetRigidBody;
+        assets[i].nMarkers = std::max( 0, asset.nMarkers );
+        assets[i].firstMarker = iAssetMarker;
+        CopyRecords( assetRigidBodies + iAssetRigidBody, asset.RigidBodyData, assets[i].nRigidBodies * sizeof( sRigidBodyData ) );
+        CopyRecords( assetMarkers + iAssetMarker, asset.MarkerData, assets[i].nMarkers * sizeof( sMarker ) );
+        iAssetRigidBody += assets[i].nRigidBodies;
+        iAssetMarker += assets[i].nMarkers;
+    }
+
+    memcpy( mutableSection<sMarker>( CompactSection_LabeledMarkers ), src.LabeledMarkers,
+        counts[CompactSection_LabeledMarkers] * sizeof( sMarker ) );
+
+    CompactAnalogChannel* channels = mutableSection<CompactAnalogChannel>( CompactSection_AnalogChannels );
+    float* values = mutableSection<float>( CompactSection_AnalogValues );
+    int iChannel = 0;
+    int iValue = 0;
+    StoreAnalog( src.ForcePlates, nForcePlates, mutableSection<CompactAnalogDevice>( CompactSection_ForcePlates ),
+        channels, values, iChannel, iValue );
+    StoreAnalog( src.Devices, nDevices, mutableSection<CompactAnalogDevice>( CompactSection_Devices ),
+        channels, values, iChannel, iValue );
+}
+
+/**
+ * \brief Expand the frame back into the SDK layout.
+ * The variable length arrays are copied into the storage of frame, which is
+ * reused (see MocapFrame); only the records in use of the fixed size arrays
+ * are written.
+ * \param frame - output frame
+*/
+void CompactFrame::copyTo( MocapFrame& frame ) const
+{
+    const CompactFrameHeader& h = header();
+    sFrameOfMocapData& data = frame.data;
+
+    data.iFrame = h.iFrame;
+    data.Timecode = h.Timecode;
+    data.TimecodeSubframe = h.TimecodeSubframe;
+    data.fTimestamp = h.fTimestamp;
+    data.CameraMidExposureTimestamp = h.CameraMidExposureTimestamp;
+    data.CameraDataReceivedTimestamp = h.CameraDataReceivedTimestamp;
+    data.TransmitTimestamp = h.TransmitTimestamp;
+    data.PrecisionTimestampSecs = h.PrecisionTimestampSecs;
+    data.PrecisionTimestampFractionalSecs = h.PrecisionTimestampFractionalSecs;
+    data.params = h.params;
+
+    // storage first: assigning may reallocate it
+    const float* markers = section<float>( CompactSection_MarkerSetMarkers );
+    frame.markerSetMarkers.assign( markers, markers + 3 * h.counts[CompactSection_MarkerSetMarkers] );
+    const float* otherMarkers = section<float>( CompactSection_OtherMarkers );
+    frame.otherMarkers.assign( otherMarkers, otherMarkers + 3 * h.counts[CompactSection_OtherMarkers] );
+    const sRigidBodyData* bones = section<sRigidBodyData>( CompactSection_SkeletonRigidBodies );
+    frame.skeletonRigidBodies.assign( bones, bones + h.counts[CompactSection_SkeletonRigidBodies] );
+    const sRigidBodyData* assetRigidBodies = section<sRigidBodyData>( CompactSection_AssetRigidBodies );
+    frame.assetRigidBodies.assign( assetRigidBodies, assetRigidBodies + h.counts[CompactSection_AssetRigidBodies] );
+    const sMarker* assetMarkers = section<sMarker>( CompactSection_AssetMarkers );
+    frame.assetMarkers.assign( assetMarkers, assetMarkers + h.counts[CompactSection_AssetMarkers] );
+
+    data.nMarkerSets = count( CompactSection_MarkerSets );
+    const CompactMarkerSet* markerSets = this->markerSets();
+    for( int i = 0; i < data.nMarkerSets; i++ )
+    {
+        memcpy( data.MocapData[i].szName, markerSets[i].szName, sizeof( markerSets[i].szName ) );
+        data.MocapData[i].nMarkers = markerSets[i].nMarkers;
+        data.MocapData[i].Markers = reinterpret_cast<MarkerData*>( frame.markerSetMarkers.data() ) + markerSets[i].firstMarker;
+    }
+
+    data.nOtherMarkers = count( CompactSection_OtherMarkers );
+    data.OtherMarkers = reinterpret_cast<MarkerData*>( frame.otherMarkers.data() );
+
+    data.nRigidBodies = count( CompactSection_RigidBodies );
+    memcpy( data.RigidBodies, rigidBodies(), data.nRigidBodies * sizeof( sRigidBodyData ) );
+
+    data.nSkeletons = count( CompactSection_Skeletons );
+    const CompactSkeleton* skeletons = this->skeletons();
+    for( int i = 0; i < data.nSkeletons; i++ )
+    {
+        data.Skeletons[i].skeletonID = skeletons[i].skeletonID;
+        data.Skeletons[i].nRigidBodies = skeletons[i].nRigidBodies;
+        data.Skeletons[i].RigidBodyData = frame.skeletonRigidBodies.data() + skeletons[i].firstRigidBody;
+    }
+
+    data.nAssets = count( CompactSection_Assets );
+    const CompactAsset* assets = this->assets();
+    for( int i = 0; i < data.nAssets; i++ )
+    {
+        data.Assets[i].assetID = assets[i].assetID;
+        data.Assets[i].nRigidBodies = assets[i].nRigidBodies;
+        data.Assets[i].RigidBodyData = frame.assetRigidBodies.data() + assets[i].firstRigidBody;
+        data.Assets[i].nMarkers = assets[i].nMarkers;
+        data.Assets[i].MarkerData = frame.assetMarkers.data() + assets[i].firstMarker;
+    }
+
+    data.nLabeledMarkers = count( CompactSection_LabeledMarkers );
+    memcpy( data.LabeledMarkers, labeledMarkers(), data.nLabeledMarkers * sizeof( sMarker ) );
+
+    const CompactAnalogChannel* channels = section<CompactAnalogChannel>( CompactSection_AnalogChannels );
+    const float* values = section<float>( CompactSection_AnalogValues );
+    data.nForcePlates = count( CompactSection_ForcePlates );
+    LoadAnalog( section<CompactAnalogDevice>( CompactSection_ForcePlates ), data.nForcePlates, channels, values, data.ForcePlates );
+    data.nDevices = count( CompactSection_Devices );
+    LoadAnalog( section<CompactAnalogDevice>( CompactSection_Devices ), data.nDevices, channels, values, data.Devices );
+}
+
+} // namespace natnet
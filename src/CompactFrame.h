@@ -0,0 +1,143 @@
+/**
+ * \file   CompactFrame.h
+ * \brief  Frame of mocap data sized to its actual counts.
+ * sFrameOfMocapData reserves room for the maximum number of every record
+ * type (over 600 KB). A CompactFrame stores the same frame in a single
+ * contiguous buffer: a header with the frame scalars and the count and
+ * offset of every section, followed by the records in use. A frame with a
+ * few rigid bodies and markers takes a few KB.
+ *
+ * Nested arrays (markerset markers, skeleton bones, asset members, analog
+ * channels and samples) are sections of their own; the owning record holds
+ * the index of its first entry. The buffer keeps its capacity between
+ * frames, so assigning frames into the same CompactFrame stops allocating
+ * once it has seen the largest frame of a session.
+ */
+
+#pragma once
+
+#include "NatNetDecoder.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace natnet
+{
+
+enum CompactSection
+{
+    CompactSection_MarkerSets = 0,      // CompactMarkerSet
+    CompactSection_MarkerSetMarkers,    // MarkerData
+    CompactSection_OtherMarkers,        // MarkerData
+    CompactSection_RigidBodies,         // sRigidBodyData
+    CompactSection_Skeletons,           // CompactSkeleton
+    CompactSection_SkeletonRigidBodies, // sRigidBodyData
+    CompactSection_Assets,              // CompactAsset
+    CompactSection_AssetRigidBodies,    // sRigidBodyData
+    CompactSection_AssetMarkers,        // sMarker
+    CompactSection_LabeledMarkers,      // sMarker
+    CompactSection_ForcePlates,         // CompactAnalogDevice
+    CompactSection_Devices,             // CompactAnalogDevice
+    CompactSection_AnalogChannels,      // CompactAnalogChannel (force plates and devices)
+    CompactSection_AnalogValues,        // float
+    CompactSection_Count
+};
+
+struct CompactMarkerSet
+{
+    char szName[MAX_NAMELENGTH];
+    int32_t nMarkers;
+    int32_t firstMarker;                // into CompactSection_MarkerSetMarkers
+};
+
+struct CompactSkeleton
+{
+    int32_t skeletonID;
+    int32_t nRigidBodies;
+    int32_t firstRigidBody;             // into CompactSection_SkeletonRigidBodies
+};
+
+struct CompactAsset
+{
+    int32_t assetID;
+    int32_t nRigidBodies;
+    int32_t firstRigidBody;             // into CompactSection_AssetRigidBodies
+    int32_t nMarkers;
+    int32_t firstMarker;                // into CompactSection_AssetMarkers
+};
+
+struct CompactAnalogDevice
+{
+    int32_t ID;
+    int32_t nChannels;
+    int32_t firstChannel;               // into CompactSection_AnalogChannels
+    int16_t params;
+};
+
+struct CompactAnalogChannel
+{
+    int32_t nFrames;
+    int32_t firstValue;                 // into CompactSection_AnalogValues
+};
+
+// Start of the buffer of a CompactFrame. Offsets are in bytes from the start
+// of the header and multiples of 8.
+struct CompactFrameHeader
+{
+    uint32_t size;                      // bytes of the whole frame, header included
+    int32_t iFrame;
+    uint32_t Timecode;
+    uint32_t TimecodeSubframe;
+    double fTimestamp;
+    uint64_t CameraMidExposureTimestamp;
+    uint64_t CameraDataReceivedTimestamp;
+    uint64_t TransmitTimestamp;
+    uint32_t PrecisionTimestampSecs;
+    uint32_t PrecisionTimestampFractionalSecs;
+    int16_t params;
+    uint32_t counts[CompactSection_Count];
+    uint32_t offsets[CompactSection_Count];
+};
+
+class CompactFrame
+{
+public:
+    CompactFrame();
+
+    void reserve( size_t bytes );
+    void assign( const sFrameOfMocapData& src );
+    void copyTo( MocapFrame& frame ) const;
+
+    // The frame as one block of memory, header first
+    const char* data() const { return buffer_.data(); }
+    size_t size() const { return header().size; }
+
+    const CompactFrameHeader& header() const { return *reinterpret_cast<const CompactFrameHeader*>( buffer_.data() ); }
+    int count( CompactSection section ) const { return (int) header().counts[section]; }
+
+    template <typename T>
+    const T* section( CompactSection section ) const
+    {
+        return reinterpret_cast<const T*>( buffer_.data() + header().offsets[section] );
+    }
+
+    // Typed access to the top level sections
+    const CompactMarkerSet* markerSets() const { return section<CompactMarkerSet>( CompactSection_MarkerSets ); }
+    const sRigidBodyData* rigidBodies() const { return section<sRigidBodyData>( CompactSection_RigidBodies ); }
+    const CompactSkeleton* skeletons() const { return section<CompactSkeleton>( CompactSection_Skeletons ); }
+    const CompactAsset* assets() const { return section<CompactAsset>( CompactSection_Assets ); }
+    const sMarker* labeledMarkers() const { return section<sMarker>( CompactSection_LabeledMarkers ); }
+
+private:
+    template <typename T>
+    T* mutableSection( CompactSection section )
+    {
+        return reinterpret_cast<T*>( &buffer_[0] + header().offsets[section] );
+    }
+    CompactFrameHeader& mutableHeader() { return *reinterpret_cast<CompactFrameHeader*>( &buffer_[0] ); }
+
+    std::vector<char> buffer_;
+};
+
+} // namespace natnet
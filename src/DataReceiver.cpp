@@ -0,0 +1,429 @@
+/**
+ * \file   DataReceiver.cpp
+ * \brief  Receives the NatNet data stream.
+ */
+
+#include "DataReceiver.h"
+#include "UringReceiver.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#if !defined( _WIN32 )
+#include <netinet/in.h>
+#include <sys/socket.h>
+#endif
+
+namespace natnet
+{
+
+namespace
+{
+
+const int kReceiveBatchSize = 64;       // datagrams per recvmmsg (Linux)
+
+// Automatic SO_RCVBUF sizing
+const double kSizingInterval = 1.0;                 // seconds between adjustments
+const int kMinReceiveBuffer = 1 << 20;
+const int kMaxReceiveBuffer = 64 << 20;
+const int kDatagramOverhead = 1024;                 // kernel bookkeeping per queued datagram, roughly
+
+/**
+ * \brief SO_RCVBUF in the unit it is requested in
+ * Linux doubles the requested size for its bookkeeping and reports the doubled value.
+ * \param size - option as read back from the socket
+ * \return - receive buffer size in requested bytes
+*/
+int ReceiveBufferBytes( const boost::asio::socket_base::receive_buffer_size& size )
+{
+#if defined( __linux__ )
+    return size.value() / 2;
+#else
+    return size.value();
+#endif
+}
+
+} // namespace
+
+ReceiverOptions::ReceiverOptions()
+    : listenAddress( boost::asio::ip::address_v4::any() )
+    , multicastAddress( boost::asio::ip::address::from_string( "239.255.42.99" ) )
+    , interfaceAddress( boost::asio::ip::address_v4::any() )
+    , port( 1511 )
+    , reusePort( false )
+    , poll( false )
+    , busyPollMicroseconds( 0 )
+    , receiveBufferBytes( 0 )
+    , receiveBufferSeconds( 0.25 )
+    , uring( nullptr )
+{
+}
+
+/**
+ * \brief Bind the data port, join the multicast group and start receiving on ioService
+ * \param ioService - runs the handler; keep it running while the receiver is used,
+ * unless options.poll or options.uring is set
+ * \param options - addresses and port
+ * \param handler - called with every well-formed packet
+*/
+DataReceiver::DataReceiver( boost::asio::io_service& ioService, const ReceiverOptions& options,
+    const PacketHandler& handler )
+    : socket_( ioService )
+#if defined( __linux__ )
+    , batch_( kReceiveBatchSize, kReceiveBufferSize )
+#else
+    , data_( kReceiveBufferSize )
+#endif
+    , handler_( handler )
+    , autoReceiveBuffer_( options.receiveBufferBytes <= 0 )
+    , receiveBufferSeconds_( options.receiveBufferSeconds )
+    , receiveBufferLimited_( false )
+    , dropCounter_( 0 )
+    , windowStart_( std::chrono::steady_clock::now() )
+    , windowPackets_( 0 )
+    , windowBytes_( 0 )
+    , windowDrops_( 0 )
+    , packets_( 0 )
+    , bytes_( 0 )
+    , malformed_( 0 )
+    , truncated_( 0 )
+    , kernelDrops_( 0 )
+    , receiveBufferBytes_( 0 )
+{
+    using boost::asio::ip::udp;
+
+    // Create the socket so that multiple may be bound to the same address.
+    udp::endpoint listenEndpoint( options.listenAddress, options.port );
+    socket_.open( listenEndpoint.protocol() );
+    socket_.set_option( udp::socket::reuse_address( true ) );
+#if defined( SO_REUSEPORT )
+    if( options.reusePort )
+    {
+        socket_.set_option( boost::asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>( true ) );
+    }
+#endif
+    socket_.bind( listenEndpoint );
+
+#if defined( IP_MULTICAST_ALL )
+    // Only the groups joined on this socket, not those of other receivers on the port
+    socket_.set_option( boost::asio::detail::socket_option::boolean<IPPROTO_IP, IP_MULTICAST_ALL>( false ) );
+#endif
+
+    if( options.multicastAddress.is_unspecified() )
+    {
+        // unicast only
+    }
+    else if( options.interfaceAddress.is_v4() && !options.interfaceAddress.is_unspecified() )
+    {
+        socket_.set_option( boost::asio::ip::multicast::join_group(
+            options.multicastAddress.to_v4(), options.interfaceAddress.to_v4() ) );
+    }
+    else
+    {
+        socket_.set_option( boost::asio::ip::multicast::join_group( options.multicastAddress ) );
+    }
+
+#if defined( __linux__ )
+    // Kernel (or NIC) arrival time of every datagram
+    if( EnableReceiveTimestamps( socket_.native_handle() ) == ReceiveTimestamp_None )
+    {
+        std::cerr << "receive timestamps not available: " << strerror( errno ) << std::endl;
+    }
+    if( !EnableDropCounter( socket_.native_handle() ) )
+    {
+        std::cerr << "kernel drop counter not available: " << strerror( errno ) << std::endl;
+    }
+#endif
+
+    // Start from the system default, but at least kMinReceiveBuffer
+    boost::asio::socket_base::receive_buffer_size size;
+    socket_.get_option( size );
+    receiveBufferBytes_ = ReceiveBufferBytes( size );
+    if( !autoReceiveBuffer_ )
+    {
+        setReceiveBuffer( options.receiveBufferBytes );
+    }
+    else if( receiveBufferBytes_ < kMinReceiveBuffer )
+    {
+        setReceiveBuffer( kMinReceiveBuffer );
+    }
+
+    if( options.busyPollMicroseconds > 0 )
+    {
+#if defined( SO_BUSY_POLL )
+        int microseconds = options.busyPollMicroseconds;
+        if( setsockopt( socket_.native_handle(), SOL_SOCKET, SO_BUSY_POLL, &microseconds, sizeof( microseconds ) ) != 0 )
+        {
+            std::cerr << "SO_BUSY_POLL not set: " << strerror( errno ) << std::endl;
+        }
+#else
+        std::cerr << "SO_BUSY_POLL not available on this platform" << std::endl;
+#endif
+    }
+
+    if( options.uring && options.uring->isOpen() )
+    {
+        // The thread waiting on the ring runs the handler
+        options.uring->add( socket_.native_handle(), [this]( const UringDatagram& datagram )
+            {
+                handleDatagram( datagram.data, datagram.length, datagram.truncated, datagram.timestamp,
+                    datagram.dropCounter );
+                sizeReceiveBuffer();
+            } );
+    }
+    else if( options.poll )
+    {
+        socket_.non_blocking( true );
+    }
+    else
+    {
+        receive();
+    }
+}
+
+/**
+ * \brief Handle the packets queued on the socket, without waiting for any
+ * \return - number of datagrams received
+*/
+int DataReceiver::poll()
+{
+    return drain();
+}
+
+ReceiverStatistics DataReceiver::statistics() const
+{
+    ReceiverStatistics statistics;
+    statistics.packets = packets_.load( std::memory_order_relaxed );
+    statistics.bytes = bytes_.load( std::memory_order_relaxed );
+    statistics.malformed = malformed_.load( std::memory_order_relaxed );
+    statistics.truncated = truncated_.load( std::memory_order_relaxed );
+    statistics.kernelDrops = kernelDrops_.load( std::memory_order_relaxed );
+    statistics.receiveBufferBytes = receiveBufferBytes_.load( std::memory_order_relaxed );
+    return statistics;
+}
+
+#if defined( __linux__ )
+// Wait until the socket is readable, then drain everything queued on it
+// with recvmmsg, one system call per batch of datagrams.
+void DataReceiver::receive()
+{
+    socket_.async_receive( boost::asio::null_buffers(),
+        [this]( boost::system::error_code ec, std::size_t /*length*/ )
+        {
+            if( ec )
+            {
+                if( ec != boost::asio::error::operation_aborted )
+                {
+                    std::cerr << "async_receive error: " << ec.message() << std::endl;
+                }
+                return;
+            }
+
+            drain();
+            receive();
+        } );
+}
+
+// Drain everything queued on the socket with recvmmsg
+int DataReceiver::drain()
+{
+    int received = 0;
+    int n = 0;
+    while( ( n = batch_.receive( socket_.native_handle() ) ) > 0 )
+    {
+        for( int i = 0; i < n; i++ )
+        {
+            handleDatagram( batch_.data( i ), batch_.length( i ), batch_.truncated( i ), batch_.timestamp( i ),
+                batch_.dropCounter( i ) );
+        }
+        received += n;
+
+        // a partial batch means the socket queue is empty
+        if( n < batch_.capacity() )
+        {
+            break;
+        }
+    }
+    if( n < 0 )
+    {
+        std::cerr << "recvmmsg error: " << strerror( errno ) << std::endl;
+    }
+    if( received > 0 )
+    {
+        sizeReceiveBuffer();
+    }
+    return received;
+}
+#else
+void DataReceiver::receive()
+{
+    socket_.async_receive_from( boost::asio::buffer( data_.data(), data_.size() ), sender_,
+        [this]( boost::system::error_code ec, std::size_t length )
+        {
+            if( ec == boost::asio::error::message_size )
+            {
+                // Windows (WSAEMSGSIZE): the datagram did not fit the buffer
+                handleTruncated( (int) length );
+            }
+            else if( ec )
+            {
+                if( ec != boost::asio::error::operation_aborted )
+                {
+                    std::cerr << "async_receive_from error: " << ec.message() << std::endl;
+                }
+                return;
+            }
+            else
+            {
+                handlePacket( data_.data(), (int) length, ReceiveTimestamp() );
+                sizeReceiveBuffer();
+            }
+            receive();
+        } );
+}
+
+// Non-blocking socket (poll mode): receive until nothing is queued
+int DataReceiver::drain()
+{
+    int received = 0;
+    for( ;; )
+    {
+        boost::system::error_code ec;
+        std::size_t length = socket_.receive_from( boost::asio::buffer( data_.data(), data_.size() ), sender_, 0, ec );
+        if( ec == boost::asio::error::message_size )
+        {
+            handleTruncated( (int) length );
+            received++;
+            continue;
+        }
+        if( ec )
+        {
+            if( ec != boost::asio::error::would_block )
+            {
+                std::cerr << "receive_from error: " << ec.message() << std::endl;
+            }
+            if( received > 0 )
+            {
+                sizeReceiveBuffer();
+            }
+            return received;
+        }
+        handlePacket( data_.data(), (int) length, ReceiveTimestamp() );
+        received++;
+    }
+}
+#endif
+
+// A datagram with the ancillary data of the kernel (Linux)
+void DataReceiver::handleDatagram( char* data, int length, bool truncated, const ReceiveTimestamp& timestamp,
+    uint32_t dropCounter )
+{
+    // the counter only grows, and wraps
+    uint32_t drops = dropCounter - dropCounter_;
+    if( drops != 0 )
+    {
+        dropCounter_ = dropCounter;
+        windowDrops_ += drops;
+        kernelDrops_.fetch_add( drops, std::memory_order_relaxed );
+    }
+    if( truncated )
+    {
+        handleTruncated( length );
+    }
+    else
+    {
+        handlePacket( data, length, timestamp );
+    }
+}
+
+void DataReceiver::handlePacket( char* data, int length, const ReceiveTimestamp& timestamp )
+{
+    windowPackets_++;
+    windowBytes_ += length;
+
+    DecodeStatus status = ValidatePacket( data, length );
+    if( status == DecodeStatus_OK )
+    {
+        packets_.fetch_add( 1, std::memory_order_relaxed );
+        bytes_.fetch_add( length, std::memory_order_relaxed );
+        handler_( data, length, timestamp );
+    }
+    else
+    {
+        malformed_.fetch_add( 1, std::memory_order_relaxed );
+        std::cerr << "dropped malformed packet: " << DecodeStatusString( status ) << std::endl;
+    }
+}
+
+// A datagram larger than the receive buffer; decoding it would read garbage
+void DataReceiver::handleTruncated( int length )
+{
+    truncated_.fetch_add( 1, std::memory_order_relaxed );
+    std::cerr << "dropped truncated datagram: larger than the " << kReceiveBufferSize
+              << " byte receive buffer, " << length << " bytes kept" << std::endl;
+}
+
+// Once per kSizingInterval: grow SO_RCVBUF to hold receiveBufferSeconds_ of
+// the stream as observed, or double it if the kernel dropped datagrams
+void DataReceiver::sizeReceiveBuffer()
+{
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    double elapsed = std::chrono::duration<double>( now - windowStart_ ).count();
+    if( elapsed < kSizingInterval )
+    {
+        return;
+    }
+
+    if( autoReceiveBuffer_ )
+    {
+        int current = receiveBufferBytes_.load( std::memory_order_relaxed );
+        double target = ( windowBytes_ + (double) windowPackets_ * kDatagramOverhead ) / elapsed * receiveBufferSeconds_;
+        if( windowDrops_ > 0 )
+        {
+            target = std::max( target, 2.0 * current );
+        }
+        target = std::min( target, (double) kMaxReceiveBuffer );
+        if( target > current )
+        {
+            setReceiveBuffer( (int) target );
+        }
+    }
+
+    windowStart_ = now;
+    windowPackets_ = 0;
+    windowBytes_ = 0;
+    windowDrops_ = 0;
+}
+
+void DataReceiver::setReceiveBuffer( int bytes )
+{
+    boost::system::error_code ec;
+    socket_.set_option( boost::asio::socket_base::receive_buffer_size( bytes ), ec );
+
+    boost::asio::socket_base::receive_buffer_size size;
+    socket_.get_option( size, ec );
+#if defined( SO_RCVBUFFORCE )
+    // net.core.rmem_max caps SO_RCVBUF; privileged processes may exceed it
+    if( !ec && ( ReceiveBufferBytes( size ) < bytes ) &&
+        ( setsockopt( socket_.native_handle(), SOL_SOCKET, SO_RCVBUFFORCE, &bytes, sizeof( bytes ) ) == 0 ) )
+    {
+        socket_.get_option( size, ec );
+    }
+#endif
+    if( ec )
+    {
+        return;
+    }
+    int granted = ReceiveBufferBytes( size );
+    receiveBufferBytes_ = granted;
+    if( ( granted < bytes ) && !receiveBufferLimited_ )
+    {
+        receiveBufferLimited_ = true;
+        std::cerr << "receive buffer limited to " << granted << " of " << bytes
+                  << " bytes by the system (net.core.rmem_max on Linux)" << std::endl;
+    }
+}
+
+} // namespace natnet
@@ -0,0 +1,141 @@
+/**
+ * \file   DataReceiver.h
+ * \brief  Receives the NatNet data stream.
+ * A DataReceiver binds the data port, joins the multicast group and hands
+ * every well-formed packet (header included) to a handler on the
+ * io_service thread, together with the time it arrived and its length.
+ * Datagrams are received into buffers of the largest NatNet packet
+ * (MAX_PACKETSIZE and the header); any datagram larger still is reported
+ * as truncated (MSG_TRUNC, WSAEMSGSIZE) and dropped rather than decoded. On Linux queued
+ * datagrams are drained with recvmmsg and carry kernel or NIC receive
+ * timestamps (see DatagramBatch.h); elsewhere one datagram is received per
+ * completion. Malformed packets are reported on stderr and dropped.
+ *
+ * To spread streams over cores, run several receivers, each on its own
+ * io_service and thread. Receivers of different multicast groups only see
+ * their own group. With reusePort, receivers share the data port: the
+ * kernel spreads unicast senders over them by address (one server always
+ * lands on the same receiver), while every multicast datagram is delivered
+ * to each of them that joined the group. So let only one of them join it
+ * and leave multicastAddress unspecified on the others: on Linux
+ * (IP_MULTICAST_ALL) those then receive unicast datagrams only. Shard
+ * multicast streams by group instead.
+ *
+ * For the lowest latency, a receiver can skip the io_service: with poll set
+ * it does not wait for the socket to become readable, and its thread calls
+ * poll() in a loop instead, trading a core for the wake-up latency of a
+ * blocked thread. busyPollMicroseconds (SO_BUSY_POLL, Linux, needs
+ * CAP_NET_ADMIN) makes the kernel poll the NIC queue on every receive.
+ *
+ * The socket receive buffer (SO_RCVBUF) absorbs bursts and stalls of the
+ * receive thread; when it is full the kernel drops datagrams without
+ * telling anyone. Unless receiveBufferBytes fixes its size, the receiver
+ * sizes it from the stream: once a second it grows the buffer to hold
+ * receiveBufferSeconds of the observed frame sizes and rate, and doubles it
+ * after the kernel dropped datagrams. On Linux the kernel reports its drop
+ * count with every datagram (SO_RXQ_OVFL); statistics() makes the counts
+ * available to any thread.
+ *
+ * On Linux 6.0 and later, receivers can instead share a UringReceiver:
+ * the thread calling its wait() then receives for all of them, and their
+ * io_services are not used (see UringReceiver.h).
+ */
+
+#pragma once
+
+#include "DatagramBatch.h"
+#include "NatNetDecoder.h"
+
+#include <boost/asio.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace natnet
+{
+
+class UringReceiver;
+
+// The largest NatNet packet, which is also the largest UDP payload over IPv4
+const int kReceiveBufferSize = MAX_PACKETSIZE + 4;
+
+struct ReceiverOptions
+{
+    ReceiverOptions();
+
+    boost::asio::ip::address listenAddress;
+    boost::asio::ip::address multicastAddress;      // unspecified: joins no group, unicast only
+    boost::asio::ip::address interfaceAddress;      // joins the group on it; unspecified: the system chooses
+    unsigned short port;
+    bool reusePort;                                 // SO_REUSEPORT, where available
+    bool poll;                                      // received by poll(), not on the io_service
+    int busyPollMicroseconds;                       // SO_BUSY_POLL, 0 for none
+    int receiveBufferBytes;                         // SO_RCVBUF, 0: sized from the stream
+    double receiveBufferSeconds;                    // automatic SO_RCVBUF: stream time it holds
+    UringReceiver* uring;                           // receives instead of the io_service or poll(), if open
+};
+
+struct ReceiverStatistics
+{
+    uint64_t packets;                               // handed to the handler
+    uint64_t bytes;
+    uint64_t malformed;                             // rejected by ValidatePacket
+    uint64_t truncated;                             // larger than the receive buffer (MSG_TRUNC)
+    uint64_t kernelDrops;                           // dropped by the kernel, socket buffer full (Linux)
+    int receiveBufferBytes;                         // SO_RCVBUF as requested (Linux reports twice this)
+};
+
+class DataReceiver
+{
+public:
+    // Called for every packet; data is valid until the handler returns
+    typedef std::function<void( char* data, int length, const ReceiveTimestamp& timestamp )> PacketHandler;
+
+    DataReceiver( boost::asio::io_service& ioService, const ReceiverOptions& options, const PacketHandler& handler );
+    DataReceiver( const DataReceiver& ) = delete;
+    DataReceiver& operator=( const DataReceiver& ) = delete;
+
+    int poll();
+
+    ReceiverStatistics statistics() const;
+
+private:
+    void receive();
+    int drain();
+    void handleDatagram( char* data, int length, bool truncated, const ReceiveTimestamp& timestamp, uint32_t dropCounter );
+    void handlePacket( char* data, int length, const ReceiveTimestamp& timestamp );
+    void handleTruncated( int length );
+    void sizeReceiveBuffer();
+    void setReceiveBuffer( int bytes );
+
+    boost::asio::ip::udp::socket socket_;
+    boost::asio::ip::udp::endpoint sender_;
+#if defined( __linux__ )
+    DatagramBatch batch_;
+#else
+    std::vector<char> data_;
+#endif
+    PacketHandler handler_;
+
+    // receive thread only
+    bool autoReceiveBuffer_;
+    double receiveBufferSeconds_;
+    bool receiveBufferLimited_;                     // reported that the system limit was reached
+    uint32_t dropCounter_;                          // last SO_RXQ_OVFL value
+    std::chrono::steady_clock::time_point windowStart_;
+    uint64_t windowPackets_;
+    uint64_t windowBytes_;
+    uint64_t windowDrops_;
+
+    std::atomic<uint64_t> packets_;
+    std::atomic<uint64_t> bytes_;
+    std::atomic<uint64_t> malformed_;
+    std::atomic<uint64_t> truncated_;
+    std::atomic<uint64_t> kernelDrops_;
+    std::atomic<int> receiveBufferBytes_;
+};
+
+} // namespace natnet
@@ -0,0 +1,176 @@
+/**
+ * \file   DatagramBatch.cpp
+ * \brief  Batched datagram receive with recvmmsg (Linux).
+ */
+
+#include "DatagramBatch.h"
+
+#if defined( __linux__ )
+
+#include <linux/net_tstamp.h>
+#include <time.h>
+
+#include <cerrno>
+#include <cstring>
+
+namespace natnet
+{
+
+namespace
+{
+
+int64_t ToNanoseconds( const timespec& ts )
+{
+    return (int64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+} // namespace
+
+/**
+ * \brief Extract the receive timestamp and drop counter from the ancillary data of a message
+ * \param msg - received message
+ * \param dropCounter - SO_RXQ_OVFL counter, 0 if the message carries none
+ * \return - hardware timestamp if present, software timestamp otherwise
+*/
+ReceiveTimestamp ParseReceiveControl( msghdr& msg, uint32_t& dropCounter )
+{
+    ReceiveTimestamp timestamp = { 0, ReceiveTimestamp_None };
+    dropCounter = 0;
+    for( cmsghdr* cmsg = CMSG_FIRSTHDR( &msg ); cmsg; cmsg = CMSG_NXTHDR( &msg, cmsg ) )
+    {
+        if( cmsg->cmsg_level != SOL_SOCKET )
+        {
+            continue;
+        }
+        if( cmsg->cmsg_type == SCM_TIMESTAMPING )
+        {
+            // [0] software, [1] unused, [2] raw hardware
+            timespec ts[3];
+            memcpy( ts, CMSG_DATA( cmsg ), sizeof( ts ) );
+            if( ts[2].tv_sec || ts[2].tv_nsec )
+            {
+                timestamp.nanoseconds = ToNanoseconds( ts[2] );
+                timestamp.source = ReceiveTimestamp_Hardware;
+            }
+            else if( ts[0].tv_sec || ts[0].tv_nsec )
+            {
+                timestamp.nanoseconds = ToNanoseconds( ts[0] );
+                timestamp.source = ReceiveTimestamp_Software;
+            }
+        }
+        else if( cmsg->cmsg_type == SCM_TIMESTAMPNS )
+        {
+            timespec ts;
+            memcpy( &ts, CMSG_DATA( cmsg ), sizeof( ts ) );
+            timestamp.nanoseconds = ToNanoseconds( ts );
+            timestamp.source = ReceiveTimestamp_Software;
+        }
+        else if( cmsg->cmsg_type == SO_RXQ_OVFL )
+        {
+            memcpy( &dropCounter, CMSG_DATA( cmsg ), sizeof( dropCounter ) );
+        }
+    }
+    return timestamp;
+}
+
+/**
+ * \brief Ask the kernel to timestamp the datagrams received on a socket.
+ * Hardware timestamps are requested with SO_TIMESTAMPING, together with
+ * software ones for datagrams the NIC did not stamp (the NIC has to have
+ * receive timestamping enabled, e.g. by ptp4l or hwstamp_ctl). Kernels
+ * without SO_TIMESTAMPING get SO_TIMESTAMPNS.
+ * \param fd - socket
+ * \return - best source requested, ReceiveTimestamp_None if both failed
+*/
+ReceiveTimestampSource EnableReceiveTimestamps( int fd )
+{
+    int flags = SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE
+        | SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+    if( setsockopt( fd, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof( flags ) ) == 0 )
+    {
+        return ReceiveTimestamp_Hardware;
+    }
+
+    int enable = 1;
+    if( setsockopt( fd, SOL_SOCKET, SO_TIMESTAMPNS, &enable, sizeof( enable ) ) == 0 )
+    {
+        return ReceiveTimestamp_Software;
+    }
+    return ReceiveTimestamp_None;
+}
+
+/**
+ * \brief Ask the kernel to attach its count of datagrams dropped on a socket
+ * (receive buffer full) to every datagram received, see dropCounter()
+ * \param fd - socket
+ * \return - false if not supported (SO_RXQ_OVFL, Linux 2.6.33)
+*/
+bool EnableDropCounter( int fd )
+{
+    int enable = 1;
+    return setsockopt( fd, SOL_SOCKET, SO_RXQ_OVFL, &enable, sizeof( enable ) ) == 0;
+}
+
+/**
+ * \brief Allocate the receive buffers of a batch
+ * \param capacity - maximum number of datagrams per receive()
+ * \param bufferSize - size of each receive buffer
+*/
+DatagramBatch::DatagramBatch( int capacity, int bufferSize )
+    : capacity_( capacity )
+    , bufferSize_( bufferSize )
+    , size_( 0 )
+    , buffers_( new char[(size_t) capacity * bufferSize] )
+    , iovecs_( capacity )
+    , messages_( capacity )
+    , controls_( capacity * kReceiveControlSize )
+    , timestamps_( capacity )
+    , dropCounters_( capacity )
+{
+    for( int i = 0; i < capacity_; i++ )
+    {
+        iovecs_[i].iov_base = data( i );
+        iovecs_[i].iov_len = bufferSize_;
+        memset( &messages_[i], 0, sizeof( mmsghdr ) );
+        messages_[i].msg_hdr.msg_iov = &iovecs_[i];
+        messages_[i].msg_hdr.msg_iovlen = 1;
+        messages_[i].msg_hdr.msg_control = &controls_[i * kReceiveControlSize];
+    }
+}
+
+/**
+ * \brief Receive the datagrams queued on a socket without blocking
+ * \param fd - socket
+ * \return - number of datagrams received (0 if none was queued), -1 on error (see errno)
+*/
+int DatagramBatch::receive( int fd )
+{
+    size_ = 0;
+
+    // msg_controllen is updated by the kernel, restore the full buffer size
+    for( int i = 0; i < capacity_; i++ )
+    {
+        messages_[i].msg_hdr.msg_controllen = kReceiveControlSize;
+    }
+
+    int n = 0;
+    do
+    {
+        n = recvmmsg( fd, messages_.data(), capacity_, MSG_DONTWAIT, nullptr );
+    } while( ( n < 0 ) && ( errno == EINTR ) );
+
+    if( n < 0 )
+    {
+        return ( ( errno == EAGAIN ) || ( errno == EWOULDBLOCK ) ) ? 0 : -1;
+    }
+    for( int i = 0; i < n; i++ )
+    {
+        timestamps_[i] = ParseReceiveControl( messages_[i].msg_hdr, dropCounters_[i] );
+    }
+    size_ = n;
+    return n;
+}
+
+} // namespace natnet
+
+#endif // __linux__
@@ -0,0 +1,78 @@
+/**
+ * \file   DatagramBatch.h
+ * \brief  Batched datagram receive with recvmmsg (Linux).
+ * A DatagramBatch owns a fixed pool of receive buffers that is allocated
+ * once; pages of a buffer are only committed once a datagram that large
+ * has been received into it. receive() drains up to capacity() queued datagrams from a socket
+ * with a single recvmmsg call, so a burst of frames costs one system call
+ * instead of one per datagram. The buffers are reused by the next
+ * receive(); consume the batch before calling it again.
+ * With EnableReceiveTimestamps on the socket, every datagram also carries
+ * the time the NIC or the kernel received it, and with EnableDropCounter
+ * the number of datagrams the kernel has dropped on the socket so far.
+ */
+
+#pragma once
+
+#if defined( __linux__ )
+
+#include "NatNetDecoder.h"
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace natnet
+{
+
+// Room for the ancillary data of one datagram: SCM_TIMESTAMPING (3
+// timespecs), SCM_TIMESTAMPNS and SO_RXQ_OVFL
+const size_t kReceiveControlSize = 160;
+
+ReceiveTimestampSource EnableReceiveTimestamps( int fd );
+bool EnableDropCounter( int fd );
+ReceiveTimestamp ParseReceiveControl( msghdr& msg, uint32_t& dropCounter );
+
+class DatagramBatch
+{
+public:
+    DatagramBatch( int capacity, int bufferSize );
+    DatagramBatch( const DatagramBatch& ) = delete;
+    DatagramBatch& operator=( const DatagramBatch& ) = delete;
+
+    int receive( int fd );
+
+    int capacity() const { return capacity_; }
+    int bufferSize() const { return bufferSize_; }
+
+    // Datagrams of the last receive(), in arrival order
+    int size() const { return size_; }
+    const char* data( int i ) const { return &buffers_[(size_t) i * bufferSize_]; }
+    char* data( int i ) { return &buffers_[(size_t) i * bufferSize_]; }
+    int length( int i ) const { return (int) messages_[i].msg_len; }
+    // The datagram was larger than bufferSize(); length() bytes of it were kept
+    bool truncated( int i ) const { return ( messages_[i].msg_hdr.msg_flags & MSG_TRUNC ) != 0; }
+    const ReceiveTimestamp& timestamp( int i ) const { return timestamps_[i]; }
+    // Datagrams dropped on the socket before this one was received, a
+    // wrapping counter; 0 until the first drop or without EnableDropCounter
+    uint32_t dropCounter( int i ) const { return dropCounters_[i]; }
+
+private:
+    int capacity_;
+    int bufferSize_;
+    int size_;
+    std::unique_ptr<char[]> buffers_;   // capacity_ buffers of bufferSize_ bytes, not zeroed
+    std::vector<iovec> iovecs_;
+    std::vector<mmsghdr> messages_;
+    std::vector<char> controls_;        // ancillary data (timestamps) of each message
+    std::vector<ReceiveTimestamp> timestamps_;
+    std::vector<uint32_t> dropCounters_;
+};
+
+} // namespace natnet
+
+#endif // __linux__
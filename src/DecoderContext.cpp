@@ -0,0 +1,101 @@
+/**
+ * \file   DecoderContext.cpp
+ * \brief  Per-connection decoder state.
+ */
+
+#include "DecoderContext.h"
+
+#include <cstring>
+
+namespace natnet
+{
+
+DecoderContext::DecoderContext()
+    : natNetVersion_()
+    , serverNatNetVersion_()
+    , serverVersion_()
+    , decoder_()
+    , bitstreamVersionChanged_( false )
+    , bitstreamChangePending_( false )
+{
+}
+
+/**
+ * \brief Record the versions announced by NAT_SERVERINFO.
+ * Unless a bitstream version has already been set, the server streams its
+ * native version, which then becomes the decoded version.
+ * \param sender - NAT_SERVERINFO payload
+*/
+void DecoderContext::setServerInfo( const sSender& sender )
+{
+    for( int i = 0; i < 4; i++ )
+    {
+        serverNatNetVersion_[i] = (int) sender.NatNetVersion[i];
+        serverVersion_[i] = (int) sender.Version[i];
+    }
+    if( ( natNetVersion_[0] == 0 ) && ( natNetVersion_[1] == 0 ) )
+    {
+        setBitstreamVersion( serverNatNetVersion_ );
+    }
+}
+
+/**
+ * \brief Set the bitstream version being decoded and select its frame decoder
+ * \param version - major, minor, build, revision
+*/
+void DecoderContext::setBitstreamVersion( const int version[4] )
+{
+    setBitstreamVersion( version[0], version[1], version[2], version[3] );
+}
+
+void DecoderContext::setBitstreamVersion( int major, int minor, int build /*= 0*/, int revision /*= 0*/ )
+{
+    natNetVersion_[0] = major;
+    natNetVersion_[1] = minor;
+    natNetVersion_[2] = build;
+    natNetVersion_[3] = revision;
+    decoder_ = FrameDecoder( major, minor );
+}
+
+/**
+ * \brief Track the bitstream changed flag of a NAT_FRAMEOFDATA payload
+ * \param payload - frame payload (after the packet header)
+ * \param nBytes - payload size
+ * \return - false if the frame has to be skipped because a requested
+ *           bitstream change has not reached the stream yet
+*/
+bool DecoderContext::acceptFrame( const char* payload, int nBytes )
+{
+    // frame params are the last 2 bytes before the 4 byte end of data tag
+    uint16_t params = 0;
+    if( nBytes >= 6 )
+    {
+        memcpy( &params, payload + nBytes - 6, 2 );
+    }
+    bitstreamVersionChanged_ = ( params & 0x08 ) != 0;
+
+    if( bitstreamChangePending_ && bitstreamVersionChanged_ )
+    {
+        bitstreamChangePending_ = false;
+    }
+    return !bitstreamChangePending_;
+}
+
+/**
+ * \brief Decode a NAT_FRAMEOFDATA payload with the decoder of this connection
+ * \param payload - frame payload (after the packet header)
+ * \param nBytes - payload size
+ * \param frame - output frame
+ * \param sections - FrameSection mask of the sections to decode
+ * \return - pointer after the frame, nullptr if the frame was skipped (see acceptFrame)
+*/
+const char* DecoderContext::unpackFrame( const char* payload, int nBytes, MocapFrame& frame, uint32_t sections /*= FrameSection_All*/ )
+{
+    if( !acceptFrame( payload, nBytes ) )
+    {
+        return nullptr;
+    }
+    return decoder_.unpack( payload, nBytes, frame, sections );
+}
+
+} // namespace natnet
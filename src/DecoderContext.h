@@ -0,0 +1,56 @@
+/**
+ * \file   DecoderContext.h
+ * \brief  Per-connection decoder state.
+ * Holds what the SDK samples kept in process globals: the NatNet versions
+ * negotiated with one server, the frame decoder selected for them, and the
+ * bitstream change handshake. Keep one context per server connection; it is
+ * plain data, so a copy hands the negotiated state to worker threads, which
+ * can then decode concurrently without locks.
+ */
+
+#pragma once
+
+#include "NatNetDecoder.h"
+
+namespace natnet
+{
+
+class DecoderContext
+{
+public:
+    DecoderContext();
+
+    // NAT_SERVERINFO
+    void setServerInfo( const sSender& sender );
+
+    // Bitstream version in use; selects the frame decoder
+    void setBitstreamVersion( const int version[4] );
+    void setBitstreamVersion( int major, int minor, int build = 0, int revision = 0 );
+
+    // Bitstream change handshake. Once a change has been requested, frames are
+    // skipped until the server flags the first frame in the new version.
+    void beginBitstreamChange() { bitstreamChangePending_ = true; }
+    void cancelBitstreamChange() { bitstreamChangePending_ = false; }
+    bool acceptFrame( const char* payload, int nBytes );
+
+    const char* unpackFrame( const char* payload, int nBytes, MocapFrame& frame, uint32_t sections = FrameSection_All );
+
+    const int* natNetVersion() const { return natNetVersion_; }
+    const int* serverNatNetVersion() const { return serverNatNetVersion_; }
+    const int* serverVersion() const { return serverVersion_; }
+    int major() const { return natNetVersion_[0]; }
+    int minor() const { return natNetVersion_[1]; }
+    const FrameDecoder& decoder() const { return decoder_; }
+    bool bitstreamVersionChanged() const { return bitstreamVersionChanged_; }
+    bool bitstreamChangePending() const { return bitstreamChangePending_; }
+
+private:
+    int natNetVersion_[4];              // bitstream version being decoded
+    int serverNatNetVersion_[4];        // server's native NatNet version
+    int serverVersion_[4];              // server application (Motive) version
+    FrameDecoder decoder_;
+    bool bitstreamVersionChanged_;      // last frame carried the bitstream changed flag
+    bool bitstreamChangePending_;
+};
+
+} // namespace natnet
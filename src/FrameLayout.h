@@ -0,0 +1,88 @@
+/**
+ * \file   FrameLayout.h
+ * \brief  Compile time record layout of NAT_FRAMEOFDATA per bitstream version.
+ * The frame decoders are templates on FrameLayout, so the version checks that
+ * used to run for every rigid body and marker are resolved by the compiler
+ * and fixed size records can be unrolled. DispatchLayout maps a runtime
+ * version onto the instantiation with the same layout; decoders select it
+ * once per connection (see FrameDecoder).
+ */
+
+#pragma once
+
+namespace natnet
+{
+
+/**
+ * \brief Presence of the version dependent fields of a frame.
+ * Major version 0 is treated as "latest", as in the SDK samples.
+ */
+template <int Major, int Minor>
+struct FrameLayout
+{
+    static constexpr int major = Major;
+    static constexpr int minor = Minor;
+
+    // every section is preceded by its size in bytes (NatNet 4.1 and later)
+    static constexpr bool sectionSizes = ( ( Major == 4 ) && ( Minor > 0 ) ) || ( Major > 4 );
+
+    // sections
+    static constexpr bool skeletons = ( ( Major == 2 ) && ( Minor > 0 ) ) || ( Major > 2 );
+    static constexpr bool assets = sectionSizes;
+    static constexpr bool labeledMarkers = ( ( Major == 2 ) && ( Minor >= 3 ) ) || ( Major > 2 );
+    static constexpr bool forcePlates = ( ( Major == 2 ) && ( Minor >= 9 ) ) || ( Major > 2 );
+    static constexpr bool devices = ( ( Major == 2 ) && ( Minor >= 11 ) ) || ( Major > 2 );
+
+    // rigid bodies
+    static constexpr bool rigidBodyMarkers = ( Major < 3 );
+    static constexpr int rigidBodyMarkerBytes = rigidBodyMarkers ? ( ( Major >= 2 ) ? 20 : 12 ) : 0;
+    static constexpr bool rigidBodyError = ( Major >= 2 ) || ( Major == 0 );
+    static constexpr bool boneError = ( Major >= 2 );
+    static constexpr bool params = ( ( Major == 2 ) && ( Minor >= 6 ) ) || ( Major > 2 ) || ( Major == 0 );
+
+    // labeled markers
+    static constexpr bool markerResidual = ( Major >= 3 ) || ( Major == 0 );
+    static constexpr int labeledMarkerBytes = 20 + ( params ? 2 : 0 ) + ( markerResidual ? 4 : 0 );
+
+    // suffix
+    static constexpr bool softwareLatency = ( Major < 3 );
+    static constexpr bool doubleTimestamp = ( ( Major == 2 ) && ( Minor >= 7 ) ) || ( Major > 2 );
+    static constexpr bool highResTimestamps = ( Major >= 3 ) || ( Major == 0 );
+    static constexpr bool precisionTimestamps = sectionSizes || ( Major == 0 );
+};
+
+/**
+ * \brief Call Select<FrameLayout<...>>::get() for the layout of a runtime version.
+ * Versions whose frames are laid out identically share one instantiation:
+ * 2.x by the minor versions that changed the layout, 3.x (3.0, 3.1) and 4.1+.
+ * \param major - NatNet major version
+ * \param minor - NatNet minor version
+ * \return - the value returned by Select<Layout>::get()
+*/
+template <template <typename> class Select>
+auto DispatchLayout( int major, int minor ) -> decltype( Select<FrameLayout<4, 1>>::get() )
+{
+    switch( major )
+    {
+    case 0:
+        return Select<FrameLayout<0, 0>>::get();
+    case 2:
+        if( minor >= 11 ) return Select<FrameLayout<2, 11>>::get();
+        if( minor >= 9 )  return Select<FrameLayout<2, 9>>::get();
+        if( minor >= 7 )  return Select<FrameLayout<2, 7>>::get();
+        if( minor >= 6 )  return Select<FrameLayout<2, 6>>::get();
+        if( minor >= 3 )  return Select<FrameLayout<2, 3>>::get();
+        if( minor >= 1 )  return Select<FrameLayout<2, 1>>::get();
+        return Select<FrameLayout<2, 0>>::get();
+    case 3:
+        return Select<FrameLayout<3, 0>>::get();
+    case 4:
+        if( minor == 0 ) return Select<FrameLayout<4, 0>>::get();
+        return Select<FrameLayout<4, 1>>::get();
+    default:
+        if( major > 4 ) return Select<FrameLayout<4, 1>>::get();
+        return Select<FrameLayout<1, 0>>::get();
+    }
+}
+
+} // namespace natnet
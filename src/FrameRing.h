@@ -0,0 +1,222 @@
+/**
+ * \file   FrameRing.h
+ * \brief  Bounded single-producer/single-consumer queue of preallocated frames.
+ * The producer (network thread) fills writeFrame() in place and publishes it
+ * with push(); the consumer reads the frames returned by pop() in place. No
+ * frame is copied or allocated after construction and neither side ever
+ * waits for the other: push() is wait-free, pop() only retries when the
+ * producer evicted the frame it was about to take (RingOverflow_OverwriteOldest).
+ *
+ * Frames are referenced by slot index. Besides the queued frames, one slot
+ * belongs to the producer (being written) and one to the consumer (being
+ * read), so a ring of capacity n holds n + 2 frames.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace natnet
+{
+
+// What push() does when the ring is full
+enum RingOverflowPolicy
+{
+    RingOverflow_DropNewest = 0,        // the new frame is dropped, the queued frames are kept
+    RingOverflow_OverwriteOldest        // the oldest queued frame is dropped to make room
+};
+
+namespace detail
+{
+
+/**
+ * \brief Bounded FIFO of slot indices.
+ * One thread pushes. Pops advance the read position with a compare-exchange,
+ * so the pushing thread may pop as well (to evict the oldest entry).
+ */
+class SlotQueue
+{
+public:
+    explicit SlotQueue( int capacity )
+        : capacity_( capacity ), slots_( capacity ), head_( 0 ), pad_(), tail_( 0 )
+    {
+    }
+
+    int size() const
+    {
+        uint64_t tail = tail_.load( std::memory_order_acquire );
+        return (int) ( head_.load( std::memory_order_acquire ) - tail );
+    }
+
+    // pushing thread only
+    bool push( int slot )
+    {
+        uint64_t head = head_.load( std::memory_order_relaxed );
+        if( head - tail_.load( std::memory_order_acquire ) >= (uint64_t) capacity_ )
+        {
+            return false;
+        }
+        slots_[head % capacity_].store( slot, std::memory_order_relaxed );
+        head_.store( head + 1, std::memory_order_release );
+        return true;
+    }
+
+    // pop the oldest entry, retrying if another thread popped it first
+    bool pop( int& slot )
+    {
+        uint64_t tail = tail_.load( std::memory_order_acquire );
+        while( tail != head_.load( std::memory_order_acquire ) )
+        {
+            slot = slots_[tail % capacity_].load( std::memory_order_relaxed );
+            if( tail_.compare_exchange_weak( tail, tail + 1, std::memory_order_acq_rel, std::memory_order_acquire ) )
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // pop the oldest entry with a single attempt; false if empty or another thread popped first
+    bool tryPop( int& slot )
+    {
+        uint64_t tail = tail_.load( std::memory_order_acquire );
+        if( tail == head_.load( std::memory_order_acquire ) )
+        {
+            return false;
+        }
+        slot = slots_[tail % capacity_].load( std::memory_order_relaxed );
+        return tail_.compare_exchange_strong( tail, tail + 1, std::memory_order_acq_rel, std::memory_order_acquire );
+    }
+
+private:
+    int capacity_;
+    std::vector<std::atomic<int>> slots_;
+    std::atomic<uint64_t> head_;        // next position to push
+    char pad_[64];                      // keep head_ and tail_ on separate cache lines
+    std::atomic<uint64_t> tail_;        // oldest queued position
+};
+
+} // namespace detail
+
+template <typename T>
+class FrameRing
+{
+public:
+    /**
+     * \brief Allocate every frame of the ring up front
+     * \param capacity - maximum number of queued frames
+     * \param policy - behavior of push() on a full ring
+    */
+    FrameRing( int capacity, RingOverflowPolicy policy )
+        : policy_( policy )
+        , frames_( capacity + 2 )
+        , queued_( capacity )
+        , free_( capacity + 2 )
+        , writeSlot_( 0 )
+        , readSlot_( -1 )
+        , dropped_( 0 )
+    {
+        for( int i = 1; i < capacity + 2; i++ )
+        {
+            free_.push( i );
+        }
+    }
+
+    FrameRing( const FrameRing& ) = delete;
+    FrameRing& operator=( const FrameRing& ) = delete;
+
+    // Producer
+
+    /**
+     * \brief Frame to fill before the next push(); it may hold the contents of
+     * an earlier (consumed or dropped) frame
+    */
+    T& writeFrame() { return frames_[writeSlot_]; }
+
+    /**
+     * \brief Publish writeFrame() to the consumer
+     * \return - false if the frame was dropped (RingOverflow_DropNewest on a full ring)
+    */
+    bool push()
+    {
+        if( !queued_.push( writeSlot_ ) )
+        {
+            if( policy_ == RingOverflow_DropNewest )
+            {
+                dropped_.fetch_add( 1, std::memory_order_relaxed );
+                return false;
+            }
+
+            int oldest = 0;
+            if( queued_.tryPop( oldest ) )
+            {
+                // the oldest frame is dropped and becomes the next frame to write
+                queued_.push( writeSlot_ );
+                writeSlot_ = oldest;
+                dropped_.fetch_add( 1, std::memory_order_relaxed );
+                return true;
+            }
+
+            // the consumer made room in the meantime
+            queued_.push( writeSlot_ );
+        }
+
+        // with fewer than capacity frames queued, at least one slot is free
+        free_.pop( writeSlot_ );
+        return true;
+    }
+
+    // Consumer
+
+    /**
+     * \brief Take the oldest queued frame. It stays valid, and is not written
+     * by the producer, until the next pop() or release().
+     * \return - oldest frame, nullptr if the ring is empty
+    */
+    T* pop()
+    {
+        release();
+        int slot = 0;
+        if( !queued_.pop( slot ) )
+        {
+            return nullptr;
+        }
+        readSlot_ = slot;
+        return &frames_[slot];
+    }
+
+    /**
+     * \brief Hand the frame returned by pop() back to the producer
+    */
+    void release()
+    {
+        if( readSlot_ >= 0 )
+        {
+            free_.push( readSlot_ );
+            readSlot_ = -1;
+        }
+    }
+
+    // Either side
+
+    int capacity() const { return (int) frames_.size() - 2; }
+    int size() const { return queued_.size(); }
+    uint64_t dropped() const { return dropped_.load( std::memory_order_relaxed ); }
+
+    // Every frame of the ring, for setup and teardown while neither side runs
+    int frameCount() const { return (int) frames_.size(); }
+    T& frame( int i ) { return frames_[i]; }
+
+private:
+    RingOverflowPolicy policy_;
+    std::vector<T> frames_;
+    detail::SlotQueue queued_;          // producer -> consumer
+    detail::SlotQueue free_;            // consumer -> producer
+    int writeSlot_;                     // producer only
+    int readSlot_;                      // consumer only, -1 when none
+    std::atomic<uint64_t> dropped_;
+};
+
+} // namespace natnet
@@ -0,0 +1,407 @@
+/**
+ * \file   FrameSoA.cpp
+ * \brief  Structure of arrays frame decoder.
+ */
+
+#include "FrameSoA.h"
+
+#include "FrameLayout.h"
+#include "FrameWalk.h"
+#include "MarkerKernels.h"
+
+#include <cstdlib>
+#include <new>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace natnet
+{
+
+namespace detail
+{
+
+void* AlignedAlloc( size_t bytes )
+{
+#ifdef _WIN32
+    void* ptr = _aligned_malloc( bytes, kSimdAlignment );
+#else
+    void* ptr = nullptr;
+    if( posix_memalign( &ptr, kSimdAlignment, bytes ) != 0 )
+    {
+        ptr = nullptr;
+    }
+#endif
+    if( ptr == nullptr )
+    {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void AlignedFree( void* ptr )
+{
+#ifdef _WIN32
+    _aligned_free( ptr );
+#else
+    free( ptr );
+#endif
+}
+
+} // namespace detail
+
+void RigidBodyArrays::resize( int n )
+{
+    count = n;
+    id.resize( n );
+    x.resize( n ); y.resize( n ); z.resize( n );
+    qx.resize( n ); qy.resize( n ); qz.resize( n ); qw.resize( n );
+    meanError.resize( n );
+    params.resize( n );
+}
+
+void MarkerArrays::resize( int n )
+{
+    count = n;
+    id.resize( n );
+    x.resize( n ); y.resize( n ); z.resize( n );
+    size.resize( n );
+    params.resize( n );
+    residual.resize( n );
+}
+
+void PointArrays::resize( int n )
+{
+    count = n;
+    x.resize( n ); y.resize( n ); z.resize( n );
+}
+
+namespace
+{
+
+/**
+ * \brief Unpack one rigid body record into row i of the arrays
+ * \param ptr - input data stream pointer
+ * \param rb - output arrays
+ * \param i - output row
+ * \tparam MarkerBytes - size per marker of the legacy marker block, 0 when absent
+ * \tparam HasError - record carries the mean marker error
+ * \tparam HasParams - record carries params
+ * \return - pointer after decoded object
+*/
+template <int MarkerBytes, bool HasError, bool HasParams>
+const char* UnpackRigidBody( const char* ptr, RigidBodyArrays& rb, int i )
+{
+    memcpy( &rb.id[i], ptr, 4 ); ptr += 4;
+    memcpy( &rb.x[i], ptr, 4 ); ptr += 4;
+    memcpy( &rb.y[i], ptr, 4 ); ptr += 4;
+    memcpy( &rb.z[i], ptr, 4 ); ptr += 4;
+    memcpy( &rb.qx[i], ptr, 4 ); ptr += 4;
+    memcpy( &rb.qy[i], ptr, 4 ); ptr += 4;
+    memcpy( &rb.qz[i], ptr, 4 ); ptr += 4;
+    memcpy( &rb.qw[i], ptr, 4 ); ptr += 4;
+
+    if( MarkerBytes > 0 )
+    {
+        int nRigidMarkers = 0; memcpy( &nRigidMarkers, ptr, 4 ); ptr += 4;
+        ptr += std::max( 0, nRigidMarkers ) * MarkerBytes;
+    }
+
+    rb.meanError[i] = 0.0f;
+    if( HasError )
+    {
+        memcpy( &rb.meanError[i], ptr, 4 ); ptr += 4;
+    }
+
+    rb.params[i] = 0;
+    if( HasParams )
+    {
+        memcpy( &rb.params[i], ptr, 2 ); ptr += 2;
+    }
+    return ptr;
+}
+
+/**
+ * \brief Unpack one labeled marker record of a pre 3.0 layout into row i of the arrays
+ * \param ptr - input data stream pointer
+ * \param markers - output arrays
+ * \param i - output row
+ * \tparam HasParams - record carries params
+ * \tparam HasResidual - record carries the residual
+ * \return - pointer after decoded object
+*/
+template <bool HasParams, bool HasResidual>
+const char* UnpackMarker( const char* ptr, MarkerArrays& markers, int i )
+{
+    memcpy( &markers.id[i], ptr, 4 ); ptr += 4;
+    memcpy( &markers.x[i], ptr, 4 ); ptr += 4;
+    memcpy( &markers.y[i], ptr, 4 ); ptr += 4;
+    memcpy( &markers.z[i], ptr, 4 ); ptr += 4;
+    memcpy( &markers.size[i], ptr, 4 ); ptr += 4;
+
+    markers.params[i] = 0;
+    if( HasParams )
+    {
+        memcpy( &markers.params[i], ptr, 2 ); ptr += 2;
+    }
+
+    markers.residual[i] = 0.0f;
+    if( HasResidual )
+    {
+        memcpy( &markers.residual[i], ptr, 4 ); ptr += 4;
+    }
+    return ptr;
+}
+
+/**
+ * \brief Unpack a NAT_FRAMEOFDATA payload into structure of arrays layout
+ * \param inptr - input data stream pointer (after the packet header)
+ * \param nBytes - payload size
+ * \param frame - output frame
+ * \param sections - FrameSection mask of the sections to decode, the others read as empty
+ * \return - pointer after decoded object
+*/
+template <typename Layout>
+const char* UnpackFrameSoA( const char* inptr, int /*nBytes*/, FrameSoA& frame, uint32_t sections )
+{
+    const int major = Layout::major;
+    const int minor = Layout::minor;
+    const MarkerKernels& kernels = GetMarkerKernels();
+    const char* ptr = inptr;
+    int count = 0;
+
+    frame.otherMarkers.resize( 0 );
+    frame.rigidBodies.resize( 0 );
+    frame.skeletons.clear();
+    frame.skeletonRigidBodies.resize( 0 );
+    frame.assets.clear();
+    frame.assetRigidBodies.resize( 0 );
+    frame.assetMarkers.resize( 0 );
+    frame.labeledMarkers.resize( 0 );
+
+    // Unsubscribed sections are jumped over using their size when the stream
+    // carries one, and stepped over undecoded otherwise (see FrameWalk.h)
+    auto skipped = [&]( uint32_t section ) { return !( sections & section ); };
+
+    // frame number
+    memcpy( &frame.iFrame, ptr, 4 ); ptr += 4;
+
+    // markersets (not part of the SoA layout)
+    ptr = Layout::sectionSizes ? SkipFrameSection( ptr, major, minor ) : SkipMarkerSets<Layout>( ptr );
+
+    // legacy other markers
+    if( skipped( FrameSection_LegacyOtherMarkers ) )
+    {
+        ptr = Layout::sectionSizes ? SkipFrameSection( ptr, major, minor ) : SkipOtherMarkers<Layout>( ptr );
+    }
+    else
+    {
+        ptr = ReadSectionHeader<Layout>( ptr, count );
+        PointArrays& points = frame.otherMarkers;
+        points.resize( count );
+        kernels.unpackPoints( ptr, count, points, 0 );
+        ptr += count * 12;
+    }
+
+    // rigid bodies
+    if( skipped( FrameSection_RigidBodies ) )
+    {
+        ptr = Layout::sectionSizes ? SkipFrameSection( ptr, major, minor ) : SkipRigidBodies<Layout>( ptr );
+    }
+    else
+    {
+        ptr = ReadSectionHeader<Layout>( ptr, count );
+        frame.rigidBodies.resize( count );
+        for( int i = 0; i < count; i++ )
+        {
+            ptr = UnpackRigidBody<Layout::rigidBodyMarkerBytes, Layout::rigidBodyError, Layout::params>( ptr, frame.rigidBodies, i );
+        }
+    }
+
+    // skeletons (NatNet 2.1 and later)
+    if( Layout::skeletons )
+    {
+        if( skipped( FrameSection_Skeletons ) )
+        {
+            ptr = Layout::sectionSizes ? SkipFrameSection( ptr, major, minor ) : SkipSkeletons<Layout>( ptr );
+        }
+        else
+        {
+            ptr = ReadSectionHeader<Layout>( ptr, count );
+            RigidBodyArrays& bones = frame.skeletonRigidBodies;
+            for( int i = 0; i < count; i++ )
+            {
+                SkeletonRange range;
+                memcpy( &range.skeletonID, ptr, 4 ); ptr += 4;
+                memcpy( &range.nRigidBodies, ptr, 4 ); ptr += 4;
+                range.nRigidBodies = std::max( 0, range.nRigidBodies );
+                range.firstRigidBody = bones.count;
+                bones.resize( bones.count + range.nRigidBodies );
+                for( int k = 0; k < range.nRigidBodies; k++ )
+                {
+                    ptr = UnpackRigidBody<0, Layout::boneError, Layout::params>( ptr, bones, range.firstRigidBody + k );
+                }
+                frame.skeletons.push_back( range );
+            }
+        }
+    }
+
+    // assets (NatNet 4.1 and later, always sized)
+    if( Layout::assets )
+    {
+        if( skipped( FrameSection_Assets ) )
+        {
+            ptr = SkipFrameSection( ptr, major, minor );
+        }
+        else
+        {
+            ptr = ReadSectionHeader<Layout>( ptr, count );
+            RigidBodyArrays& rigidBodies = frame.assetRigidBodies;
+            MarkerArrays& markers = frame.assetMarkers;
+            for( int i = 0; i < count; i++ )
+            {
+                AssetRange range;
+                memcpy( &range.assetID, ptr, 4 ); ptr += 4;
+
+                memcpy( &range.nRigidBodies, ptr, 4 ); ptr += 4;
+                range.nRigidBodies = std::max( 0, range.nRigidBodies );
+                range.firstRigidBody = rigidBodies.count;
+                rigidBodies.resize( rigidBodies.count + range.nRigidBodies );
+                for( int k = 0; k < range.nRigidBodies; k++ )
+                {
+                    ptr = UnpackRigidBody<0, true, true>( ptr, rigidBodies, range.firstRigidBody + k );
+                }
+
+                memcpy( &range.nMarkers, ptr, 4 ); ptr += 4;
+                range.nMarkers = std::max( 0, range.nMarkers );
+                range.firstMarker = markers.count;
+                markers.resize( markers.count + range.nMarkers );
+                kernels.unpackMarkers( ptr, range.nMarkers, markers, range.firstMarker );
+                ptr += range.nMarkers * 26;
+
+                frame.assets.push_back( range );
+            }
+        }
+    }
+
+    // labeled markers (NatNet 2.3 and later)
+    if( Layout::labeledMarkers )
+    {
+        if( skipped( FrameSection_LabeledMarkers ) )
+        {
+            ptr = Layout::sectionSizes ? SkipFrameSection( ptr, major, minor ) : SkipLabeledMarkers<Layout>( ptr );
+        }
+        else
+        {
+            ptr = ReadSectionHeader<Layout>( ptr, count );
+            frame.labeledMarkers.resize( count );
+            if( Layout::labeledMarkerBytes == 26 )
+            {
+                // NatNet 3.0 and later, full records
+                kernels.unpackMarkers( ptr, count, frame.labeledMarkers, 0 );
+                ptr += count * 26;
+            }
+            else
+            {
+                for( int i = 0; i < count; i++ )
+                {
+                    ptr = UnpackMarker<Layout::params, Layout::markerResidual>( ptr, frame.labeledMarkers, i );
+                }
+            }
+        }
+    }
+
+    // force plates and devices (not part of the SoA layout)
+    if( Layout::forcePlates )
+    {
+        ptr = Layout::sectionSizes ? SkipFrameSection( ptr, major, minor ) : SkipAnalogSection<Layout>( ptr );
+    }
+    if( Layout::devices )
+    {
+        ptr = Layout::sectionSizes ? SkipFrameSection( ptr, major, minor ) : SkipAnalogSection<Layout>( ptr );
+    }
+
+    // suffix
+    if( Layout::softwareLatency )
+    {
+        ptr += 4;
+    }
+
+    memcpy( &frame.Timecode, ptr, 4 ); ptr += 4;
+    memcpy( &frame.TimecodeSubframe, ptr, 4 ); ptr += 4;
+
+    if( Layout::doubleTimestamp )
+    {
+        memcpy( &frame.fTimestamp, ptr, 8 ); ptr += 8;
+    }
+    else
+    {
+        float fTemp = 0.0f;
+        memcpy( &fTemp, ptr, 4 ); ptr += 4;
+        frame.fTimestamp = (double) fTemp;
+    }
+
+    frame.CameraMidExposureTimestamp = 0;
+    frame.CameraDataReceivedTimestamp = 0;
+    frame.TransmitTimestamp = 0;
+    if( Layout::highResTimestamps )
+    {
+        memcpy( &frame.CameraMidExposureTimestamp, ptr, 8 ); ptr += 8;
+        memcpy( &frame.CameraDataReceivedTimestamp, ptr, 8 ); ptr += 8;
+        memcpy( &frame.TransmitTimestamp, ptr, 8 ); ptr += 8;
+    }
+
+    frame.PrecisionTimestampSecs = 0;
+    frame.PrecisionTimestampFractionalSecs = 0;
+    if( Layout::precisionTimestamps )
+    {
+        memcpy( &frame.PrecisionTimestampSecs, ptr, 4 ); ptr += 4;
+        memcpy( &frame.PrecisionTimestampFractionalSecs, ptr, 4 ); ptr += 4;
+    }
+
+    memcpy( &frame.params, ptr, 2 ); ptr += 2;
+
+    // end of data tag
+    ptr += 4;
+
+    return ptr;
+}
+
+template <typename Layout>
+struct SelectUnpacker
+{
+    static FrameSoAUnpacker get() { return &UnpackFrameSoA<Layout>; }
+};
+
+} // namespace
+
+/**
+ * \brief Unpack a NAT_FRAMEOFDATA payload into structure of arrays layout.
+ * Selects the decoder for the version on every call; streaming clients should
+ * keep a FrameDecoder for the connection instead.
+ * \param inptr - input data stream pointer (after the packet header)
+ * \param nBytes - payload size
+ * \param major - NatNet major version
+ * \param minor - NatNet minor version
+ * \param frame - output frame
+ * \param sections - FrameSection mask of the sections to decode, the others read as empty
+ * \return - pointer after decoded object
+*/
+const char* UnpackFrameDataSoA( const char* inptr, int nBytes, int major, int minor, FrameSoA& frame,
+    uint32_t sections /*= FrameSection_All*/ )
+{
+    return SelectFrameSoAUnpacker( major, minor )( inptr, nBytes, frame, sections );
+}
+
+/**
+ * \brief Structure of arrays decoder compiled for the layout of a version
+ * \param major - NatNet major version
+ * \param minor - NatNet minor version
+ * \return - decoder
+*/
+FrameSoAUnpacker SelectFrameSoAUnpacker( int major, int minor )
+{
+    return DispatchLayout<SelectUnpacker>( major, minor );
+}
+
+} // namespace natnet
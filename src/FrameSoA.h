@@ -0,0 +1,193 @@
+/**
+ * \file   FrameSoA.h
+ * \brief  Structure of arrays decode target for NAT_FRAMEOFDATA payloads.
+ * sFrameOfMocapData stores rigid bodies and markers as arrays of packed
+ * structs. FrameSoA stores each field in its own contiguous array instead
+ * (x[], y[], z[], qx[] ...), aligned to kSimdAlignment bytes and padded to
+ * whole SIMD blocks, so transforms and filters can process all bodies or
+ * markers of a frame with full width vector loads and stores.
+ */
+
+#pragma once
+
+#include "NatNetDecoder.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace natnet
+{
+
+// Alignment (and padding granularity) of every FrameSoA array, one AVX register
+const size_t kSimdAlignment = 32;
+
+namespace detail
+{
+
+void* AlignedAlloc( size_t bytes );
+void AlignedFree( void* ptr );
+
+} // namespace detail
+
+/**
+ * \brief Growable array of trivially copyable values with aligned storage.
+ * The capacity is always a multiple of kSimdAlignment bytes, so a vector loop
+ * may read and write up to the end of the last block past size(). Resizing
+ * keeps the capacity, so steady state decoding does not allocate.
+ */
+template <typename T>
+class AlignedArray
+{
+    static_assert( std::is_trivially_copyable<T>::value, "AlignedArray requires trivially copyable types" );
+
+public:
+    AlignedArray() : data_( nullptr ), size_( 0 ), capacity_( 0 ) {}
+    ~AlignedArray() { detail::AlignedFree( data_ ); }
+    AlignedArray( const AlignedArray& ) = delete;
+    AlignedArray& operator=( const AlignedArray& ) = delete;
+
+    void resize( size_t n )
+    {
+        if( n > capacity_ )
+        {
+            reserve( std::max( n, 2 * capacity_ ) );
+        }
+        size_ = n;
+    }
+
+    void reserve( size_t n )
+    {
+        const size_t perBlock = kSimdAlignment / sizeof( T );
+        n = ( n + perBlock - 1 ) / perBlock * perBlock;
+        if( n <= capacity_ )
+        {
+            return;
+        }
+        T* data = static_cast<T*>( detail::AlignedAlloc( n * sizeof( T ) ) );
+        if( size_ > 0 )
+        {
+            memcpy( data, data_, size_ * sizeof( T ) );
+        }
+        detail::AlignedFree( data_ );
+        data_ = data;
+        capacity_ = n;
+    }
+
+    T* data() { return data_; }
+    const T* data() const { return data_; }
+    size_t size() const { return size_; }
+    size_t capacity() const { return capacity_; }
+    T& operator[]( size_t i ) { return data_[i]; }
+    const T& operator[]( size_t i ) const { return data_[i]; }
+
+private:
+    T* data_;
+    size_t size_;
+    size_t capacity_;
+};
+
+/**
+ * \brief Rigid bodies (top level, skeleton bones or asset members)
+ */
+struct RigidBodyArrays
+{
+    void resize( int n );
+
+    int count = 0;
+    AlignedArray<int32_t> id;
+    AlignedArray<float> x, y, z;
+    AlignedArray<float> qx, qy, qz, qw;
+    AlignedArray<float> meanError;                      // 0 when not streamed
+    AlignedArray<int16_t> params;                       // 0 when not streamed
+};
+
+/**
+ * \brief Labeled markers or asset markers
+ */
+struct MarkerArrays
+{
+    void resize( int n );
+
+    int count = 0;
+    AlignedArray<int32_t> id;
+    AlignedArray<float> x, y, z;
+    AlignedArray<float> size;
+    AlignedArray<int16_t> params;                       // 0 when not streamed
+    AlignedArray<float> residual;                       // 0 when not streamed
+};
+
+/**
+ * \brief Unlabeled (legacy other) marker positions
+ */
+struct PointArrays
+{
+    void resize( int n );
+
+    int count = 0;
+    AlignedArray<float> x, y, z;
+};
+
+// Rigid bodies of skeleton i are skeletonRigidBodies[firstRigidBody, firstRigidBody + nRigidBodies)
+struct SkeletonRange
+{
+    int32_t skeletonID;
+    int firstRigidBody;
+    int nRigidBodies;
+};
+
+// Members of asset i in assetRigidBodies and assetMarkers
+struct AssetRange
+{
+    int32_t assetID;
+    int firstRigidBody;
+    int nRigidBodies;
+    int firstMarker;
+    int nMarkers;
+};
+
+/**
+ * \brief Decoded frame in structure of arrays layout.
+ * Covers the per-element sections (rigid bodies, skeletons, assets, labeled
+ * and legacy markers) and the frame timing fields. Markersets, force plates
+ * and devices are skipped; decode into MocapFrame or index with FrameView
+ * when those are needed.
+ */
+struct FrameSoA
+{
+    FrameSoA() = default;
+    FrameSoA( const FrameSoA& ) = delete;
+    FrameSoA& operator=( const FrameSoA& ) = delete;
+
+    int32_t iFrame = 0;
+
+    PointArrays otherMarkers;
+    RigidBodyArrays rigidBodies;
+    std::vector<SkeletonRange> skeletons;
+    RigidBodyArrays skeletonRigidBodies;
+    std::vector<AssetRange> assets;
+    RigidBodyArrays assetRigidBodies;
+    MarkerArrays assetMarkers;
+    MarkerArrays labeledMarkers;
+
+    uint32_t Timecode = 0;
+    uint32_t TimecodeSubframe = 0;
+    double fTimestamp = 0.0;
+    uint64_t CameraMidExposureTimestamp = 0;
+    uint64_t CameraDataReceivedTimestamp = 0;
+    uint64_t TransmitTimestamp = 0;
+    uint32_t PrecisionTimestampSecs = 0;
+    uint32_t PrecisionTimestampFractionalSecs = 0;
+    int16_t params = 0;
+
+    ReceiveTimestamp receiveTimestamp = {};     // set by the receiver, not by the decoders
+};
+
+const char* UnpackFrameDataSoA( const char* inptr, int nBytes, int major, int minor, FrameSoA& frame,
+    uint32_t sections = FrameSection_All );
+FrameSoAUnpacker SelectFrameSoAUnpacker( int major, int minor );
+
+} // namespace natnet
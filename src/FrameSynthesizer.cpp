@@ -0,0 +1,477 @@
+/**
+ * \file   FrameSynthesizer.cpp
+ * \brief  Synthetic scenes: data descriptions and moving frames without a capture volume.
+ */
+
+#include "FrameSynthesizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace natnet
+{
+
+namespace
+{
+
+const float kMarkerSize = 0.014f;
+const float kBoneLength = 0.1f;
+
+void CopyName( char* dest, size_t destSize, const std::string& name )
+{
+    strncpy( dest, name.c_str(), destSize - 1 );
+    dest[destSize - 1] = '\0';
+}
+
+// Rotation by angle about the vertical (y) axis
+void SetYaw( sRigidBodyData& rb, float angle )
+{
+    rb.qx = 0.0f;
+    rb.qy = sinf( 0.5f * angle );
+    rb.qz = 0.0f;
+    rb.qw = cosf( 0.5f * angle );
+}
+
+void SetMarker( float* marker, float x, float y, float z )
+{
+    marker[0] = x;
+    marker[1] = y;
+    marker[2] = z;
+}
+
+void FillChannels( sAnalogChannelData* channels, int nChannels, int nSamples, double seconds, int seed )
+{
+    for( int c = 0; c < nChannels; c++ )
+    {
+        channels[c].nFrames = nSamples;
+        for( int s = 0; s < nSamples; s++ )
+        {
+            channels[c].Values[s] = (float) sin( seconds * ( 1.0 + c ) + seed + 0.01 * s );
+        }
+    }
+}
+
+} // namespace
+
+SyntheticScene::SyntheticScene()
+    : markerSets( 1 )
+    , markerSetMarkers( 10 )
+    , otherMarkers( 0 )
+    , rigidBodies( 10 )
+    , rigidBodyMarkers( 4 )
+    , skeletons( 1 )
+    , skeletonBones( 21 )
+    , assets( 0 )
+    , assetRigidBodies( 4 )
+    , assetMarkers( 10 )
+    , labeledMarkers( 50 )
+    , forcePlates( 0 )
+    , forcePlateChannels( 6 )
+    , devices( 0 )
+    , deviceChannels( 8 )
+    , analogSamples( 10 )
+    , frameRate( 120.0 )
+{
+}
+
+/**
+ * \param scene - what to synthesize; counts are clamped to the SDK limits
+ * \param sections - FrameSection mask of the sections to populate, e.g.
+ *                   FrameSectionsOf( major, minor ) for a bitstream version
+*/
+FrameSynthesizer::FrameSynthesizer( const SyntheticScene& scene, uint32_t sections /*= FrameSection_All*/ )
+    : scene_( scene )
+    , descriptions_( new sDataDescriptions() )
+    , frame_( new sFrameOfMocapData() )
+{
+    SyntheticScene& s = scene_;
+    s.markerSets = ( sections & FrameSection_MarkerSets ) ? ClampCount( s.markerSets, MAX_MARKERSETS ) : 0;
+    s.markerSetMarkers = ClampCount( s.markerSetMarkers, MAX_MARKERS );
+    s.otherMarkers = ( sections & FrameSection_LegacyOtherMarkers ) ? ClampCount( s.otherMarkers, MAX_UNLABELED_MARKERS ) : 0;
+    s.rigidBodies = ( sections & FrameSection_RigidBodies ) ? ClampCount( s.rigidBodies, MAX_RIGIDBODIES ) : 0;
+    s.rigidBodyMarkers = ClampCount( s.rigidBodyMarkers, MAX_RBMARKERS );
+    s.skeletons = ( sections & FrameSection_Skeletons ) ? ClampCount( s.skeletons, MAX_SKELETONS ) : 0;
+    s.skeletonBones = ClampCount( s.skeletonBones, MAX_SKELRIGIDBODIES );
+    s.assets = ( sections & FrameSection_Assets ) ? ClampCount( s.assets, MAX_ASSETS ) : 0;
+    s.assetRigidBodies = ClampCount( s.assetRigidBodies, MAX_SKELRIGIDBODIES );
+    s.assetMarkers = ClampCount( s.assetMarkers, MAX_MARKERS );
+    s.labeledMarkers = ( sections & FrameSection_LabeledMarkers ) ? ClampCount( s.labeledMarkers, MAX_LABELED_MARKERS ) : 0;
+    s.forcePlates = ( sections & FrameSection_ForcePlates ) ? ClampCount( s.forcePlates, MAX_FORCEPLATES ) : 0;
+    s.forcePlateChannels = ClampCount( s.forcePlateChannels, MAX_ANALOG_CHANNELS );
+    s.devices = ( sections & FrameSection_Devices ) ? ClampCount( s.devices, MAX_DEVICES ) : 0;
+    s.deviceChannels = ClampCount( s.deviceChannels, MAX_ANALOG_CHANNELS );
+    s.analogSamples = ClampCount( s.analogSamples, MAX_ANALOG_SUBFRAMES );
+    if( !( s.frameRate > 0.0 ) )
+    {
+        s.frameRate = 120.0;
+    }
+
+    buildDescriptions();
+    buildFrame();
+}
+
+/**
+ * \brief Move the scene to a frame
+ * \param frameNumber - frame number, at scene().frameRate frames per second
+ * \return - the frame, owned by the synthesizer
+*/
+sFrameOfMocapData& FrameSynthesizer::synthesize( int32_t frameNumber )
+{
+    const SyntheticScene& s = scene_;
+    sFrameOfMocapData& data = *frame_;
+    double seconds = frameNumber / s.frameRate;
+    float t = (float) seconds;
+
+    data.iFrame = frameNumber;
+    data.fTimestamp = seconds;
+
+    for( int i = 0; i < s.markerSets; i++ )
+    {
+        MarkerData* markers = data.MocapData[i].Markers;
+        for( int j = 0; j < s.markerSetMarkers; j++ )
+        {
+            float angle = t + 0.3f * j + i;
+            SetMarker( markers[j], 0.2f * cosf( angle ) + 0.1f * i, 1.0f + 0.01f * j, 0.2f * sinf( angle ) );
+        }
+    }
+
+    for( int i = 0; i < s.otherMarkers; i++ )
+    {
+        SetMarker( data.OtherMarkers[i], 2.0f * sinf( 0.1f * t + i ), 0.01f * i, 2.0f * cosf( 0.1f * t + i ) );
+    }
+
+    for( int i = 0; i < s.rigidBodies; i++ )
+    {
+        sRigidBodyData& rb = data.RigidBodies[i];
+        float angle = 0.5f * t + 0.7f * i;
+        float radius = 0.5f + 0.05f * ( i % 10 );
+        rb.x = radius * cosf( angle );
+        rb.y = 1.0f + 0.1f * sinf( t + i );
+        rb.z = radius * sinf( angle );
+        SetYaw( rb, angle );
+    }
+
+    for( int i = 0; i < s.skeletons; i++ )
+    {
+        sSkeletonData& skeleton = data.Skeletons[i];
+        float sway = 0.2f * sinf( t + i );
+        for( int j = 0; j < s.skeletonBones; j++ )
+        {
+            sRigidBodyData& bone = skeleton.RigidBodyData[j];
+            bone.x = 1.0f * i + sway * j * kBoneLength;
+            bone.y = j * kBoneLength;
+            bone.z = 0.0f;
+            SetYaw( bone, sway );
+        }
+    }
+
+    for( int i = 0; i < s.assets; i++ )
+    {
+        sAssetData& asset = data.Assets[i];
+        float angle = t + i;
+        for( int j = 0; j < s.assetRigidBodies; j++ )
+        {
+            sRigidBodyData& rb = asset.RigidBodyData[j];
+            rb.x = -1.0f - 0.5f * i;
+            rb.y = 0.5f + j * kBoneLength;
+            rb.z = 0.1f * sinf( angle + j );
+            SetYaw( rb, angle );
+        }
+        for( int j = 0; j < s.assetMarkers; j++ )
+        {
+            sMarker& marker = asset.MarkerData[j];
+            marker.x = -1.0f - 0.5f * i + 0.05f * cosf( angle + j );
+            marker.y = 0.5f + 0.02f * j;
+            marker.z = 0.05f * sinf( angle + j );
+        }
+    }
+
+    for( int i = 0; i < s.labeledMarkers; i++ )
+    {
+        sMarker& marker = data.LabeledMarkers[i];
+        float angle = 0.25f * t + 0.1f * i;
+        marker.x = 1.5f * cosf( angle );
+        marker.y = 0.02f * ( i % 50 );
+        marker.z = 1.5f * sinf( angle );
+    }
+
+    for( int i = 0; i < s.forcePlates; i++ )
+    {
+        FillChannels( data.ForcePlates[i].ChannelData, s.forcePlateChannels, s.analogSamples, seconds, i );
+    }
+    for( int i = 0; i < s.devices; i++ )
+    {
+        FillChannels( data.Devices[i].ChannelData, s.deviceChannels, s.analogSamples, seconds, 100 + i );
+    }
+
+    return data;
+}
+
+// Stable C string for the descriptions
+char* FrameSynthesizer::storeName( const std::string& name )
+{
+    names_.push_back( name );
+    return &names_.back()[0];
+}
+
+void FrameSynthesizer::buildDescriptions()
+{
+    const SyntheticScene& s = scene_;
+    sDataDescriptions& descriptions = *descriptions_;
+
+    markerSetDescriptions_.resize( s.markerSets );
+    for( int i = 0; i < s.markerSets; i++ )
+    {
+        sMarkerSetDescription& markerSet = markerSetDescriptions_[i];
+        std::string name = "MarkerSet" + std::to_string( i + 1 );
+        CopyName( markerSet.szName, sizeof( markerSet.szName ), name );
+        markerSet.nMarkers = s.markerSetMarkers;
+        nameLists_.push_back( std::vector<char*>() );
+        for( int j = 0; j < s.markerSetMarkers; j++ )
+        {
+            nameLists_.back().push_back( storeName( name + "_" + std::to_string( j + 1 ) ) );
+        }
+        markerSet.szMarkerNames = nameLists_.back().data();
+    }
+
+    // rigid body marker positions in the body's frame, on a square
+    rigidBodyMarkerPositions_.resize( (size_t) s.rigidBodies * s.rigidBodyMarkers * 3 );
+    rigidBodyMarkerLabels_.resize( (size_t) s.rigidBodies * s.rigidBodyMarkers );
+    rigidBodyDescriptions_.resize( s.rigidBodies );
+    for( int i = 0; i < s.rigidBodies; i++ )
+    {
+        sRigidBodyDescription& rb = rigidBodyDescriptions_[i];
+        std::string name = "RigidBody" + std::to_string( i + 1 );
+        CopyName( rb.szName, sizeof( rb.szName ), name );
+        rb.ID = i + 1;
+        rb.parentID = -1;
+        rb.nMarkers = s.rigidBodyMarkers;
+        size_t first = (size_t) i * s.rigidBodyMarkers;
+        rb.MarkerPositions = reinterpret_cast<MarkerData*>( &rigidBodyMarkerPositions_[first * 3] );
+        rb.MarkerRequiredLabels = &rigidBodyMarkerLabels_[first];
+        nameLists_.push_back( std::vector<char*>() );
+        for( int j = 0; j < s.rigidBodyMarkers; j++ )
+        {
+            float angle = 1.5707963f * j;
+            SetMarker( rb.MarkerPositions[j], 0.05f * cosf( angle ), 0.01f * j, 0.05f * sinf( angle ) );
+            nameLists_.back().push_back( storeName( name + "_" + std::to_string( j + 1 ) ) );
+        }
+        rb.szMarkerNames = nameLists_.back().data();
+    }
+
+    skeletonDescriptions_.resize( s.skeletons );
+    for( int i = 0; i < s.skeletons; i++ )
+    {
+        sSkeletonDescription& skeleton = skeletonDescriptions_[i];
+        CopyName( skeleton.szName, sizeof( skeleton.szName ), "Skeleton" + std::to_string( i + 1 ) );
+        skeleton.skeletonID = i + 1;
+        skeleton.nRigidBodies = s.skeletonBones;
+        for( int j = 0; j < s.skeletonBones; j++ )
+        {
+            sRigidBodyDescription& bone = skeleton.RigidBodies[j];
+            CopyName( bone.szName, sizeof( bone.szName ), "Bone" + std::to_string( j + 1 ) );
+            bone.ID = j + 1;
+            bone.parentID = ( j == 0 ) ? -1 : j;
+            bone.offsety = ( j == 0 ) ? 0.0f : kBoneLength;
+        }
+    }
+
+    assetDescriptions_.resize( s.assets );
+    for( int i = 0; i < s.assets; i++ )
+    {
+        sAssetDescription& asset = assetDescriptions_[i];
+        std::string name = "Asset" + std::to_string( i + 1 );
+        CopyName( asset.szName, sizeof( asset.szName ), name );
+        asset.AssetType = AssetType_TrainedMarkerset;
+        asset.AssetID = i + 1;
+        asset.nRigidBodies = s.assetRigidBodies;
+        for( int j = 0; j < s.assetRigidBodies; j++ )
+        {
+            sRigidBodyDescription& rb = asset.RigidBodies[j];
+            CopyName( rb.szName, sizeof( rb.szName ), name + "_RigidBody" + std::to_string( j + 1 ) );
+            rb.ID = j + 1;
+            rb.parentID = ( j == 0 ) ? -1 : j;
+            rb.offsety = ( j == 0 ) ? 0.0f : kBoneLength;
+        }
+        asset.nMarkers = s.assetMarkers;
+        for( int j = 0; j < s.assetMarkers; j++ )
+        {
+            sMarkerDescription& marker = asset.Markers[j];
+            CopyName( marker.szName, sizeof( marker.szName ), name + "_Marker" + std::to_string( j + 1 ) );
+            marker.ID = j + 1;
+            marker.y = 0.02f * j;
+            marker.size = kMarkerSize;
+        }
+    }
+
+    static const char* kForcePlateChannels[] = { "Fx", "Fy", "Fz", "Mx", "My", "Mz" };
+    forcePlateDescriptions_.resize( s.forcePlates );
+    for( int i = 0; i < s.forcePlates; i++ )
+    {
+        sForcePlateDescription& plate = forcePlateDescriptions_[i];
+        plate.ID = i + 1;
+        CopyName( plate.strSerialNo, sizeof( plate.strSerialNo ), "FP-" + std::to_string( i + 1 ) );
+        plate.fWidth = 0.4f;
+        plate.fLength = 0.6f;
+        for( int c = 0; c < 12; c++ )
+        {
+            plate.fCalMat[c][c] = 1.0f;
+        }
+        float x0 = 0.5f * i;
+        float corners[4][3] = { { x0 + 0.4f, 0.0f, 0.6f }, { x0, 0.0f, 0.6f }, { x0, 0.0f, 0.0f }, { x0 + 0.4f, 0.0f, 0.0f } };
+        memcpy( plate.fCorners, corners, sizeof( corners ) );
+        plate.iPlateType = 2;
+        plate.iChannelDataType = 0;
+        plate.nChannels = s.forcePlateChannels;
+        for( int c = 0; c < s.forcePlateChannels; c++ )
+        {
+            CopyName( plate.szChannelNames[c], MAX_NAMELENGTH,
+                ( c < 6 ) ? std::string( kForcePlateChannels[c] ) : "Channel" + std::to_string( c + 1 ) );
+        }
+    }
+
+    deviceDescriptions_.resize( s.devices );
+    for( int i = 0; i < s.devices; i++ )
+    {
+        sDeviceDescription& device = deviceDescriptions_[i];
+        device.ID = i + 1;
+        CopyName( device.strName, sizeof( device.strName ), "Device" + std::to_string( i + 1 ) );
+        CopyName( device.strSerialNo, sizeof( device.strSerialNo ), "DEV-" + std::to_string( i + 1 ) );
+        device.nChannels = s.deviceChannels;
+        for( int c = 0; c < s.deviceChannels; c++ )
+        {
+            CopyName( device.szChannelNames[c], MAX_NAMELENGTH, "ai" + std::to_string( c ) );
+        }
+    }
+
+    // in the order Motive lists them, up to MAX_MODELS
+    int n = 0;
+    for( size_t i = 0; ( i < markerSetDescriptions_.size() ) && ( n < MAX_MODELS ); i++, n++ )
+    {
+        descriptions.arrDataDescriptions[n].type = Descriptor_MarkerSet;
+        descriptions.arrDataDescriptions[n].Data.MarkerSetDescription = &markerSetDescriptions_[i];
+    }
+    for( size_t i = 0; ( i < rigidBodyDescriptions_.size() ) && ( n < MAX_MODELS ); i++, n++ )
+    {
+        descriptions.arrDataDescriptions[n].type = Descriptor_RigidBody;
+        descriptions.arrDataDescriptions[n].Data.RigidBodyDescription = &rigidBodyDescriptions_[i];
+    }
+    for( size_t i = 0; ( i < skeletonDescriptions_.size() ) && ( n < MAX_MODELS ); i++, n++ )
+    {
+        descriptions.arrDataDescriptions[n].type = Descriptor_Skeleton;
+        descriptions.arrDataDescriptions[n].Data.SkeletonDescription = &skeletonDescriptions_[i];
+    }
+    for( size_t i = 0; ( i < assetDescriptions_.size() ) && ( n < MAX_MODELS ); i++, n++ )
+    {
+        descriptions.arrDataDescriptions[n].type = Descriptor_Asset;
+        descriptions.arrDataDescriptions[n].Data.AssetDescription = &assetDescriptions_[i];
+    }
+    for( size_t i = 0; ( i < forcePlateDescriptions_.size() ) && ( n < MAX_MODELS ); i++, n++ )
+    {
+        descriptions.arrDataDescriptions[n].type = Descriptor_ForcePlate;
+        descriptions.arrDataDescriptions[n].Data.ForcePlateDescription = &forcePlateDescriptions_[i];
+    }
+    for( size_t i = 0; ( i < deviceDescriptions_.size() ) && ( n < MAX_MODELS ); i++, n++ )
+    {
+        descriptions.arrDataDescriptions[n].type = Descriptor_Device;
+        descriptions.arrDataDescriptions[n].Data.DeviceDescription = &deviceDescriptions_[i];
+    }
+    descriptions.nDataDescriptions = n;
+}
+
+// Counts, IDs and the values that do not move
+void FrameSynthesizer::buildFrame()
+{
+    const SyntheticScene& s = scene_;
+    sFrameOfMocapData& data = *frame_;
+
+    markerSetMarkers_.resize( (size_t) s.markerSets * s.markerSetMarkers * 3 );
+    data.nMarkerSets = s.markerSets;
+    for( int i = 0; i < s.markerSets; i++ )
+    {
+        sMarkerSetData& markerSet = data.MocapData[i];
+        memcpy( markerSet.szName, markerSetDescriptions_[i].szName, sizeof( markerSet.szName ) );
+        markerSet.nMarkers = s.markerSetMarkers;
+        markerSet.Markers = reinterpret_cast<MarkerData*>( markerSetMarkers_.data() + (size_t) i * s.markerSetMarkers * 3 );
+    }
+
+    otherMarkers_.resize( (size_t) s.otherMarkers * 3 );
+    data.nOtherMarkers = s.otherMarkers;
+    data.OtherMarkers = reinterpret_cast<MarkerData*>( otherMarkers_.data() );
+
+    data.nRigidBodies = s.rigidBodies;
+    for( int i = 0; i < s.rigidBodies; i++ )
+    {
+        data.RigidBodies[i] = sRigidBodyData();
+        data.RigidBodies[i].ID = i + 1;
+        data.RigidBodies[i].MeanError = 0.0002f;
+        data.RigidBodies[i].params = 0x01;      // tracking valid
+    }
+
+    skeletonRigidBodies_.resize( (size_t) s.skeletons * s.skeletonBones );
+    data.nSkeletons = s.skeletons;
+    for( int i = 0; i < s.skeletons; i++ )
+    {
+        sSkeletonData& skeleton = data.Skeletons[i];
+        skeleton.skeletonID = i + 1;
+        skeleton.nRigidBodies = s.skeletonBones;
+        skeleton.RigidBodyData = skeletonRigidBodies_.data() + (size_t) i * s.skeletonBones;
+        for( int j = 0; j < s.skeletonBones; j++ )
+        {
+            // skeleton ID in the high word, bone ID in the low word
+            skeleton.RigidBodyData[j].ID = ( ( i + 1 ) << 16 ) | ( j + 1 );
+            skeleton.RigidBodyData[j].params = 0x01;
+        }
+    }
+
+    assetRigidBodies_.resize( (size_t) s.assets * s.assetRigidBodies );
+    assetMarkers_.resize( (size_t) s.assets * s.assetMarkers );
+    data.nAssets = s.assets;
+    for( int i = 0; i < s.assets; i++ )
+    {
+        sAssetData& asset = data.Assets[i];
+        asset.assetID = i + 1;
+        asset.nRigidBodies = s.assetRigidBodies;
+        asset.RigidBodyData = assetRigidBodies_.data() + (size_t) i * s.assetRigidBodies;
+        for( int j = 0; j < s.assetRigidBodies; j++ )
+        {
+            asset.RigidBodyData[j].ID = j + 1;
+            asset.RigidBodyData[j].params = 0x01;
+        }
+        asset.nMarkers = s.assetMarkers;
+        asset.MarkerData = assetMarkers_.data() + (size_t) i * s.assetMarkers;
+        for( int j = 0; j < s.assetMarkers; j++ )
+        {
+            sMarker& marker = asset.MarkerData[j];
+            marker.ID = ( ( i + 1 ) << 16 ) | ( j + 1 );
+            marker.size = kMarkerSize;
+            marker.residual = 0.0002f;
+        }
+    }
+
+    data.nLabeledMarkers = s.labeledMarkers;
+    for( int i = 0; i < s.labeledMarkers; i++ )
+    {
+        sMarker& marker = data.LabeledMarkers[i];
+        marker.ID = i + 1;
+        marker.size = kMarkerSize;
+        marker.params = 0x02;                   // point cloud solved
+        marker.residual = 0.0002f;
+    }
+
+    data.nForcePlates = s.forcePlates;
+    for( int i = 0; i < s.forcePlates; i++ )
+    {
+        data.ForcePlates[i].ID = i + 1;
+        data.ForcePlates[i].nChannels = s.forcePlateChannels;
+    }
+    data.nDevices = s.devices;
+    for( int i = 0; i < s.devices; i++ )
+    {
+        data.Devices[i].ID = i + 1;
+        data.Devices[i].nChannels = s.deviceChannels;
+    }
+}
+
+} // namespace natnet
@@ -0,0 +1,94 @@
+/**
+ * \file   FrameSynthesizer.h
+ * \brief  Synthetic scenes: data descriptions and moving frames without a capture volume.
+ * A FrameSynthesizer builds the data descriptions of a scene with the
+ * requested numbers of marker sets, rigid bodies, skeletons, assets,
+ * markers, force plates and devices, and fills a frame of that scene for
+ * any frame number, with every pose and analog channel moving smoothly.
+ * Encode the results with NatNetEncoder for any bitstream version, e.g. to
+ * stand in for Motive or to benchmark decoders. Counts are fixed for the
+ * lifetime of the synthesizer, so producing a frame does not allocate.
+ */
+
+#pragma once
+
+#include "NatNetDecoder.h"
+
+#include <NatNetTypes.h>
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace natnet
+{
+
+struct SyntheticScene
+{
+    SyntheticScene();
+
+    int markerSets;
+    int markerSetMarkers;               // per marker set
+    int otherMarkers;                   // legacy unidentified markers
+    int rigidBodies;
+    int rigidBodyMarkers;               // per rigid body description
+    int skeletons;
+    int skeletonBones;                  // per skeleton
+    int assets;
+    int assetRigidBodies;               // per asset
+    int assetMarkers;                   // per asset
+    int labeledMarkers;
+    int forcePlates;
+    int forcePlateChannels;             // per force plate
+    int devices;
+    int deviceChannels;                 // per device
+    int analogSamples;                  // per channel and frame
+    double frameRate;                   // frames per second of the fTimestamp values
+};
+
+class FrameSynthesizer
+{
+public:
+    explicit FrameSynthesizer( const SyntheticScene& scene, uint32_t sections = FrameSection_All );
+    FrameSynthesizer( const FrameSynthesizer& ) = delete;
+    FrameSynthesizer& operator=( const FrameSynthesizer& ) = delete;
+
+    // Counts after clamping to the SDK limits and removing the sections not selected
+    const SyntheticScene& scene() const { return scene_; }
+
+    const sDataDescriptions& descriptions() const { return *descriptions_; }
+
+    // Frame frameNumber of the scene. Timestamps other than fTimestamp, and
+    // params, are left for the caller. Valid until the next call.
+    sFrameOfMocapData& synthesize( int32_t frameNumber );
+
+private:
+    void buildDescriptions();
+    void buildFrame();
+    char* storeName( const std::string& name );
+
+    SyntheticScene scene_;
+
+    std::unique_ptr<sDataDescriptions> descriptions_;
+    std::deque<std::string> names_;
+    std::deque<std::vector<char*>> nameLists_;
+    std::vector<sMarkerSetDescription> markerSetDescriptions_;
+    std::vector<sRigidBodyDescription> rigidBodyDescriptions_;
+    std::vector<float> rigidBodyMarkerPositions_;
+    std::vector<int32_t> rigidBodyMarkerLabels_;
+    std::vector<sSkeletonDescription> skeletonDescriptions_;
+    std::vector<sAssetDescription> assetDescriptions_;
+    std::vector<sForcePlateDescription> forcePlateDescriptions_;
+    std::vector<sDeviceDescription> deviceDescriptions_;
+
+    std::unique_ptr<sFrameOfMocapData> frame_;
+    std::vector<float> markerSetMarkers_;
+    std::vector<float> otherMarkers_;
+    std::vector<sRigidBodyData> skeletonRigidBodies_;
+    std::vector<sRigidBodyData> assetRigidBodies_;
+    std::vector<sMarker> assetMarkers_;
+};
+
+} // namespace natnet
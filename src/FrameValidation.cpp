@@ -0,0 +1,430 @@
+/**
+ * \file   FrameValidation.cpp
+ * \brief  Bounds checks for packets and NAT_FRAMEOFDATA payloads.
+ * The validator walks the frame structure without decoding it. Fixed size
+ * records are checked as a block (count * record size against the bytes
+ * left), so a section costs a handful of compares; only records that carry
+ * their own count (markersets, skeletons, assets, analog channels) are
+ * checked one by one. A payload that passes can be handed to any of the
+ * frame decoders without them reading past nBytes.
+ */
+
+#include "NatNetDecoder.h"
+
+#include "FrameLayout.h"
+
+#include <cstring>
+
+namespace natnet
+{
+
+namespace
+{
+
+/**
+ * \brief Read position within a payload, with the first failure latched
+ */
+class BoundsCheck
+{
+public:
+    BoundsCheck( const char* ptr, const char* end )
+        : ptr_( ptr ), end_( end ), sectionEnd_( end ), status_( DecodeStatus_OK )
+    {
+    }
+
+    DecodeStatus status() const { return status_; }
+
+    /**
+     * \brief Advance over nBytes
+    */
+    bool skip( int64_t nBytes )
+    {
+        if( nBytes > sectionEnd_ - ptr_ )
+        {
+            return overrun();
+        }
+        ptr_ += nBytes;
+        return true;
+    }
+
+    /**
+     * \brief Advance over count records of recordBytes each
+    */
+    bool skipRecords( int count, int recordBytes )
+    {
+        return skip( (int64_t) count * recordBytes );
+    }
+
+    /**
+     * \brief Read a record count, which must not be negative
+    */
+    bool readCount( int& count )
+    {
+        if( !readInt( count ) )
+        {
+            return false;
+        }
+        return ( count >= 0 ) || fail( DecodeStatus_InvalidCount );
+    }
+
+    /**
+     * \brief Advance over a null terminated string
+    */
+    bool skipString()
+    {
+        const void* terminator = memchr( ptr_, 0, sectionEnd_ - ptr_ );
+        if( !terminator )
+        {
+            return overrun();
+        }
+        ptr_ = static_cast<const char*>( terminator ) + 1;
+        return true;
+    }
+
+    /**
+     * \brief Read the header of a section (count, and size from NatNet 4.1 on).
+     * With a size, the records of the section are checked against the end
+     * of the section rather than the end of the payload.
+    */
+    bool beginSection( int& count, bool hasSize )
+    {
+        if( !readCount( count ) )
+        {
+            return false;
+        }
+        if( hasSize )
+        {
+            int nBytes = 0;
+            if( !readInt( nBytes ) )
+            {
+                return false;
+            }
+            if( nBytes < 0 )
+            {
+                return fail( DecodeStatus_InvalidSectionSize );
+            }
+            if( nBytes > end_ - ptr_ )
+            {
+                return fail( DecodeStatus_Truncated );
+            }
+            sectionEnd_ = ptr_ + nBytes;
+        }
+        return true;
+    }
+
+    /**
+     * \brief The records of a sized section must fill it exactly, since
+     * decoders skip unsubscribed sections by size and walk the others
+    */
+    bool endSection( bool hasSize )
+    {
+        if( hasSize && ( ptr_ != sectionEnd_ ) )
+        {
+            return fail( DecodeStatus_InvalidSectionSize );
+        }
+        sectionEnd_ = end_;
+        return true;
+    }
+
+private:
+    bool readInt( int& value )
+    {
+        if( sectionEnd_ - ptr_ < 4 )
+        {
+            return overrun();
+        }
+        memcpy( &value, ptr_, 4 ); ptr_ += 4;
+        return true;
+    }
+
+    bool overrun()
+    {
+        return fail( ( sectionEnd_ != end_ ) ? DecodeStatus_InvalidSectionSize : DecodeStatus_Truncated );
+    }
+
+    bool fail( DecodeStatus status )
+    {
+        status_ = status;
+        return false;
+    }
+
+    const char* ptr_;
+    const char* end_;           // end of the payload
+    const char* sectionEnd_;    // end of the current section, end_ when sections carry no size
+    DecodeStatus status_;
+};
+
+template <typename Layout>
+bool CheckMarkerSets( BoundsCheck& check )
+{
+    int nMarkerSets = 0;
+    if( !check.beginSection( nMarkerSets, Layout::sectionSizes ) )
+    {
+        return false;
+    }
+    for( int i = 0; i < nMarkerSets; i++ )
+    {
+        // name, marker count, markers
+        int nMarkers = 0;
+        if( !check.skipString() || !check.readCount( nMarkers ) || !check.skipRecords( nMarkers, 12 ) )
+        {
+            return false;
+        }
+    }
+    return check.endSection( Layout::sectionSizes );
+}
+
+template <typename Layout>
+bool CheckLegacyOtherMarkers( BoundsCheck& check )
+{
+    int nOtherMarkers = 0;
+    return check.beginSection( nOtherMarkers, Layout::sectionSizes )
+        && check.skipRecords( nOtherMarkers, 12 )
+        && check.endSection( Layout::sectionSizes );
+}
+
+template <typename Layout>
+bool CheckRigidBodies( BoundsCheck& check )
+{
+    // mean error and params follow the pose (and the marker block before NatNet 3.0)
+    const int tailBytes = ( Layout::rigidBodyError ? 4 : 0 ) + ( Layout::params ? 2 : 0 );
+
+    int nRigidBodies = 0;
+    if( !check.beginSection( nRigidBodies, Layout::sectionSizes ) )
+    {
+        return false;
+    }
+    if( Layout::rigidBodyMarkers )
+    {
+        for( int i = 0; i < nRigidBodies; i++ )
+        {
+            int nRigidMarkers = 0;
+            if( !check.skip( 32 ) || !check.readCount( nRigidMarkers )
+                || !check.skipRecords( nRigidMarkers, Layout::rigidBodyMarkerBytes ) || !check.skip( tailBytes ) )
+            {
+                return false;
+            }
+        }
+    }
+    else if( !check.skipRecords( nRigidBodies, 32 + tailBytes ) )
+    {
+        return false;
+    }
+    return check.endSection( Layout::sectionSizes );
+}
+
+template <typename Layout>
+bool CheckSkeletons( BoundsCheck& check )
+{
+    if( !Layout::skeletons )
+    {
+        return true;
+    }
+
+    const int boneBytes = 32 + ( Layout::boneError ? 4 : 0 ) + ( Layout::params ? 2 : 0 );
+
+    int nSkeletons = 0;
+    if( !check.beginSection( nSkeletons, Layout::sectionSizes ) )
+    {
+        return false;
+    }
+    for( int i = 0; i < nSkeletons; i++ )
+    {
+        // id, bone count, bones
+        int nRigidBodies = 0;
+        if( !check.skip( 4 ) || !check.readCount( nRigidBodies ) || !check.skipRecords( nRigidBodies, boneBytes ) )
+        {
+            return false;
+        }
+    }
+    return check.endSection( Layout::sectionSizes );
+}
+
+template <typename Layout>
+bool CheckAssets( BoundsCheck& check )
+{
+    if( !Layout::assets )
+    {
+        return true;
+    }
+
+    int nAssets = 0;
+    if( !check.beginSection( nAssets, Layout::sectionSizes ) )
+    {
+        return false;
+    }
+    for( int i = 0; i < nAssets; i++ )
+    {
+        // id, rigid body count, rigid bodies, marker count, markers
+        int nRigidBodies = 0;
+        int nMarkers = 0;
+        if( !check.skip( 4 ) || !check.readCount( nRigidBodies ) || !check.skipRecords( nRigidBodies, 38 )
+            || !check.readCount( nMarkers ) || !check.skipRecords( nMarkers, 26 ) )
+        {
+            return false;
+        }
+    }
+    return check.endSection( Layout::sectionSizes );
+}
+
+template <typename Layout>
+bool CheckLabeledMarkers( BoundsCheck& check )
+{
+    if( !Layout::labeledMarkers )
+    {
+        return true;
+    }
+
+    int nLabeledMarkers = 0;
+    return check.beginSection( nLabeledMarkers, Layout::sectionSizes )
+        && check.skipRecords( nLabeledMarkers, Layout::labeledMarkerBytes )
+        && check.endSection( Layout::sectionSizes );
+}
+
+/**
+ * \brief Force plates and devices share one layout
+*/
+template <typename Layout>
+bool CheckAnalogSection( BoundsCheck& check, bool present )
+{
+    if( !present )
+    {
+        return true;
+    }
+
+    int nDevices = 0;
+    if( !check.beginSection( nDevices, Layout::sectionSizes ) )
+    {
+        return false;
+    }
+    for( int i = 0; i < nDevices; i++ )
+    {
+        // id, channel count, channels ( frame count, frames )
+        int nChannels = 0;
+        if( !check.skip( 4 ) || !check.readCount( nChannels ) )
+        {
+            return false;
+        }
+        for( int j = 0; j < nChannels; j++ )
+        {
+            int nFrames = 0;
+            if( !check.readCount( nFrames ) || !check.skipRecords( nFrames, 4 ) )
+            {
+                return false;
+            }
+        }
+    }
+    return check.endSection( Layout::sectionSizes );
+}
+
+/**
+ * \brief Size of the fields that follow the last section
+*/
+template <typename Layout>
+constexpr int FrameSuffixBytes()
+{
+    return ( Layout::softwareLatency ? 4 : 0 )
+        + 8                                             // timecode, subframe
+        + ( Layout::doubleTimestamp ? 8 : 4 )
+        + ( Layout::highResTimestamps ? 24 : 0 )
+        + ( Layout::precisionTimestamps ? 8 : 0 )
+        + 2                                             // params
+        + 4;                                            // end of data tag
+}
+
+/**
+ * \brief Validate a NAT_FRAMEOFDATA payload laid out as Layout
+ * \param inptr - input data stream pointer (after the packet header)
+ * \param nBytes - number of payload bytes available
+ * \return - DecodeStatus_OK if every section fits into nBytes
+*/
+template <typename Layout>
+DecodeStatus ValidateFrame( const char* inptr, int nBytes )
+{
+    if( nBytes < 0 )
+    {
+        return DecodeStatus_Truncated;
+    }
+
+    BoundsCheck check( inptr, inptr + nBytes );
+    bool valid = check.skip( 4 )                           // frame number
+        && CheckMarkerSets<Layout>( check )
+        && CheckLegacyOtherMarkers<Layout>( check )
+        && CheckRigidBodies<Layout>( check )
+        && CheckSkeletons<Layout>( check )
+        && CheckAssets<Layout>( check )
+        && CheckLabeledMarkers<Layout>( check )
+        && CheckAnalogSection<Layout>( check, Layout::forcePlates )
+        && CheckAnalogSection<Layout>( check, Layout::devices )
+        && check.skip( FrameSuffixBytes<Layout>() );
+    return valid ? DecodeStatus_OK : check.status();
+}
+
+template <typename Layout>
+struct SelectValidator
+{
+    static FrameValidator get() { return &ValidateFrame<Layout>; }
+};
+
+} // namespace
+
+/**
+ * \brief Check that a received datagram holds the payload its header announces
+ * \param packet - received datagram
+ * \param length - number of bytes received
+ * \return - DecodeStatus_OK, or DecodeStatus_Truncated
+*/
+DecodeStatus ValidatePacket( const char* packet, int length )
+{
+    if( length < 4 )
+    {
+        return DecodeStatus_Truncated;
+    }
+    int messageID = 0;
+    int nBytes = 0;
+    int nBytesTotal = 0;
+    UnpackPacketHeader( packet, messageID, nBytes, nBytesTotal );
+    return ( nBytesTotal <= length ) ? DecodeStatus_OK : DecodeStatus_Truncated;
+}
+
+/**
+ * \brief Check every count and section size of a NAT_FRAMEOFDATA payload
+ * against the bytes available, without decoding it
+ * \param inptr - input data stream pointer (after the packet header)
+ * \param nBytes - number of payload bytes available
+ * \param major - NatNet major version
+ * \param minor - NatNet minor version
+ * \return - DecodeStatus_OK if the frame can be decoded safely
+*/
+DecodeStatus ValidateFrameData( const char* inptr, int nBytes, int major, int minor )
+{
+    return SelectFrameValidator( major, minor )( inptr, nBytes );
+}
+
+/**
+ * \brief Frame validator compiled for the layout of a version
+ * \param major - NatNet major version
+ * \param minor - NatNet minor version
+ * \return - validator
+*/
+FrameValidator SelectFrameValidator( int major, int minor )
+{
+    return DispatchLayout<SelectValidator>( major, minor );
+}
+
+/**
+ * \brief Printable name of a DecodeStatus
+*/
+const char* DecodeStatusString( DecodeStatus status )
+{
+    switch( status )
+    {
+    case DecodeStatus_OK: return "OK";
+    case DecodeStatus_Truncated: return "truncated";
+    case DecodeStatus_InvalidCount: return "invalid count";
+    case DecodeStatus_InvalidSectionSize: return "invalid section size";
+    default: return "unknown";
+    }
+}
+
+} // namespace natnet
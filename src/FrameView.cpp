@@ -0,0 +1,392 @@
+/**
+ * \file   FrameView.cpp
+ * \brief  Single pass indexing of NAT_FRAMEOFDATA payloads.
+ */
+
+#include "FrameView.h"
+#include "FrameLayout.h"
+#include "FrameWalk.h"
+
+#include <algorithm>
+
+namespace natnet
+{
+
+using detail::Load;
+
+namespace
+{
+
+typedef const char* ( *SectionWalker )( const char* ptr );
+
+// The FrameLayout of a version as runtime values, and the FrameWalk.h
+// walkers instantiated for it, for the view that serves every version with
+// one parser
+struct LayoutFlags
+{
+    const char* ( *readSectionHeader )( const char* ptr, int& count );
+    SectionWalker skipMarkerSets;
+    SectionWalker skipOtherMarkers;
+    SectionWalker skipRigidBodies;
+    SectionWalker skipSkeletons;
+    SectionWalker skipAssets;
+    SectionWalker skipLabeledMarkers;
+    SectionWalker skipForcePlates;
+    SectionWalker skipDevices;
+    bool sectionSizes;
+    bool skeletons;
+    bool assets;
+    bool labeledMarkers;
+    bool forcePlates;
+    bool devices;
+    bool rigidBodyMarkers;
+    int rigidBodyMarkerBytes;
+    bool rigidBodyError;
+    bool boneError;
+    bool params;
+    bool markerResidual;
+    int labeledMarkerBytes;
+    bool softwareLatency;
+    bool doubleTimestamp;
+    bool highResTimestamps;
+    bool precisionTimestamps;
+};
+
+template <typename Layout>
+struct SelectLayoutFlags
+{
+    static LayoutFlags get()
+    {
+        LayoutFlags flags;
+        flags.readSectionHeader = &ReadSectionHeader<Layout>;
+        flags.skipMarkerSets = &SkipMarkerSets<Layout>;
+        flags.skipOtherMarkers = &SkipOtherMarkers<Layout>;
+        flags.skipRigidBodies = &SkipRigidBodies<Layout>;
+        flags.skipSkeletons = &SkipSkeletons<Layout>;
+        flags.skipAssets = &SkipAssets<Layout>;
+        flags.skipLabeledMarkers = &SkipLabeledMarkers<Layout>;
+        flags.skipForcePlates = &SkipForcePlates<Layout>;
+        flags.skipDevices = &SkipDevices<Layout>;
+        flags.sectionSizes = Layout::sectionSizes;
+        flags.skeletons = Layout::skeletons;
+        flags.assets = Layout::assets;
+        flags.labeledMarkers = Layout::labeledMarkers;
+        flags.forcePlates = Layout::forcePlates;
+        flags.devices = Layout::devices;
+        flags.rigidBodyMarkers = Layout::rigidBodyMarkers;
+        flags.rigidBodyMarkerBytes = Layout::rigidBodyMarkerBytes;
+        flags.rigidBodyError = Layout::rigidBodyError;
+        flags.boneError = Layout::boneError;
+        flags.params = Layout::params;
+        flags.markerResidual = Layout::markerResidual;
+        flags.labeledMarkerBytes = Layout::labeledMarkerBytes;
+        flags.softwareLatency = Layout::softwareLatency;
+        flags.doubleTimestamp = Layout::doubleTimestamp;
+        flags.highResTimestamps = Layout::highResTimestamps;
+        flags.precisionTimestamps = Layout::precisionTimestamps;
+        return flags;
+    }
+};
+
+} // namespace
+
+FrameView::FrameView()
+    : data_( nullptr )
+    , rigidBodyMarkers_( false )
+    , rigidBodyMarkerBytes_( 0 )
+    , rigidBodyError_( false )
+    , rigidBodyParams_( false )
+    , boneStride_( 0 )
+    , boneError_( false )
+    , boneParams_( false )
+    , labeledMarkerStride_( 0 )
+    , markerParams_( false )
+    , markerResidual_( false )
+    , doubleTimestamp_( false )
+    , otherMarkersOffset_( 0 )
+    , nOtherMarkers_( 0 )
+    , rigidBodiesOffset_( 0 )
+    , rigidBodyStride_( 0 )
+    , nRigidBodies_( 0 )
+    , labeledMarkersOffset_( 0 )
+    , nLabeledMarkers_( 0 )
+    , timecodeOffset_( 0 )
+    , timestampOffset_( 0 )
+    , highResOffset_( -1 )
+    , precisionOffset_( -1 )
+    , paramsOffset_( 0 )
+{
+}
+
+const char* FrameView::parse( const char* inptr, int nBytes, int major, int minor, uint32_t sections )
+{
+    data_ = inptr;
+
+    // Record layout, as the decoders see it (FrameLayout.h)
+    const LayoutFlags layout = DispatchLayout<SelectLayoutFlags>( major, minor );
+    bool hasSectionSizes = layout.sectionSizes;
+    rigidBodyMarkers_ = layout.rigidBodyMarkers;
+    rigidBodyMarkerBytes_ = layout.rigidBodyMarkerBytes;
+    rigidBodyError_ = layout.rigidBodyError;
+    rigidBodyParams_ = layout.params;
+    boneError_ = layout.boneError;
+    boneParams_ = layout.params;
+    boneStride_ = 32 + ( boneError_ ? 4 : 0 ) + ( boneParams_ ? 2 : 0 );
+    markerParams_ = layout.params;
+    markerResidual_ = layout.markerResidual;
+    labeledMarkerStride_ = layout.labeledMarkerBytes;
+    rigidBodyStride_ = rigidBodyMarkers_ ? 0 : 32 + ( rigidBodyError_ ? 4 : 0 ) + ( rigidBodyParams_ ? 2 : 0 );
+    doubleTimestamp_ = layout.doubleTimestamp;
+
+    markerSetOffsets_.clear();
+    rigidBodyOffsets_.clear();
+    skeletonOffsets_.clear();
+    assetOffsets_.clear();
+    forcePlateOffsets_.clear();
+    deviceOffsets_.clear();
+    nOtherMarkers_ = 0;
+    nRigidBodies_ = 0;
+    nLabeledMarkers_ = 0;
+
+    // frame number
+    const char* ptr = inptr + 4;
+
+    // Unsubscribed sections are jumped over using their size when the stream
+    // carries one, and stepped over unrecorded otherwise (see FrameWalk.h)
+    auto skipped = [&]( uint32_t section ) { return !( sections & section ); };
+    auto skip = [&]( SectionWalker walk ) { return hasSectionSizes ? SkipFrameSection( ptr, major, minor ) : walk( ptr ); };
+
+    // markersets
+    int count = 0;
+    if( skipped( FrameSection_MarkerSets ) )
+    {
+        ptr = skip( layout.skipMarkerSets );
+    }
+    else
+    {
+        ptr = layout.readSectionHeader( ptr, count );
+        for( int i = 0; i < count; i++ )
+        {
+            markerSetOffsets_.push_back( (uint32_t) ( ptr - data_ ) );
+            ptr += strlen( ptr ) + 1;
+            int nMarkers = std::max( 0, Load<int32_t>( ptr ) ); ptr += 4;
+            ptr += nMarkers * 12;
+        }
+    }
+
+    // legacy other markers
+    if( skipped( FrameSection_LegacyOtherMarkers ) )
+    {
+        ptr = skip( layout.skipOtherMarkers );
+    }
+    else
+    {
+        ptr = layout.readSectionHeader( ptr, count );
+        otherMarkersOffset_ = (int) ( ptr - data_ );
+        ptr += count * 12;
+        nOtherMarkers_ = count;
+    }
+
+    // rigid bodies
+    if( skipped( FrameSection_RigidBodies ) )
+    {
+        ptr = skip( layout.skipRigidBodies );
+    }
+    else
+    {
+        ptr = layout.readSectionHeader( ptr, count );
+        rigidBodiesOffset_ = (int) ( ptr - data_ );
+        if( rigidBodyStride_ > 0 )
+        {
+            ptr += count * rigidBodyStride_;
+        }
+        else
+        {
+            for( int i = 0; i < count; i++ )
+            {
+                rigidBodyOffsets_.push_back( (uint32_t) ( ptr - data_ ) );
+                ptr += 32;
+                int nRigidMarkers = std::max( 0, Load<int32_t>( ptr ) ); ptr += 4;
+                ptr += nRigidMarkers * rigidBodyMarkerBytes_;
+                ptr += ( rigidBodyError_ ? 4 : 0 ) + ( rigidBodyParams_ ? 2 : 0 );
+            }
+        }
+        nRigidBodies_ = count;
+    }
+
+    // skeletons (NatNet 2.1 and later)
+    if( layout.skeletons )
+    {
+        if( skipped( FrameSection_Skeletons ) )
+        {
+            ptr = skip( layout.skipSkeletons );
+        }
+        else
+        {
+            ptr = layout.readSectionHeader( ptr, count );
+            for( int i = 0; i < count; i++ )
+            {
+                skeletonOffsets_.push_back( (uint32_t) ( ptr - data_ ) );
+                int nBones = std::max( 0, Load<int32_t>( ptr + 4 ) );
+                ptr += 8 + nBones * boneStride_;
+            }
+        }
+    }
+
+    // assets (NatNet 4.1 and later, always sized)
+    if( layout.assets )
+    {
+        if( skipped( FrameSection_Assets ) )
+        {
+            ptr = skip( layout.skipAssets );
+        }
+        else
+        {
+            ptr = layout.readSectionHeader( ptr, count );
+            for( int i = 0; i < count; i++ )
+            {
+                assetOffsets_.push_back( (uint32_t) ( ptr - data_ ) );
+                int nRigidBodies = std::max( 0, Load<int32_t>( ptr + 4 ) );
+                ptr += 8 + nRigidBodies * AssetView::kRigidBodyStride;
+                int nMarkers = std::max( 0, Load<int32_t>( ptr ) );
+                ptr += 4 + nMarkers * AssetView::kMarkerStride;
+            }
+        }
+    }
+
+    // labeled markers (NatNet 2.3 and later)
+    if( layout.labeledMarkers )
+    {
+        if( skipped( FrameSection_LabeledMarkers ) )
+        {
+            ptr = skip( layout.skipLabeledMarkers );
+        }
+        else
+        {
+            ptr = layout.readSectionHeader( ptr, count );
+            labeledMarkersOffset_ = (int) ( ptr - data_ );
+            ptr += count * labeledMarkerStride_;
+            nLabeledMarkers_ = count;
+        }
+    }
+
+    // force plates (NatNet 2.9 and later)
+    if( layout.forcePlates )
+    {
+        if( skipped( FrameSection_ForcePlates ) )
+        {
+            ptr = skip( layout.skipForcePlates );
+        }
+        else
+        {
+            ptr = layout.readSectionHeader( ptr, count );
+            for( int i = 0; i < count; i++ )
+            {
+                forcePlateOffsets_.push_back( (uint32_t) ( ptr - data_ ) );
+                ptr = SkipAnalogRecord( ptr );
+            }
+        }
+    }
+
+    // devices (NatNet 2.11 and later)
+    if( layout.devices )
+    {
+        if( skipped( FrameSection_Devices ) )
+        {
+            ptr = skip( layout.skipDevices );
+        }
+        else
+        {
+            ptr = layout.readSectionHeader( ptr, count );
+            for( int i = 0; i < count; i++ )
+            {
+                deviceOffsets_.push_back( (uint32_t) ( ptr - data_ ) );
+                ptr = SkipAnalogRecord( ptr );
+            }
+        }
+    }
+
+    // suffix
+    if( layout.softwareLatency )
+    {
+        ptr += 4;   // software latency
+    }
+    timecodeOffset_ = (int) ( ptr - data_ );
+    ptr += 8;
+    timestampOffset_ = (int) ( ptr - data_ );
+    ptr += doubleTimestamp_ ? 8 : 4;
+    highResOffset_ = -1;
+    if( layout.highResTimestamps )
+    {
+        highResOffset_ = (int) ( ptr - data_ );
+        ptr += 24;
+    }
+    precisionOffset_ = -1;
+    if( layout.precisionTimestamps )
+    {
+        precisionOffset_ = (int) ( ptr - data_ );
+        ptr += 8;
+    }
+    paramsOffset_ = (int) ( ptr - data_ );
+    ptr += 2 + 4;   // params, end of data tag
+
+    // the counts said more than the payload holds
+    if( ptr > inptr + nBytes )
+    {
+        return nullptr;
+    }
+    return ptr;
+}
+
+MarkerSetView FrameView::markerSet( int i ) const
+{
+    const char* name = data_ + markerSetOffsets_[i];
+    const char* ptr = name + strlen( name ) + 1;
+    return MarkerSetView( name, ptr + 4, std::max( 0, Load<int32_t>( ptr ) ) );
+}
+
+RigidBodyView FrameView::rigidBody( int i ) const
+{
+    if( rigidBodyStride_ > 0 )
+    {
+        const char* record = data_ + rigidBodiesOffset_ + i * rigidBodyStride_;
+        return RigidBodyView( record, record + 32, rigidBodyError_, rigidBodyParams_ );
+    }
+
+    // before NatNet 3.0 the mean error follows the rigid body's marker block
+    const char* record = data_ + rigidBodyOffsets_[i];
+    int nRigidMarkers = std::max( 0, Load<int32_t>( record + 32 ) );
+    const char* tail = record + 36 + nRigidMarkers * rigidBodyMarkerBytes_;
+    return RigidBodyView( record, tail, rigidBodyError_, rigidBodyParams_ );
+}
+
+/**
+ * \brief Index of the rigid body with the given streaming ID
+ * \param id - streaming ID
+ * \return - index for rigidBody(), -1 if the frame does not contain it
+*/
+int FrameView::findRigidBody( int32_t id ) const
+{
+    for( int i = 0; i < nRigidBodies_; i++ )
+    {
+        const char* record = ( rigidBodyStride_ > 0 ) ? data_ + rigidBodiesOffset_ + i * rigidBodyStride_
+                                                       : data_ + rigidBodyOffsets_[i];
+        if( Load<int32_t>( record ) == id )
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+double FrameView::timestamp() const
+{
+    // NatNet version 2.7 and later - increased from single to double precision
+    if( doubleTimestamp_ )
+    {
+        return Load<double>( data_ + timestampOffset_ );
+    }
+    return (double) Load<float>( data_ + timestampOffset_ );
+}
+
+} // namespace natnet
@@ -0,0 +1,333 @@
+/**
+ * \file   FrameView.h
+ * \brief  Zero-copy access to a NAT_FRAMEOFDATA payload.
+ * FrameView::parse walks the payload once and records where every section
+ * (and every variable length record) starts. The accessors then read the
+ * requested fields straight out of the receive buffer, so a consumer that
+ * only looks at a few rigid bodies does not pay for decoding the rest of
+ * the frame. The buffer must outlive the view and any view derived from it.
+ *
+ * parse() trusts the counts in the payload and reads wherever they lead; it
+ * only checks afterwards that the frame ended within nBytes. Run
+ * ValidateFrameData (or FrameDecoder with validation) on payloads from the
+ * network before viewing them.
+ */
+
+#pragma once
+
+#include "NatNetDecoder.h"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace natnet
+{
+
+struct Vec3
+{
+    float x, y, z;
+};
+
+struct Quat
+{
+    float qx, qy, qz, qw;
+};
+
+namespace detail
+{
+
+template <typename T>
+inline T Load( const char* ptr )
+{
+    T value;
+    memcpy( &value, ptr, sizeof( T ) );
+    return value;
+}
+
+} // namespace detail
+
+/**
+ * \brief Rigid body record (top level, skeleton bone or asset member)
+ */
+class RigidBodyView
+{
+public:
+    RigidBodyView( const char* record, const char* tail, bool hasError, bool hasParams )
+        : record_( record ), tail_( tail ), hasError_( hasError ), hasParams_( hasParams )
+    {
+    }
+
+    int32_t id() const { return detail::Load<int32_t>( record_ ); }
+    Vec3 position() const { return detail::Load<Vec3>( record_ + 4 ); }
+    Quat orientation() const { return detail::Load<Quat>( record_ + 16 ); }
+    float meanError() const { return hasError_ ? detail::Load<float>( tail_ ) : 0.0f; }
+    int16_t params() const { return hasParams_ ? detail::Load<int16_t>( tail_ + ( hasError_ ? 4 : 0 ) ) : 0; }
+    bool trackingValid() const { return ( params() & 0x01 ) != 0; }
+
+private:
+    const char* record_;
+    const char* tail_;      // mean error / params, after the legacy marker block if any
+    bool hasError_;
+    bool hasParams_;
+};
+
+/**
+ * \brief Labeled marker or asset marker record
+ */
+class MarkerView
+{
+public:
+    MarkerView( const char* record, bool hasParams, bool hasResidual )
+        : record_( record ), hasParams_( hasParams ), hasResidual_( hasResidual )
+    {
+    }
+
+    int32_t id() const { return detail::Load<int32_t>( record_ ); }
+    Vec3 position() const { return detail::Load<Vec3>( record_ + 4 ); }
+    float size() const { return detail::Load<float>( record_ + 16 ); }
+    int16_t params() const { return hasParams_ ? detail::Load<int16_t>( record_ + 20 ) : 0; }
+    float residual() const { return hasResidual_ ? detail::Load<float>( record_ + ( hasParams_ ? 22 : 20 ) ) : 0.0f; }
+
+private:
+    const char* record_;
+    bool hasParams_;
+    bool hasResidual_;
+};
+
+/**
+ * \brief Named markerset; name() points into the receive buffer
+ */
+class MarkerSetView
+{
+public:
+    MarkerSetView( const char* name, const char* markers, int nMarkers )
+        : name_( name ), markers_( markers ), nMarkers_( nMarkers )
+    {
+    }
+
+    const char* name() const { return name_; }
+    int markerCount() const { return nMarkers_; }
+    Vec3 marker( int i ) const { return detail::Load<Vec3>( markers_ + i * 12 ); }
+
+private:
+    const char* name_;
+    const char* markers_;
+    int nMarkers_;
+};
+
+/**
+ * \brief Skeleton record; bones are fixed size so rigidBody(k) is O(1)
+ */
+class SkeletonView
+{
+public:
+    SkeletonView( const char* record, int boneStride, bool boneError, bool boneParams )
+        : record_( record ), boneStride_( boneStride ), boneError_( boneError ), boneParams_( boneParams )
+    {
+    }
+
+    int32_t id() const { return detail::Load<int32_t>( record_ ); }
+    int rigidBodyCount() const { return detail::Load<int32_t>( record_ + 4 ); }
+    RigidBodyView rigidBody( int k ) const
+    {
+        const char* bone = record_ + 8 + k * boneStride_;
+        return RigidBodyView( bone, bone + 32, boneError_, boneParams_ );
+    }
+
+private:
+    const char* record_;
+    int boneStride_;
+    bool boneError_;
+    bool boneParams_;
+};
+
+/**
+ * \brief Asset record (NatNet 4.1 and later)
+ */
+class AssetView
+{
+public:
+    static const int kRigidBodyStride = 38;
+    static const int kMarkerStride = 26;
+
+    explicit AssetView( const char* record )
+        : record_( record )
+    {
+    }
+
+    int32_t id() const { return detail::Load<int32_t>( record_ ); }
+    int rigidBodyCount() const { return detail::Load<int32_t>( record_ + 4 ); }
+    RigidBodyView rigidBody( int k ) const
+    {
+        const char* rb = record_ + 8 + k * kRigidBodyStride;
+        return RigidBodyView( rb, rb + 32, true, true );
+    }
+    int markerCount() const { return detail::Load<int32_t>( markers() - 4 ); }
+    MarkerView marker( int k ) const { return MarkerView( markers() + k * kMarkerStride, true, true ); }
+
+private:
+    const char* markers() const { return record_ + 12 + rigidBodyCount() * kRigidBodyStride; }
+
+    const char* record_;
+};
+
+/**
+ * \brief One channel of a force plate or device
+ */
+class AnalogChannelView
+{
+public:
+    explicit AnalogChannelView( const char* record )
+        : record_( record )
+    {
+    }
+
+    int frameCount() const { return detail::Load<int32_t>( record_ ); }
+    float value( int j ) const { return detail::Load<float>( record_ + 4 + j * 4 ); }
+
+private:
+    const char* record_;
+};
+
+/**
+ * \brief Force plate or device record.
+ * Channels carry their own frame count, so channel(i) walks the preceding
+ * channels; plates and devices have few channels.
+ */
+class AnalogDataView
+{
+public:
+    explicit AnalogDataView( const char* record )
+        : record_( record )
+    {
+    }
+
+    int32_t id() const { return detail::Load<int32_t>( record_ ); }
+    int channelCount() const { return detail::Load<int32_t>( record_ + 4 ); }
+    AnalogChannelView channel( int i ) const
+    {
+        const char* ptr = record_ + 8;
+        for( int c = 0; c < i; c++ )
+        {
+            ptr += 4 + detail::Load<int32_t>( ptr ) * 4;
+        }
+        return AnalogChannelView( ptr );
+    }
+
+private:
+    const char* record_;
+};
+
+typedef AnalogDataView ForcePlateView;
+typedef AnalogDataView DeviceView;
+
+/**
+ * \brief Index over a NAT_FRAMEOFDATA payload.
+ * A FrameView can be reused for every frame of a stream; its offset tables
+ * keep their capacity, so steady state parsing does not allocate.
+ */
+class FrameView
+{
+public:
+    FrameView();
+
+    /**
+     * \brief Index a frame payload in place.
+     * Counts are trusted; check payloads from the network with ValidateFrameData first.
+     * \param inptr - payload pointer (after the packet header)
+     * \param nBytes - payload size
+     * \param major - NatNet major version
+     * \param minor - NatNet minor version
+     * \param sections - FrameSection mask of the sections to index, the others read as empty
+     * \return - pointer after the frame, nullptr if the frame does not end within nBytes
+    */
+    const char* parse( const char* inptr, int nBytes, int major, int minor, uint32_t sections = FrameSection_All );
+
+    int32_t frameNumber() const { return detail::Load<int32_t>( data_ ); }
+
+    int markerSetCount() const { return (int) markerSetOffsets_.size(); }
+    MarkerSetView markerSet( int i ) const;
+
+    int otherMarkerCount() const { return nOtherMarkers_; }
+    Vec3 otherMarker( int i ) const { return detail::Load<Vec3>( data_ + otherMarkersOffset_ + i * 12 ); }
+
+    int rigidBodyCount() const { return nRigidBodies_; }
+    RigidBodyView rigidBody( int i ) const;
+    int findRigidBody( int32_t id ) const;
+
+    int skeletonCount() const { return (int) skeletonOffsets_.size(); }
+    SkeletonView skeleton( int i ) const
+    {
+        return SkeletonView( data_ + skeletonOffsets_[i], boneStride_, boneError_, boneParams_ );
+    }
+
+    int assetCount() const { return (int) assetOffsets_.size(); }
+    AssetView asset( int i ) const { return AssetView( data_ + assetOffsets_[i] ); }
+
+    int labeledMarkerCount() const { return nLabeledMarkers_; }
+    MarkerView labeledMarker( int i ) const
+    {
+        return MarkerView( data_ + labeledMarkersOffset_ + i * labeledMarkerStride_, markerParams_, markerResidual_ );
+    }
+
+    int forcePlateCount() const { return (int) forcePlateOffsets_.size(); }
+    ForcePlateView forcePlate( int i ) const { return ForcePlateView( data_ + forcePlateOffsets_[i] ); }
+
+    int deviceCount() const { return (int) deviceOffsets_.size(); }
+    DeviceView device( int i ) const { return DeviceView( data_ + deviceOffsets_[i] ); }
+
+    uint32_t timecode() const { return detail::Load<uint32_t>( data_ + timecodeOffset_ ); }
+    uint32_t timecodeSubframe() const { return detail::Load<uint32_t>( data_ + timecodeOffset_ + 4 ); }
+    double timestamp() const;
+    uint64_t cameraMidExposureTimestamp() const { return LoadOptional<uint64_t>( highResOffset_, 0 ); }
+    uint64_t cameraDataReceivedTimestamp() const { return LoadOptional<uint64_t>( highResOffset_, 8 ); }
+    uint64_t transmitTimestamp() const { return LoadOptional<uint64_t>( highResOffset_, 16 ); }
+    uint32_t precisionTimestampSecs() const { return LoadOptional<uint32_t>( precisionOffset_, 0 ); }
+    uint32_t precisionTimestampFractionalSecs() const { return LoadOptional<uint32_t>( precisionOffset_, 4 ); }
+    int16_t params() const { return detail::Load<int16_t>( data_ + paramsOffset_ ); }
+
+private:
+    template <typename T>
+    T LoadOptional( int offset, int field ) const
+    {
+        return ( offset < 0 ) ? T( 0 ) : detail::Load<T>( data_ + offset + field );
+    }
+
+    const char* data_;
+
+    // record layout for this version
+    bool rigidBodyMarkers_;
+    int rigidBodyMarkerBytes_;
+    bool rigidBodyError_;
+    bool rigidBodyParams_;
+    int boneStride_;
+    bool boneError_;
+    bool boneParams_;
+    int labeledMarkerStride_;
+    bool markerParams_;
+    bool markerResidual_;
+    bool doubleTimestamp_;
+
+    // section offsets, relative to data_
+    std::vector<uint32_t> markerSetOffsets_;
+    int otherMarkersOffset_;
+    int nOtherMarkers_;
+    int rigidBodiesOffset_;
+    int rigidBodyStride_;                       // 0 before NatNet 3.0, see rigidBodyOffsets_
+    int nRigidBodies_;
+    std::vector<uint32_t> rigidBodyOffsets_;
+    std::vector<uint32_t> skeletonOffsets_;
+    std::vector<uint32_t> assetOffsets_;
+    int labeledMarkersOffset_;
+    int nLabeledMarkers_;
+    std::vector<uint32_t> forcePlateOffsets_;
+    std::vector<uint32_t> deviceOffsets_;
+    int timecodeOffset_;
+    int timestampOffset_;
+    int highResOffset_;                         // -1 when absent
+    int precisionOffset_;                       // -1 when absent
+    int paramsOffset_;
+};
+
+} // namespace natnet
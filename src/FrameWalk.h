@@ -0,0 +1,198 @@
+/**
+ * \file   FrameWalk.h
+ * \brief  Step over NAT_FRAMEOFDATA sections without decoding them.
+ * Streams before NatNet 4.1 carry no section sizes, so a section that is not
+ * subscribed still has to be walked to find the next one. These walkers only
+ * advance the pointer: sections of fixed size records are stepped over in one
+ * stride, the others are walked by their counts. Like the decoders they trust
+ * the counts in the packet; run ValidateFrameData first on untrusted input.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+
+namespace natnet
+{
+
+/**
+ * \brief Read a section count and step over the NatNet 4.1 section size
+ * \param ptr - pointer to the section count
+ * \param count - output count, negative counts read as 0
+ * \return - pointer to the first record of the section
+*/
+template <typename Layout>
+const char* ReadSectionHeader( const char* ptr, int& count )
+{
+    memcpy( &count, ptr, 4 ); ptr += 4;
+    count = std::max( 0, count );
+    return Layout::sectionSizes ? ptr + 4 : ptr;
+}
+
+/**
+ * \brief Skip a markerset section (name and marker count per set)
+ * \param ptr - pointer to the section count
+ * \return - pointer after the section
+*/
+template <typename Layout>
+const char* SkipMarkerSets( const char* ptr )
+{
+    int count = 0;
+    ptr = ReadSectionHeader<Layout>( ptr, count );
+    for( int i = 0; i < count; i++ )
+    {
+        ptr += strlen( ptr ) + 1;
+        int nMarkers = 0; memcpy( &nMarkers, ptr, 4 ); ptr += 4;
+        ptr += std::max( 0, nMarkers ) * 12;
+    }
+    return ptr;
+}
+
+/**
+ * \brief Skip the legacy other markers section
+ * \param ptr - pointer to the section count
+ * \return - pointer after the section
+*/
+template <typename Layout>
+const char* SkipOtherMarkers( const char* ptr )
+{
+    int count = 0;
+    ptr = ReadSectionHeader<Layout>( ptr, count );
+    return ptr + count * 12;
+}
+
+/**
+ * \brief Skip the rigid body section; walked per body only while bodies carry their markers (before 3.0)
+ * \param ptr - pointer to the section count
+ * \return - pointer after the section
+*/
+template <typename Layout>
+const char* SkipRigidBodies( const char* ptr )
+{
+    const int kRecordBytes = 32 + ( Layout::rigidBodyError ? 4 : 0 ) + ( Layout::params ? 2 : 0 );
+    int count = 0;
+    ptr = ReadSectionHeader<Layout>( ptr, count );
+    if( !Layout::rigidBodyMarkers )
+    {
+        return ptr + count * kRecordBytes;
+    }
+    for( int i = 0; i < count; i++ )
+    {
+        int nRigidMarkers = 0; memcpy( &nRigidMarkers, ptr + 32, 4 );
+        ptr += kRecordBytes + 4 + std::max( 0, nRigidMarkers ) * Layout::rigidBodyMarkerBytes;
+    }
+    return ptr;
+}
+
+/**
+ * \brief Skip the skeleton section (ID and bone count per skeleton, fixed size bones)
+ * \param ptr - pointer to the section count
+ * \return - pointer after the section
+*/
+template <typename Layout>
+const char* SkipSkeletons( const char* ptr )
+{
+    if( !Layout::skeletons )
+    {
+        return ptr;
+    }
+    const int kBoneBytes = 32 + ( Layout::boneError ? 4 : 0 ) + ( Layout::params ? 2 : 0 );
+    int count = 0;
+    ptr = ReadSectionHeader<Layout>( ptr, count );
+    for( int i = 0; i < count; i++ )
+    {
+        int nBones = 0; memcpy( &nBones, ptr + 4, 4 );
+        ptr += 8 + std::max( 0, nBones ) * kBoneBytes;
+    }
+    return ptr;
+}
+
+/**
+ * \brief Skip the asset section (NatNet 4.1 and later)
+ * \param ptr - pointer to the section count
+ * \return - pointer after the section
+*/
+template <typename Layout>
+const char* SkipAssets( const char* ptr )
+{
+    if( !Layout::assets )
+    {
+        return ptr;
+    }
+    int count = 0;
+    ptr = ReadSectionHeader<Layout>( ptr, count );
+    for( int i = 0; i < count; i++ )
+    {
+        int nRigidBodies = 0; memcpy( &nRigidBodies, ptr + 4, 4 ); ptr += 8;
+        ptr += std::max( 0, nRigidBodies ) * 38;
+        int nMarkers = 0; memcpy( &nMarkers, ptr, 4 ); ptr += 4;
+        ptr += std::max( 0, nMarkers ) * 26;
+    }
+    return ptr;
+}
+
+/**
+ * \brief Skip the labeled marker section
+ * \param ptr - pointer to the section count
+ * \return - pointer after the section
+*/
+template <typename Layout>
+const char* SkipLabeledMarkers( const char* ptr )
+{
+    if( !Layout::labeledMarkers )
+    {
+        return ptr;
+    }
+    int count = 0;
+    ptr = ReadSectionHeader<Layout>( ptr, count );
+    return ptr + count * Layout::labeledMarkerBytes;
+}
+
+/**
+ * \brief Skip one force plate or device record (ID, then channel and subframe counts)
+ * \param ptr - pointer to the record
+ * \return - pointer after the record
+*/
+inline const char* SkipAnalogRecord( const char* ptr )
+{
+    ptr += 4;   // ID
+    int nChannels = 0; memcpy( &nChannels, ptr, 4 ); ptr += 4;
+    for( int c = 0; c < nChannels; c++ )
+    {
+        int nFrames = 0; memcpy( &nFrames, ptr, 4 ); ptr += 4;
+        ptr += std::max( 0, nFrames ) * 4;
+    }
+    return ptr;
+}
+
+/**
+ * \brief Skip a force plate or device section
+ * \param ptr - pointer to the section count
+ * \return - pointer after the section
+*/
+template <typename Layout>
+const char* SkipAnalogSection( const char* ptr )
+{
+    int count = 0;
+    ptr = ReadSectionHeader<Layout>( ptr, count );
+    for( int i = 0; i < count; i++ )
+    {
+        ptr = SkipAnalogRecord( ptr );
+    }
+    return ptr;
+}
+
+template <typename Layout>
+const char* SkipForcePlates( const char* ptr )
+{
+    return Layout::forcePlates ? SkipAnalogSection<Layout>( ptr ) : ptr;
+}
+
+template <typename Layout>
+const char* SkipDevices( const char* ptr )
+{
+    return Layout::devices ? SkipAnalogSection<Layout>( ptr ) : ptr;
+}
+
+} // namespace natnet
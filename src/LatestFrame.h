@@ -0,0 +1,90 @@
+/**
+ * \file   LatestFrame.h
+ * \brief  Triple buffer holding the most recent complete frame.
+ * For consumers that only want the newest frame (e.g. a control loop reading
+ * the current pose) rather than every frame in order. The writer (network
+ * thread) fills writeFrame() in place and publishes it with publish(); the
+ * reader gets the most recently published frame from read(). Each side
+ * exchanges its buffer with the shared middle buffer in a single atomic
+ * exchange, so neither side ever waits for the other and frames the reader
+ * did not get to are simply overwritten.
+ */
+
+#pragma once
+
+#include <atomic>
+
+namespace natnet
+{
+
+template <typename T>
+class LatestFrame
+{
+public:
+    LatestFrame()
+        : writeSlot_( 0 )
+        , pad_()
+        , middle_( 1 )
+        , pad2_()
+        , readSlot_( 2 )
+        , hasFrame_( false )
+    {
+    }
+
+    LatestFrame( const LatestFrame& ) = delete;
+    LatestFrame& operator=( const LatestFrame& ) = delete;
+
+    // Writer
+
+    /**
+     * \brief Frame to fill before the next publish(); it holds the contents of
+     * an older frame
+    */
+    T& writeFrame() { return frames_[writeSlot_]; }
+
+    /**
+     * \brief Make writeFrame() the latest frame
+    */
+    void publish()
+    {
+        writeSlot_ = middle_.exchange( writeSlot_ | kNewFrame, std::memory_order_acq_rel ) & kSlotMask;
+    }
+
+    // Reader
+
+    /**
+     * \brief Latest published frame. It stays valid, and is not written by the
+     * writer, until the next read().
+     * \return - latest frame, nullptr if no frame was published yet
+    */
+    const T* read()
+    {
+        if( middle_.load( std::memory_order_relaxed ) & kNewFrame )
+        {
+            readSlot_ = middle_.exchange( readSlot_, std::memory_order_acq_rel ) & kSlotMask;
+            hasFrame_ = true;
+        }
+        return hasFrame_ ? &frames_[readSlot_] : nullptr;
+    }
+
+    // true if a frame was published since the last read()
+    bool hasNewFrame() const { return ( middle_.load( std::memory_order_relaxed ) & kNewFrame ) != 0; }
+
+    // Every frame of the buffer, for setup and teardown while neither side runs
+    int frameCount() const { return 3; }
+    T& frame( int i ) { return frames_[i]; }
+
+private:
+    static const int kSlotMask = 0x3;
+    static const int kNewFrame = 0x4;   // set in middle_ by publish(), cleared by read()
+
+    T frames_[3];
+    int writeSlot_;                     // writer only
+    char pad_[64];                      // keep the writer and reader state on separate cache lines
+    std::atomic<int> middle_;           // slot index | kNewFrame
+    char pad2_[64];
+    int readSlot_;                      // reader only
+    bool hasFrame_;                     // reader only
+};
+
+} // namespace natnet
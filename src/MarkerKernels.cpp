@@ -0,0 +1,302 @@
+/**
+ * \file   MarkerKernels.cpp
+ * \brief  Scalar, SSE2 and AVX2 marker record kernels.
+ * The vector kernels load whole records with unaligned loads and transpose
+ * them in registers, so they never read past the last record. The AVX2
+ * kernels are compiled with a function level target attribute, the rest of
+ * the library does not require AVX2.
+ */
+
+#include "MarkerKernels.h"
+
+#if defined( __x86_64__ ) || defined( _M_X64 ) || defined( __i386__ ) || defined( _M_IX86 )
+#define NATNET_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined( NATNET_X86 ) && ( defined( __GNUC__ ) || defined( __clang__ ) )
+#define NATNET_TARGET_AVX2 __attribute__( ( target( "avx2" ) ) )
+#else
+#define NATNET_TARGET_AVX2
+#endif
+
+namespace natnet
+{
+
+namespace
+{
+
+const int kMarkerBytes = 26;
+const int kPointBytes = 12;
+
+void UnpackPointsScalar( const char* ptr, int count, PointArrays& points, int first )
+{
+    for( int i = first; i < first + count; i++ )
+    {
+        memcpy( &points.x[i], ptr, 4 ); ptr += 4;
+        memcpy( &points.y[i], ptr, 4 ); ptr += 4;
+        memcpy( &points.z[i], ptr, 4 ); ptr += 4;
+    }
+}
+
+void UnpackMarkersScalar( const char* ptr, int count, MarkerArrays& markers, int first )
+{
+    for( int i = first; i < first + count; i++ )
+    {
+        memcpy( &markers.id[i], ptr, 4 ); ptr += 4;
+        memcpy( &markers.x[i], ptr, 4 ); ptr += 4;
+        memcpy( &markers.y[i], ptr, 4 ); ptr += 4;
+        memcpy( &markers.z[i], ptr, 4 ); ptr += 4;
+        memcpy( &markers.size[i], ptr, 4 ); ptr += 4;
+        memcpy( &markers.params[i], ptr, 2 ); ptr += 2;
+        memcpy( &markers.residual[i], ptr, 4 ); ptr += 4;
+    }
+}
+
+#ifdef NATNET_X86
+
+/*
+ * Points: 4 records are 3 vectors
+ *   a = x0 y0 z0 x1,  b = y1 z1 x2 y2,  c = z2 x3 y3 z3
+ * and each coordinate is gathered with two shuffles per source pair.
+ *
+ * Markers: bytes [0, 16) of a record are id x y z, bytes [10, 26) are 4
+ * words w0..w3 with
+ *   size     = ( w1 >> 16 ) | ( w2 << 16 )
+ *   params   = w2 >> 16 (arithmetic)
+ *   residual = w3
+ * so two loads per record and two 4x4 transposes cover 4 records.
+ */
+
+inline void Transpose4( __m128i& r0, __m128i& r1, __m128i& r2, __m128i& r3 )
+{
+    __m128i t0 = _mm_unpacklo_epi32( r0, r1 );
+    __m128i t1 = _mm_unpacklo_epi32( r2, r3 );
+    __m128i t2 = _mm_unpackhi_epi32( r0, r1 );
+    __m128i t3 = _mm_unpackhi_epi32( r2, r3 );
+    r0 = _mm_unpacklo_epi64( t0, t1 );
+    r1 = _mm_unpackhi_epi64( t0, t1 );
+    r2 = _mm_unpacklo_epi64( t2, t3 );
+    r3 = _mm_unpackhi_epi64( t2, t3 );
+}
+
+inline __m128i Load128( const char* ptr )
+{
+    return _mm_loadu_si128( reinterpret_cast<const __m128i*>( ptr ) );
+}
+
+void UnpackPointsSSE2( const char* ptr, int count, PointArrays& points, int first )
+{
+    int i = 0;
+    for( ; i + 4 <= count; i += 4, ptr += 4 * kPointBytes )
+    {
+        const float* src = reinterpret_cast<const float*>( ptr );
+        __m128 a = _mm_loadu_ps( src );
+        __m128 b = _mm_loadu_ps( src + 4 );
+        __m128 c = _mm_loadu_ps( src + 8 );
+
+        __m128 x = _mm_shuffle_ps( _mm_shuffle_ps( a, a, _MM_SHUFFLE( 0, 3, 0, 0 ) ),
+                                   _mm_shuffle_ps( b, c, _MM_SHUFFLE( 0, 1, 0, 2 ) ), _MM_SHUFFLE( 2, 0, 2, 0 ) );
+        __m128 y = _mm_shuffle_ps( _mm_shuffle_ps( a, b, _MM_SHUFFLE( 0, 0, 0, 1 ) ),
+                                   _mm_shuffle_ps( b, c, _MM_SHUFFLE( 0, 2, 0, 3 ) ), _MM_SHUFFLE( 2, 0, 2, 0 ) );
+        __m128 z = _mm_shuffle_ps( _mm_shuffle_ps( a, b, _MM_SHUFFLE( 0, 1, 0, 2 ) ),
+                                   _mm_shuffle_ps( c, c, _MM_SHUFFLE( 0, 3, 0, 0 ) ), _MM_SHUFFLE( 2, 0, 2, 0 ) );
+
+        _mm_storeu_ps( &points.x[first + i], x );
+        _mm_storeu_ps( &points.y[first + i], y );
+        _mm_storeu_ps( &points.z[first + i], z );
+    }
+    UnpackPointsScalar( ptr, count - i, points, first + i );
+}
+
+void UnpackMarkersSSE2( const char* ptr, int count, MarkerArrays& markers, int first )
+{
+    int i = 0;
+    for( ; i + 4 <= count; i += 4, ptr += 4 * kMarkerBytes )
+    {
+        __m128i id = Load128( ptr );
+        __m128i x = Load128( ptr + kMarkerBytes );
+        __m128i y = Load128( ptr + 2 * kMarkerBytes );
+        __m128i z = Load128( ptr + 3 * kMarkerBytes );
+        Transpose4( id, x, y, z );
+
+        __m128i w0 = Load128( ptr + 10 );
+        __m128i w1 = Load128( ptr + kMarkerBytes + 10 );
+        __m128i w2 = Load128( ptr + 2 * kMarkerBytes + 10 );
+        __m128i w3 = Load128( ptr + 3 * kMarkerBytes + 10 );
+        Transpose4( w0, w1, w2, w3 );
+        __m128i size = _mm_or_si128( _mm_srli_epi32( w1, 16 ), _mm_slli_epi32( w2, 16 ) );
+        __m128i params = _mm_srai_epi32( w2, 16 );
+        params = _mm_packs_epi32( params, params );
+
+        int o = first + i;
+        _mm_storeu_si128( reinterpret_cast<__m128i*>( &markers.id[o] ), id );
+        _mm_storeu_si128( reinterpret_cast<__m128i*>( &markers.x[o] ), x );
+        _mm_storeu_si128( reinterpret_cast<__m128i*>( &markers.y[o] ), y );
+        _mm_storeu_si128( reinterpret_cast<__m128i*>( &markers.z[o] ), z );
+        _mm_storeu_si128( reinterpret_cast<__m128i*>( &markers.size[o] ), size );
+        _mm_storel_epi64( reinterpret_cast<__m128i*>( &markers.params[o] ), params );
+        _mm_storeu_si128( reinterpret_cast<__m128i*>( &markers.residual[o] ), w3 );
+    }
+    UnpackMarkersScalar( ptr, count - i, markers, first + i );
+}
+
+/*
+ * The AVX2 kernels run the SSE2 scheme on 8 records at a time: records
+ * 0-3 in the low and 4-7 in the high 128 bit lane. All shuffles and
+ * unpacks are in-lane, so each lane comes out in record order.
+ */
+
+NATNET_TARGET_AVX2 inline void Transpose4x2( __m256i& r0, __m256i& r1, __m256i& r2, __m256i& r3 )
+{
+    __m256i t0 = _mm256_unpacklo_epi32( r0, r1 );
+    __m256i t1 = _mm256_unpacklo_epi32( r2, r3 );
+    __m256i t2 = _mm256_unpackhi_epi32( r0, r1 );
+    __m256i t3 = _mm256_unpackhi_epi32( r2, r3 );
+    r0 = _mm256_unpacklo_epi64( t0, t1 );
+    r1 = _mm256_unpackhi_epi64( t0, t1 );
+    r2 = _mm256_unpacklo_epi64( t2, t3 );
+    r3 = _mm256_unpackhi_epi64( t2, t3 );
+}
+
+NATNET_TARGET_AVX2 inline __m256i Load2x128( const char* lo, const char* hi )
+{
+    return _mm256_inserti128_si256( _mm256_castsi128_si256( Load128( lo ) ), Load128( hi ), 1 );
+}
+
+NATNET_TARGET_AVX2 inline __m256 Load2x128ps( const float* lo, const float* hi )
+{
+    return _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_loadu_ps( lo ) ), _mm_loadu_ps( hi ), 1 );
+}
+
+NATNET_TARGET_AVX2 void UnpackPointsAVX2( const char* ptr, int count, PointArrays& points, int first )
+{
+    int i = 0;
+    for( ; i + 8 <= count; i += 8, ptr += 8 * kPointBytes )
+    {
+        const float* src = reinterpret_cast<const float*>( ptr );
+        __m256 a = Load2x128ps( src, src + 12 );
+        __m256 b = Load2x128ps( src + 4, src + 16 );
+        __m256 c = Load2x128ps( src + 8, src + 20 );
+
+        __m256 x = _mm256_shuffle_ps( _mm256_shuffle_ps( a, a, _MM_SHUFFLE( 0, 3, 0, 0 ) ),
+                                      _mm256_shuffle_ps( b, c, _MM_SHUFFLE( 0, 1, 0, 2 ) ), _MM_SHUFFLE( 2, 0, 2, 0 ) );
+        __m256 y = _mm256_shuffle_ps( _mm256_shuffle_ps( a, b, _MM_SHUFFLE( 0, 0, 0, 1 ) ),
+                                      _mm256_shuffle_ps( b, c, _MM_SHUFFLE( 0, 2, 0, 3 ) ), _MM_SHUFFLE( 2, 0, 2, 0 ) );
+        __m256 z = _mm256_shuffle_ps( _mm256_shuffle_ps( a, b, _MM_SHUFFLE( 0, 1, 0, 2 ) ),
+                                      _mm256_shuffle_ps( c, c, _MM_SHUFFLE( 0, 3, 0, 0 ) ), _MM_SHUFFLE( 2, 0, 2, 0 ) );
+
+        _mm256_storeu_ps( &points.x[first + i], x );
+        _mm256_storeu_ps( &points.y[first + i], y );
+        _mm256_storeu_ps( &points.z[first + i], z );
+    }
+    UnpackPointsSSE2( ptr, count - i, points, first + i );
+}
+
+NATNET_TARGET_AVX2 void UnpackMarkersAVX2( const char* ptr, int count, MarkerArrays& markers, int first )
+{
+    const int kHi = 4 * kMarkerBytes;
+    int i = 0;
+    for( ; i + 8 <= count; i += 8, ptr += 8 * kMarkerBytes )
+    {
+        __m256i id = Load2x128( ptr, ptr + kHi );
+        __m256i x = Load2x128( ptr + kMarkerBytes, ptr + kHi + kMarkerBytes );
+        __m256i y = Load2x128( ptr + 2 * kMarkerBytes, ptr + kHi + 2 * kMarkerBytes );
+        __m256i z = Load2x128( ptr + 3 * kMarkerBytes, ptr + kHi + 3 * kMarkerBytes );
+        Transpose4x2( id, x, y, z );
+
+        __m256i w0 = Load2x128( ptr + 10, ptr + kHi + 10 );
+        __m256i w1 = Load2x128( ptr + kMarkerBytes + 10, ptr + kHi + kMarkerBytes + 10 );
+        __m256i w2 = Load2x128( ptr + 2 * kMarkerBytes + 10, ptr + kHi + 2 * kMarkerBytes + 10 );
+        __m256i w3 = Load2x128( ptr + 3 * kMarkerBytes + 10, ptr + kHi + 3 * kMarkerBytes + 10 );
+        Transpose4x2( w0, w1, w2, w3 );
+        __m256i size = _mm256_or_si256( _mm256_srli_epi32( w1, 16 ), _mm256_slli_epi32( w2, 16 ) );
+        __m256i params = _mm256_srai_epi32( w2, 16 );
+        params = _mm256_permute4x64_epi64( _mm256_packs_epi32( params, params ), _MM_SHUFFLE( 3, 1, 2, 0 ) );
+
+        int o = first + i;
+        _mm256_storeu_si256( reinterpret_cast<__m256i*>( &markers.id[o] ), id );
+        _mm256_storeu_si256( reinterpret_cast<__m256i*>( &markers.x[o] ), x );
+        _mm256_storeu_si256( reinterpret_cast<__m256i*>( &markers.y[o] ), y );
+        _mm256_storeu_si256( reinterpret_cast<__m256i*>( &markers.z[o] ), z );
+        _mm256_storeu_si256( reinterpret_cast<__m256i*>( &markers.size[o] ), size );
+        _mm_storeu_si128( reinterpret_cast<__m128i*>( &markers.params[o] ), _mm256_castsi256_si128( params ) );
+        _mm256_storeu_si256( reinterpret_cast<__m256i*>( &markers.residual[o] ), w3 );
+    }
+    UnpackMarkersSSE2( ptr, count - i, markers, first + i );
+}
+
+#endif // NATNET_X86
+
+const MarkerKernels kKernels[] =
+{
+    { MarkerKernel_Scalar, "scalar", UnpackPointsScalar, UnpackMarkersScalar },
+#ifdef NATNET_X86
+    { MarkerKernel_SSE2, "sse2", UnpackPointsSSE2, UnpackMarkersSSE2 },
+    { MarkerKernel_AVX2, "avx2", UnpackPointsAVX2, UnpackMarkersAVX2 },
+#endif
+};
+
+} // namespace
+
+/**
+ * \brief Best kernel level supported by this CPU (and operating system)
+ * \return - kernel level
+*/
+MarkerKernelLevel DetectMarkerKernelLevel()
+{
+#if defined( NATNET_X86 ) && ( defined( __GNUC__ ) || defined( __clang__ ) )
+    __builtin_cpu_init();
+    if( __builtin_cpu_supports( "avx2" ) )
+    {
+        return MarkerKernel_AVX2;
+    }
+    if( __builtin_cpu_supports( "sse2" ) )
+    {
+        return MarkerKernel_SSE2;
+    }
+#elif defined( NATNET_X86 ) && defined( _MSC_VER )
+    int info[4] = { 0 };
+    __cpuid( info, 1 );
+    bool sse2 = ( info[3] & ( 1 << 26 ) ) != 0;
+    bool osxsave = ( info[2] & ( 1 << 27 ) ) != 0;
+    bool avx = ( info[2] & ( 1 << 28 ) ) != 0;
+    __cpuidex( info, 7, 0 );
+    bool avx2 = ( info[1] & ( 1 << 5 ) ) != 0;
+    if( osxsave && avx && avx2 && ( ( _xgetbv( 0 ) & 0x6 ) == 0x6 ) )
+    {
+        return MarkerKernel_AVX2;
+    }
+    if( sse2 )
+    {
+        return MarkerKernel_SSE2;
+    }
+#endif
+    return MarkerKernel_Scalar;
+}
+
+/**
+ * \brief Kernels of a given level, or of the best level below it that is compiled in
+ * \param level - requested level; callers must not request more than DetectMarkerKernelLevel()
+ * \return - kernels
+*/
+const MarkerKernels& GetMarkerKernels( MarkerKernelLevel level )
+{
+    const int nKernels = (int) ( sizeof( kKernels ) / sizeof( kKernels[0] ) );
+    return kKernels[std::min( (int) level, nKernels - 1 )];
+}
+
+/**
+ * \brief Kernels for this CPU, detected on first use
+ * \return - kernels
+*/
+const MarkerKernels& GetMarkerKernels()
+{
+    static const MarkerKernels& kernels = GetMarkerKernels( DetectMarkerKernelLevel() );
+    return kernels;
+}
+
+} // namespace natnet
@@ -0,0 +1,41 @@
+/**
+ * \file   MarkerKernels.h
+ * \brief  Bulk conversion of packed marker records into FrameSoA arrays.
+ * Labeled and asset markers are streamed as packed 26 byte records
+ * (id, x, y, z, size, params, residual; NatNet 3.0 and later) and legacy
+ * markers as 12 byte xyz records. The kernels transpose several records per
+ * iteration with SSE2 or AVX2; the implementation is chosen at runtime from
+ * the features of the CPU, with a scalar fallback for other CPUs.
+ */
+
+#pragma once
+
+#include "FrameSoA.h"
+
+namespace natnet
+{
+
+enum MarkerKernelLevel
+{
+    MarkerKernel_Scalar = 0,
+    MarkerKernel_SSE2,
+    MarkerKernel_AVX2
+};
+
+struct MarkerKernels
+{
+    MarkerKernelLevel level;
+    const char* name;
+
+    // count 12 byte xyz records into points[first, first + count)
+    void ( *unpackPoints )( const char* ptr, int count, PointArrays& points, int first );
+
+    // count 26 byte marker records into markers[first, first + count)
+    void ( *unpackMarkers )( const char* ptr, int count, MarkerArrays& markers, int first );
+};
+
+MarkerKernelLevel DetectMarkerKernelLevel();
+const MarkerKernels& GetMarkerKernels( MarkerKernelLevel level );
+const MarkerKernels& GetMarkerKernels();
+
+} // namespace natnet
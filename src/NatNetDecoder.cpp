@@ -0,0 +1,1028 @@
+/*
+Copyright © 2012 NaturalPoint Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+/**
+ * \file   NatNetDecoder.cpp
+ * \brief  Print-free NatNet frame decoder, extracted from PacketClient.cpp.
+ */
+
+#include "NatNetDecoder.h"
+
+#include "FrameLayout.h"
+#include "FrameSoA.h"
+#include "FrameWalk.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace natnet
+{
+
+namespace
+{
+
+/**
+ * \brief Copy a null terminated string out of the packet
+ * \param ptr - input data stream pointer
+ * \param dest - output buffer
+ * \param destSize - output buffer size
+ * \return - pointer after the string
+*/
+const char* UnpackString( const char* ptr, char* dest, size_t destSize )
+{
+    size_t len = strlen( ptr );
+    size_t nCopy = std::min( len, destSize - 1 );
+    memcpy( dest, ptr, nCopy );
+    dest[nCopy] = 0;
+    return ptr + len + 1;
+}
+
+/**
+ * \brief Unpack a rigid body record (ID, position, orientation)
+ * \param ptr - input data stream pointer
+ * \param rb - output rigid body
+ * \return - pointer after decoded object
+*/
+const char* UnpackRigidBodyPose( const char* ptr, sRigidBodyData& rb )
+{
+    memcpy( &rb.ID, ptr, 4 ); ptr += 4;
+    memcpy( &rb.x, ptr, 4 ); ptr += 4;
+    memcpy( &rb.y, ptr, 4 ); ptr += 4;
+    memcpy( &rb.z, ptr, 4 ); ptr += 4;
+    memcpy( &rb.qx, ptr, 4 ); ptr += 4;
+    memcpy( &rb.qy, ptr, 4 ); ptr += 4;
+    memcpy( &rb.qz, ptr, 4 ); ptr += 4;
+    memcpy( &rb.qw, ptr, 4 ); ptr += 4;
+    return ptr;
+}
+
+/**
+ * \brief Unpack the channels of a force plate or device
+ * \param ptr - input data stream pointer
+ * \param nChannels - number of channels in the packet
+ * \param channels - output channel array ( [MAX_ANALOG_CHANNELS] ), may be null to skip
+ * \return - pointer after decoded object
+*/
+const char* UnpackAnalogChannels( const char* ptr, int nChannels, sAnalogChannelData* channels )
+{
+    for( int i = 0; i < nChannels; i++ )
+    {
+        int nFrames = 0; memcpy( &nFrames, ptr, 4 ); ptr += 4;
+        if( channels && ( i < MAX_ANALOG_CHANNELS ) )
+        {
+            int nStored = ClampCount( nFrames, MAX_ANALOG_SUBFRAMES );
+            channels[i].nFrames = nStored;
+            memcpy( channels[i].Values, ptr, nStored * sizeof( float ) );
+        }
+        ptr += std::max( 0, nFrames ) * sizeof( float );
+    }
+    return ptr;
+}
+
+/**
+ * \brief Reset the counts of a frame before decoding into it
+ * \param frame - frame to reset
+*/
+void ResetFrame( MocapFrame& frame )
+{
+    sFrameOfMocapData& data = frame.data;
+    data.iFrame = 0;
+    data.nMarkerSets = 0;
+    data.nOtherMarkers = 0;
+    data.OtherMarkers = nullptr;
+    data.nRigidBodies = 0;
+    data.nSkeletons = 0;
+    data.nAssets = 0;
+    data.nLabeledMarkers = 0;
+    data.nForcePlates = 0;
+    data.nDevices = 0;
+
+    frame.markerSetMarkers.clear();
+    frame.otherMarkers.clear();
+    frame.skeletonRigidBodies.clear();
+    frame.assetRigidBodies.clear();
+    frame.assetMarkers.clear();
+}
+
+/**
+ * \brief Point the variable length members of the frame at their storage.
+ * Storage is appended in section order while decoding and may be reallocated,
+ * so the pointers are only assigned once the whole frame has been decoded.
+ * \param frame - decoded frame
+*/
+void AssignFramePointers( MocapFrame& frame )
+{
+    sFrameOfMocapData& data = frame.data;
+
+    MarkerData* markers = reinterpret_cast<MarkerData*>( frame.markerSetMarkers.data() );
+    for( int i = 0; i < data.nMarkerSets; i++ )
+    {
+        data.MocapData[i].Markers = markers;
+        markers += data.MocapData[i].nMarkers;
+    }
+
+    data.OtherMarkers = reinterpret_cast<MarkerData*>( frame.otherMarkers.data() );
+
+    sRigidBodyData* bones = frame.skeletonRigidBodies.data();
+    for( int i = 0; i < data.nSkeletons; i++ )
+    {
+        data.Skeletons[i].RigidBodyData = bones;
+        bones += data.Skeletons[i].nRigidBodies;
+    }
+
+    sRigidBodyData* assetRigidBodies = frame.assetRigidBodies.data();
+    sMarker* assetMarkers = frame.assetMarkers.data();
+    for( int i = 0; i < data.nAssets; i++ )
+    {
+        data.Assets[i].RigidBodyData = assetRigidBodies;
+        assetRigidBodies += data.Assets[i].nRigidBodies;
+        data.Assets[i].MarkerData = assetMarkers;
+        assetMarkers += data.Assets[i].nMarkers;
+    }
+}
+
+} // namespace
+
+MocapFrame::MocapFrame()
+    : data()
+    , receiveTimestamp()
+{
+}
+
+/**
+ * \brief Allocate the storage of a frame up front, so that decoding or copying
+ * frames up to that size into it does not allocate
+ * \param frame - frame to reserve storage in
+ * \param capacity - number of records to reserve
+*/
+void ReserveFrame( MocapFrame& frame, const FrameCapacity& capacity )
+{
+    frame.markerSetMarkers.reserve( (size_t) capacity.markerSetMarkers * 3 );
+    frame.otherMarkers.reserve( (size_t) capacity.otherMarkers * 3 );
+    frame.skeletonRigidBodies.reserve( capacity.skeletonRigidBodies );
+    frame.assetRigidBodies.reserve( capacity.assetRigidBodies );
+    frame.assetMarkers.reserve( capacity.assetMarkers );
+}
+
+/**
+ * \brief Deep copy a frame owned by someone else (e.g. the frame passed to a
+ * NatNetClient frame callback) into a MocapFrame.
+ * Replaces NatNet_CopyFrame/NatNet_FreeFrame: the variable length arrays are
+ * copied into the storage of the MocapFrame, which is reused, and only the
+ * records in use of the fixed size arrays are copied.
+ * \param src - frame to copy
+ * \param frame - destination frame
+*/
+void CopyFrame( const sFrameOfMocapData& src, MocapFrame& frame )
+{
+    ResetFrame( frame );
+    sFrameOfMocapData& data = frame.data;
+
+    data.iFrame = src.iFrame;
+
+    data.nMarkerSets = ClampCount( src.nMarkerSets, MAX_MARKERSETS );
+    for( int i = 0; i < data.nMarkerSets; i++ )
+    {
+        const sMarkerSetData& markerSet = src.MocapData[i];
+        memcpy( data.MocapData[i].szName, markerSet.szName, sizeof( markerSet.szName ) );
+        data.MocapData[i].nMarkers = std::max( 0, markerSet.nMarkers );
+        const float* markers = reinterpret_cast<const float*>( markerSet.Markers );
+        frame.markerSetMarkers.insert( frame.markerSetMarkers.end(), markers, markers + data.MocapData[i].nMarkers * 3 );
+    }
+
+    data.nOtherMarkers = std::max( 0, src.nOtherMarkers );
+    const float* otherMarkers = reinterpret_cast<const float*>( src.OtherMarkers );
+    frame.otherMarkers.assign( otherMarkers, otherMarkers + data.nOtherMarkers * 3 );
+
+    data.nRigidBodies = ClampCount( src.nRigidBodies, MAX_RIGIDBODIES );
+    std::copy( src.RigidBodies, src.RigidBodies + data.nRigidBodies, data.RigidBodies );
+
+    data.nSkeletons = ClampCount( src.nSkeletons, MAX_SKELETONS );
+    for( int i = 0; i < data.nSkeletons; i++ )
+    {
+        const sSkeletonData& skeleton = src.Skeletons[i];
+        data.Skeletons[i].skeletonID = skeleton.skeletonID;
+        data.Skeletons[i].nRigidBodies = std::max( 0, skeleton.nRigidBodies );
+        frame.skeletonRigidBodies.insert( frame.skeletonRigidBodies.end(),
+            skeleton.RigidBodyData, skeleton.RigidBodyData + data.Skeletons[i].nRigidBodies );
+    }
+
+    data.nAssets = ClampCount( src.nAssets, MAX_ASSETS );
+    for( int i = 0; i < data.nAssets; i++ )
+    {
+        const sAssetData& asset = src.Assets[i];
+        data.Assets[i].assetID = asset.assetID;
+        data.Assets[i].nRigidBodies = std::max( 0, asset.nRigidBodies );
+        frame.assetRigidBodies.insert( frame.assetRigidBodies.end(),
+            asset.RigidBodyData, asset.RigidBodyData + data.Assets[i].nRigidBodies );
+        data.Assets[i].nMarkers = std::max( 0, asset.nMarkers );
+        frame.assetMarkers.insert( frame.assetMarkers.end(), asset.MarkerData, asset.MarkerData + data.Assets[i].nMarkers );
+    }
+
+    data.nLabeledMarkers = ClampCount( src.nLabeledMarkers, MAX_LABELED_MARKERS );
+    std::copy( src.LabeledMarkers, src.LabeledMarkers + data.nLabeledMarkers, data.LabeledMarkers );
+
+    data.nForcePlates = ClampCount( src.nForcePlates, MAX_FORCEPLATES );
+    std::copy( src.ForcePlates, src.ForcePlates + data.nForcePlates, data.ForcePlates );
+
+    data.nDevices = ClampCount( src.nDevices, MAX_DEVICES );
+    std::copy( src.Devices, src.Devices + data.nDevices, data.Devices );
+
+    data.Timecode = src.Timecode;
+    data.TimecodeSubframe = src.TimecodeSubframe;
+    data.fTimestamp = src.fTimestamp;
+    data.CameraMidExposureTimestamp = src.CameraMidExposureTimestamp;
+    data.CameraDataReceivedTimestamp = src.CameraDataReceivedTimestamp;
+    data.TransmitTimestamp = src.TransmitTimestamp;
+    data.PrecisionTimestampSecs = src.PrecisionTimestampSecs;
+    data.PrecisionTimestampFractionalSecs = src.PrecisionTimestampFractionalSecs;
+    data.params = src.params;
+
+    AssignFramePointers( frame );
+}
+
+/**
+ * \brief Unpack packet header
+ * \param ptr - input data stream pointer
+ * \param messageID - output message ID
+ * \param nBytes - output payload size
+ * \param nBytesTotal - output packet size including the header
+ * \return - pointer after decoded object
+*/
+const char* UnpackPacketHeader( const char* ptr, int& messageID, int& nBytes, int& nBytesTotal )
+{
+    // First 2 Bytes is message ID
+    uint16_t value = 0;
+    memcpy( &value, ptr, 2 ); ptr += 2;
+    messageID = value;
+
+    // Second 2 Bytes is the size of the packet
+    memcpy( &value, ptr, 2 ); ptr += 2;
+    nBytes = value;
+    nBytesTotal = nBytes + 4;
+    return ptr;
+}
+
+/**
+ * \brief Unpack number of bytes of data for a given data type.
+ * Useful if you want to skip this type of data.
+ * \param ptr - input data stream pointer
+ * \param major - NatNet major version
+ * \param minor - NatNet minor version
+ * \param nBytes - output size of the data that follows, 0 before NatNet 4.1
+ * \param skip - advance past the data that follows
+ * \return - pointer after decoded object
+*/
+const char* UnpackDataSize( const char* ptr, int major, int minor, int& nBytes, bool skip /*= false*/ )
+{
+    nBytes = 0;
+
+    // size of all data for this data type (in bytes);
+    if( ( ( major == 4 ) && ( minor > 0 ) ) || ( major > 4 ) )
+    {
+        memcpy( &nBytes, ptr, 4 ); ptr += 4;
+        if( skip )
+        {
+            ptr += nBytes;
+        }
+    }
+    return ptr;
+}
+
+/**
+ * \brief Whether every frame section is preceded by its size in bytes
+ * \param major - NatNet major version
+ * \param minor - NatNet minor version
+ * \return - true for NatNet 4.1 and later
+*/
+bool HasSectionSizes( int major, int minor )
+{
+    return ( ( major == 4 ) && ( minor > 0 ) ) || ( major > 4 );
+}
+
+/**
+ * \brief Skip a frame section using its size (NatNet 4.1 and later only)
+ * \param ptr - pointer to the section count
+ * \param major - NatNet major version
+ * \param minor - NatNet minor version
+ * \return - pointer after the section
+*/
+const char* SkipFrameSection( const char* ptr, int major, int minor )
+{
+    int nBytes = 0;
+    ptr += 4;   // count
+    return UnpackDataSize( ptr, major, minor, nBytes, true );
+}
+
+namespace
+{
+
+/**
+ * \brief Step over the section size that precedes each section from NatNet 4.1 on
+ * \param ptr - pointer after the section count
+ * \return - pointer to the first record of the section
+*/
+template <typename Layout>
+const char* UnpackSectionSize( const char* ptr )
+{
+    return Layout::sectionSizes ? ptr + 4 : ptr;
+}
+
+/**
+ * \brief Unpack frame prefix data
+ * \param ptr - input data stream pointer
+ * \param frame - output frame
+ * \return - pointer after decoded object
+*/
+template <typename Layout>
+const char* UnpackFramePrefixData( const char* ptr, MocapFrame& frame )
+{
+    // Next 4 Bytes is the frame number
+    memcpy( &frame.data.iFrame, ptr, 4 ); ptr += 4;
+    return ptr;
+}
+
+/**
+ * \brief Unpack markerset data
+ * \param ptr - input data stream pointer
+ * \param frame - output frame
+ * \return - pointer after decoded object
+*/
+template <typename Layout>
+const char* UnpackMarkersetData( const char* ptr, MocapFrame& frame )
+{
+    sFrameOfMocapData& data = frame.data;
+
+    // First 4 Bytes is the number of data sets (markersets, rigidbodies, etc)
+    int nMarkerSets = 0; memcpy( &nMarkerSets, ptr, 4 ); ptr += 4;
+    data.nMarkerSets = ClampCount( nMarkerSets, MAX_MARKERSETS );
+
+    ptr = UnpackSectionSize<Layout>( ptr );
+
+    // Loop through number of marker sets and get name and data
+    for( int i = 0; i < nMarkerSets; i++ )
+    {
+        char szName[MAX_NAMELENGTH];
+        ptr = UnpackString( ptr, szName, sizeof( szName ) );
+
+        int nMarkers = 0; memcpy( &nMarkers, ptr, 4 ); ptr += 4;
+        nMarkers = std::max( 0, nMarkers );
+
+        if( i < data.nMarkerSets )
+        {
+            sMarkerSetData& markerSet = data.MocapData[i];
+            memcpy( markerSet.szName, szName, sizeof( szName ) );
+            markerSet.nMarkers = nMarkers;
+            size_t offset = frame.markerSetMarkers.size();
+            frame.markerSetMarkers.resize( offset + nMarkers * 3 );
+            memcpy( &frame.markerSetMarkers[offset], ptr, nMarkers * 3 * sizeof( float ) );
+        }
+        ptr += nMarkers * 3 * sizeof( float );
+    }
+
+    return ptr;
+}
+
+/**
+ * \brief Unpack legacy 'other' unlabeled markers (will be deprecated)
+ * \param ptr - input data stream pointer
+ * \param frame - output frame
+ * \return - pointer after decoded object
+*/
+template <typename Layout>
+const char* UnpackLegacyOtherMarkers( const char* ptr, MocapFrame& frame )
+{
+    // First 4 Bytes is the number of Other markers
+    int nOtherMarkers = 0; memcpy( &nOtherMarkers, ptr, 4 ); ptr += 4;
+    nOtherMarkers = std::max( 0, nOtherMarkers );
+
+    ptr = UnpackSectionSize<Layout>( ptr );
+
+    frame.data.nOtherMarkers = nOtherMarkers;
+    frame.otherMarkers.resize( nOtherMarkers * 3 );
+    memcpy( frame.otherMarkers.data(), ptr, nOtherMarkers * 3 * sizeof( float ) );
+    ptr += nOtherMarkers * 3 * sizeof( float );
+
+    return ptr;
+}
+
+/**
+ * \brief Unpack rigid body data
+ * \param ptr - input data stream pointer
+ * \param frame - output frame
+ * \return - pointer after decoded object
+*/
+template <typename Layout>
+const char* UnpackRigidBodyData( const char* ptr, MocapFrame& frame )
+{
+    sFrameOfMocapData& data = frame.data;
+
+    int nRigidBodies = 0; memcpy( &nRigidBodies, ptr, 4 ); ptr += 4;
+    data.nRigidBodies = ClampCount( nRigidBodies, MAX_RIGIDBODIES );
+
+    ptr = UnpackSectionSize<Layout>( ptr );
+
+    for( int j = 0; j < nRigidBodies; j++ )
+    {
+        // bodies beyond the SDK limit are decoded into scratch space and dropped
+        sRigidBodyData scratch;
+        sRigidBodyData& rb = ( j < data.nRigidBodies ) ? data.RigidBodies[j] : scratch;
+
+        // Rigid body position and orientation
+        ptr = UnpackRigidBodyPose( ptr, rb );
+
+        // Marker positions removed as redundant (since they can be derived from RB Pos/Ori plus initial offset) in NatNet 3.0 and later to optimize packet size
+        if( Layout::rigidBodyMarkers )
+        {
+            // Associated marker positions, and IDs and sizes from NatNet 2.0 on
+            int nRigidMarkers = 0; memcpy( &nRigidMarkers, ptr, 4 ); ptr += 4;
+            ptr += std::max( 0, nRigidMarkers ) * Layout::rigidBodyMarkerBytes;
+        }
+
+        // NatNet version 2.0 and later
+        rb.MeanError = 0.0f;
+        if( Layout::rigidBodyError )
+        {
+            // Mean marker error
+            memcpy( &rb.MeanError, ptr, 4 ); ptr += 4;
+        }
+
+        // NatNet version 2.6 and later
+        rb.params = 0;
+        if( Layout::params )
+        {
+            // params ( 0x01 : rigid body was successfully tracked in this frame )
+            memcpy( &rb.params, ptr, 2 ); ptr += 2;
+        }
+    } // Go to next rigid body
+
+    return ptr;
+}
+
+/**
+ * \brief Unpack skeleton data
+ * \param ptr - input data stream pointer
+ * \param frame - output frame
+ * \return - pointer after decoded object
+*/
+template <typename Layout>
+const char* UnpackSkeletonData( const char* ptr, MocapFrame& frame )
+{
+    sFrameOfMocapData& data = frame.data;
+
+    // Skeletons (NatNet version 2.1 and later)
+    if( Layout::skeletons )
+    {
+        int nSkeletons = 0; memcpy( &nSkeletons, ptr, 4 ); ptr += 4;
+        data.nSkeletons = ClampCount( nSkeletons, MAX_SKELETONS );
+
+        ptr = UnpackSectionSize<Layout>( ptr );
+
+        // Loop through skeletons
+        for( int j = 0; j < nSkeletons; j++ )
+        {
+            // skeleton id
+            int skeletonID = 0; memcpy( &skeletonID, ptr, 4 ); ptr += 4;
+
+            // Number of rigid bodies (bones) in skeleton
+            int nRigidBodies = 0; memcpy( &nRigidBodies, ptr, 4 ); ptr += 4;
+            nRigidBodies = std::max( 0, nRigidBodies );
+
+            bool stored = ( j < data.nSkeletons );
+            if( stored )
+            {
+                data.Skeletons[j].skeletonID = skeletonID;
+                data.Skeletons[j].nRigidBodies = nRigidBodies;
+            }
+
+            // Loop through rigid bodies (bones) in skeleton
+            for( int k = 0; k < nRigidBodies; k++ )
+            {
+                sRigidBodyData rb;
+                ptr = UnpackRigidBodyPose( ptr, rb );
+
+                // Mean marker error (NatNet version 2.0 and later)
+                rb.MeanError = 0.0f;
+                if( Layout::boneError )
+                {
+                    memcpy( &rb.MeanError, ptr, 4 ); ptr += 4;
+                }
+
+                // Tracking flags (NatNet version 2.6 and later)
+                rb.params = 0;
+                if( Layout::params )
+                {
+                    memcpy( &rb.params, ptr, 2 ); ptr += 2;
+                }
+
+                if( stored )
+                {
+                    frame.skeletonRigidBodies.push_back( rb );
+                }
+            } // next rigid body
+        } // next skeleton
+    }
+
+    return ptr;
+}
+
+/**
+ * \brief Unpack asset data
+ * \param ptr - input data stream pointer
+ * \param frame - output frame
+ * \return - pointer after decoded object
+*/
+template <typename Layout>
+const char* UnpackAssetData( const char* ptr, MocapFrame& frame )
+{
+    sFrameOfMocapData& data = frame.data;
+
+    // Assets ( Motive 3.1 / NatNet 4.1 and greater)
+    if( Layout::assets )
+    {
+        int nAssets = 0; memcpy( &nAssets, ptr, 4 ); ptr += 4;
+        data.nAssets = ClampCount( nAssets, MAX_ASSETS );
+
+        ptr = UnpackSectionSize<Layout>( ptr );
+
+        for( int i = 0; i < nAssets; i++ )
+        {
+            bool stored = ( i < data.nAssets );
+
+            // asset id
+            int assetID = 0; memcpy( &assetID, ptr, 4 ); ptr += 4;
+
+            // # of Rigid Bodies
+            int nRigidBodies = 0; memcpy( &nRigidBodies, ptr, 4 ); ptr += 4;
+            nRigidBodies = std::max( 0, nRigidBodies );
+
+            // Rigid Body data
+            for( int j = 0; j < nRigidBodies; j++ )
+            {
+                sRigidBodyData rb;
+                ptr = UnpackRigidBodyPose( ptr, rb );
+                memcpy( &rb.MeanError, ptr, 4 ); ptr += 4;
+                memcpy( &rb.params, ptr, 2 ); ptr += 2;
+                if( stored )
+                {
+                    frame.assetRigidBodies.push_back( rb );
+                }
+            }
+
+            // # of Markers
+            int nMarkers = 0; memcpy( &nMarkers, ptr, 4 ); ptr += 4;
+            nMarkers = std::max( 0, nMarkers );
+
+            // Marker data
+            for( int j = 0; j < nMarkers; j++ )
+            {
+                sMarker marker;
+                memcpy( &marker.ID, ptr, 4 ); ptr += 4;
+                memcpy( &marker.x, ptr, 4 ); ptr += 4;
+                memcpy( &marker.y, ptr, 4 ); ptr += 4;
+                memcpy( &marker.z, ptr, 4 ); ptr += 4;
+                memcpy( &marker.size, ptr, 4 ); ptr += 4;
+                memcpy( &marker.params, ptr, 2 ); ptr += 2;
+                memcpy( &marker.residual, ptr, 4 ); ptr += 4;
+                if( stored )
+                {
+                    frame.assetMarkers.push_back( marker );
+                }
+            }
+
+            if( stored )
+            {
+                data.Assets[i].assetID = assetID;
+                data.Assets[i].nRigidBodies = nRigidBodies;
+                data.Assets[i].nMarkers = nMarkers;
+            }
+        }
+    }
+
+    return ptr;
+}
+
+/**
+ * \brief Unpack labeled marker data
+ * \param ptr - input data stream pointer
+ * \param frame - output frame
+ * \return - pointer after decoded object
+*/
+template <typename Layout>
+const char* UnpackLabeledMarkerData( const char* ptr, MocapFrame& frame )
+{
+    sFrameOfMocapData& data = frame.data;
+
+    // labeled markers (NatNet version 2.3 and later)
+    // labeled markers - this includes all markers: Active, Passive, and 'unlabeled' (markers with no asset but a PointCloud ID)
+    if( Layout::labeledMarkers )
+    {
+        int nLabeledMarkers = 0; memcpy( &nLabeledMarkers, ptr, 4 ); ptr += 4;
+        data.nLabeledMarkers = ClampCount( nLabeledMarkers, MAX_LABELED_MARKERS );
+
+        ptr = UnpackSectionSize<Layout>( ptr );
+
+        // Loop through labeled markers
+        for( int j = 0; j < nLabeledMarkers; j++ )
+        {
+            sMarker scratch;
+            sMarker& marker = ( j < data.nLabeledMarkers ) ? data.LabeledMarkers[j] : scratch;
+
+            // id (see DecodeMarkerID for the ID scheme)
+            memcpy( &marker.ID, ptr, 4 ); ptr += 4;
+            memcpy( &marker.x, ptr, 4 ); ptr += 4;
+            memcpy( &marker.y, ptr, 4 ); ptr += 4;
+            memcpy( &marker.z, ptr, 4 ); ptr += 4;
+            memcpy( &marker.size, ptr, 4 ); ptr += 4;
+
+            // NatNet version 2.6 and later
+            marker.params = 0;
+            if( Layout::params )
+            {
+                memcpy( &marker.params, ptr, 2 ); ptr += 2;
+            }
+
+            // NatNet version 3.0 and later
+            marker.residual = 0.0f;
+            if( Layout::markerResidual )
+            {
+                memcpy( &marker.residual, ptr, 4 ); ptr += 4;
+            }
+        }
+    }
+    return ptr;
+}
+
+/**
+ * \brief Unpack force plate data
+ * \param ptr - input data stream pointer
+ * \param frame - output frame
+ * \return - pointer after decoded object
+*/
+template <typename Layout>
+const char* UnpackForcePlateData( const char* ptr, MocapFrame& frame )
+{
+    sFrameOfMocapData& data = frame.data;
+
+    // Force Plate data (NatNet version 2.9 and later)
+    if( Layout::forcePlates )
+    {
+        int nForcePlates = 0; memcpy( &nForcePlates, ptr, 4 ); ptr += 4;
+        data.nForcePlates = ClampCount( nForcePlates, MAX_FORCEPLATES );
+
+        ptr = UnpackSectionSize<Layout>( ptr );
+
+        for( int iForcePlate = 0; iForcePlate < nForcePlates; iForcePlate++ )
+        {
+            int ID = 0; memcpy( &ID, ptr, 4 ); ptr += 4;
+            int nChannels = 0; memcpy( &nChannels, ptr, 4 ); ptr += 4;
+
+            sAnalogChannelData* channels = nullptr;
+            if( iForcePlate < data.nForcePlates )
+            {
+                sForcePlateData& plate = data.ForcePlates[iForcePlate];
+                plate.ID = ID;
+                plate.nChannels = ClampCount( nChannels, MAX_ANALOG_CHANNELS );
+                plate.params = 0;
+                channels = plate.ChannelData;
+            }
+            ptr = UnpackAnalogChannels( ptr, nChannels, channels );
+        }
+    }
+    return ptr;
+}
+
+/**
+ * \brief Unpack device data
+ * \param ptr - input data stream pointer
+ * \param frame - output frame
+ * \return - pointer after decoded object
+*/
+template <typename Layout>
+const char* UnpackDeviceData( const char* ptr, MocapFrame& frame )
+{
+    sFrameOfMocapData& data = frame.data;
+
+    // Device data (NatNet version 3.0 and later)
+    if( Layout::devices )
+    {
+        int nDevices = 0; memcpy( &nDevices, ptr, 4 ); ptr += 4;
+        data.nDevices = ClampCount( nDevices, MAX_DEVICES );
+
+        ptr = UnpackSectionSize<Layout>( ptr );
+
+        for( int iDevice = 0; iDevice < nDevices; iDevice++ )
+        {
+            int ID = 0; memcpy( &ID, ptr, 4 ); ptr += 4;
+            int nChannels = 0; memcpy( &nChannels, ptr, 4 ); ptr += 4;
+
+            sAnalogChannelData* channels = nullptr;
+            if( iDevice < data.nDevices )
+            {
+                sDeviceData& device = data.Devices[iDevice];
+                device.ID = ID;
+                device.nChannels = ClampCount( nChannels, MAX_ANALOG_CHANNELS );
+                device.params = 0;
+                channels = device.ChannelData;
+            }
+            ptr = UnpackAnalogChannels( ptr, nChannels, channels );
+        }
+    }
+
+    return ptr;
+}
+
+/**
+ * \brief Unpack suffix data
+ * \param ptr - input data stream pointer
+ * \param frame - output frame
+ * \return - pointer after decoded object
+*/
+template <typename Layout>
+const char* UnpackFrameSuffixData( const char* ptr, MocapFrame& frame )
+{
+    sFrameOfMocapData& data = frame.data;
+
+    // software latency (removed in version 3.0, not part of sFrameOfMocapData)
+    if( Layout::softwareLatency )
+    {
+        ptr += 4;
+    }
+
+    // timecode
+    memcpy( &data.Timecode, ptr, 4 ); ptr += 4;
+    memcpy( &data.TimecodeSubframe, ptr, 4 ); ptr += 4;
+
+    // NatNet version 2.7 and later - increased from single to double precision
+    if( Layout::doubleTimestamp )
+    {
+        memcpy( &data.fTimestamp, ptr, 8 ); ptr += 8;
+    }
+    else
+    {
+        float fTemp = 0.0f;
+        memcpy( &fTemp, ptr, 4 ); ptr += 4;
+        data.fTimestamp = (double) fTemp;
+    }
+
+    // high res timestamps (version 3.0 and later)
+    data.CameraMidExposureTimestamp = 0;
+    data.CameraDataReceivedTimestamp = 0;
+    data.TransmitTimestamp = 0;
+    if( Layout::highResTimestamps )
+    {
+        memcpy( &data.CameraMidExposureTimestamp, ptr, 8 ); ptr += 8;
+        memcpy( &data.CameraDataReceivedTimestamp, ptr, 8 ); ptr += 8;
+        memcpy( &data.TransmitTimestamp, ptr, 8 ); ptr += 8;
+    }
+
+    // precision timestamps (optionally present) (NatNet 4.1 and later)
+    data.PrecisionTimestampSecs = 0;
+    data.PrecisionTimestampFractionalSecs = 0;
+    if( Layout::precisionTimestamps )
+    {
+        memcpy( &data.PrecisionTimestampSecs, ptr, 4 ); ptr += 4;
+        memcpy( &data.PrecisionTimestampFractionalSecs, ptr, 4 ); ptr += 4;
+    }
+
+    // frame params
+    memcpy( &data.params, ptr, 2 ); ptr += 2;
+
+    // end of data tag
+    ptr += 4;
+
+    return ptr;
+}
+
+typedef const char* ( *SectionUnpacker )( const char* ptr, MocapFrame& frame );
+typedef const char* ( *SectionSkipper )( const char* ptr );
+
+/**
+ * \brief Unpack a section if it is subscribed, skip it otherwise.
+ * An unsubscribed section keeps the count ResetFrame gave it (0) and stores nothing.
+ * \param unpack - section unpack function
+ * \param skip - section walker, for streams without section sizes (see FrameWalk.h)
+ * \param section - FrameSection value of this section
+ * \param sections - subscription mask
+ * \param ptr - input data stream pointer
+ * \param frame - output frame
+ * \return - pointer after the section
+*/
+template <typename Layout>
+const char* UnpackSection( SectionUnpacker unpack, SectionSkipper skip, uint32_t section, uint32_t sections,
+    const char* ptr, MocapFrame& frame )
+{
+    if( sections & section )
+    {
+        return unpack( ptr, frame );
+    }
+    if( Layout::sectionSizes )
+    {
+        int nBytes = 0;
+        memcpy( &nBytes, ptr + 4, 4 );
+        return ptr + 8 + nBytes;
+    }
+
+    // no section sizes before NatNet 4.1, the section is walked without being decoded
+    return skip( ptr );
+}
+
+/**
+ * \brief Unpack a NAT_FRAMEOFDATA payload laid out as Layout
+ * \param inptr - input data stream pointer (after the packet header)
+ * \param nBytes - payload size
+ * \param frame - output frame
+ * \param sections - FrameSection mask of the sections to decode
+ * \return - pointer after decoded object
+*/
+template <typename Layout>
+const char* UnpackFrame( const char* inptr, int /*nBytes*/, MocapFrame& frame, uint32_t sections )
+{
+    const char* ptr = inptr;
+    ResetFrame( frame );
+
+    ptr = UnpackFramePrefixData<Layout>( ptr, frame );
+
+    ptr = UnpackSection<Layout>( UnpackMarkersetData<Layout>, SkipMarkerSets<Layout>,
+        FrameSection_MarkerSets, sections, ptr, frame );
+
+    ptr = UnpackSection<Layout>( UnpackLegacyOtherMarkers<Layout>, SkipOtherMarkers<Layout>,
+        FrameSection_LegacyOtherMarkers, sections, ptr, frame );
+
+    ptr = UnpackSection<Layout>( UnpackRigidBodyData<Layout>, SkipRigidBodies<Layout>,
+        FrameSection_RigidBodies, sections, ptr, frame );
+
+    ptr = UnpackSection<Layout>( UnpackSkeletonData<Layout>, SkipSkeletons<Layout>,
+        FrameSection_Skeletons, sections, ptr, frame );
+
+    // Assets ( Motive 3.1 / NatNet 4.1 and greater)
+    if( Layout::assets )
+    {
+        ptr = UnpackSection<Layout>( UnpackAssetData<Layout>, SkipAssets<Layout>,
+            FrameSection_Assets, sections, ptr, frame );
+    }
+
+    ptr = UnpackSection<Layout>( UnpackLabeledMarkerData<Layout>, SkipLabeledMarkers<Layout>,
+        FrameSection_LabeledMarkers, sections, ptr, frame );
+
+    ptr = UnpackSection<Layout>( UnpackForcePlateData<Layout>, SkipForcePlates<Layout>,
+        FrameSection_ForcePlates, sections, ptr, frame );
+
+    ptr = UnpackSection<Layout>( UnpackDeviceData<Layout>, SkipDevices<Layout>,
+        FrameSection_Devices, sections, ptr, frame );
+
+    ptr = UnpackFrameSuffixData<Layout>( ptr, frame );
+
+    AssignFramePointers( frame );
+
+    return ptr;
+}
+
+template <typename Layout>
+struct SelectFrameUnpacker
+{
+    static FrameUnpacker get() { return &UnpackFrame<Layout>; }
+};
+
+template <typename Layout>
+struct SelectFrameSections
+{
+    static uint32_t get()
+    {
+        return FrameSection_MarkerSets | FrameSection_LegacyOtherMarkers | FrameSection_RigidBodies
+            | ( Layout::skeletons ? FrameSection_Skeletons : 0 )
+            | ( Layout::assets ? FrameSection_Assets : 0 )
+            | ( Layout::labeledMarkers ? FrameSection_LabeledMarkers : 0 )
+            | ( Layout::forcePlates ? FrameSection_ForcePlates : 0 )
+            | ( Layout::devices ? FrameSection_Devices : 0 );
+    }
+};
+
+} // namespace
+
+/**
+ * \brief Sections present in the frames of a bitstream version
+ * \param major - NatNet major version
+ * \param minor - NatNet minor version
+ * \return - FrameSection mask
+*/
+uint32_t FrameSectionsOf( int major, int minor )
+{
+    return DispatchLayout<SelectFrameSections>( major, minor );
+}
+
+/**
+ * \brief Unpack a NAT_FRAMEOFDATA payload.
+ * Selects the decoder for the version on every call; streaming clients should
+ * keep a FrameDecoder for the connection instead.
+ * \param inptr - input data stream pointer (after the packet header)
+ * \param nBytes - payload size
+ * \param major - NatNet major version
+ * \param minor - NatNet minor version
+ * \param frame - output frame
+ * \param sections - FrameSection mask of the sections to decode
+ * \return - pointer after decoded object
+*/
+const char* UnpackFrameData( const char* inptr, int nBytes, int major, int minor, MocapFrame& frame,
+    uint32_t sections /*= FrameSection_All*/ )
+{
+    return DispatchLayout<SelectFrameUnpacker>( major, minor )( inptr, nBytes, frame, sections );
+}
+
+FrameDecoder::FrameDecoder()
+    : FrameDecoder( 0, 0 )
+{
+}
+
+FrameDecoder::FrameDecoder( int major, int minor )
+    : major( major )
+    , minor( minor )
+    , validateFrame( SelectFrameValidator( major, minor ) )
+    , unpackFrame( DispatchLayout<SelectFrameUnpacker>( major, minor ) )
+    , unpackFrameSoA( SelectFrameSoAUnpacker( major, minor ) )
+{
+}
+
+/**
+ * \brief Funtion that assigns a time code values to 5 variables passed as arguments
+ * Requires an integer from the packet as the timecode and timecodeSubframe
+ * \param inTimecode - input time code
+ * \param inTimecodeSubframe - input time code sub frame
+ * \param hour - output hour
+ * \param minute - output minute
+ * \param second - output second
+ * \param frame - output frame number 0 to 255
+ * \param subframe - output subframe number
+ * \return - true
+*/
+bool DecodeTimecode( unsigned int inTimecode, unsigned int inTimecodeSubframe, int* hour, int* minute, int* second, int* frame, int* subframe )
+{
+    bool bValid = true;
+
+    *hour = ( inTimecode >> 24 ) & 255;
+    *minute = ( inTimecode >> 16 ) & 255;
+    *second = ( inTimecode >> 8 ) & 255;
+    *frame = inTimecode & 255;
+    *subframe = inTimecodeSubframe;
+
+    return bValid;
+}
+
+/**
+ * \brief Takes timecode and assigns it to a string
+ * \param inTimecode  - input time code
+ * \param inTimecodeSubframe - input time code subframe
+ * \param Buffer - output buffer
+ * \param BufferSize - output buffer size
+ * \return
+*/
+bool TimecodeStringify( unsigned int inTimecode, unsigned int inTimecodeSubframe, char* Buffer, int BufferSize )
+{
+    bool bValid;
+    int hour, minute, second, frame, subframe;
+    bValid = DecodeTimecode( inTimecode, inTimecodeSubframe, &hour, &minute, &second, &frame, &subframe );
+
+    snprintf( Buffer, BufferSize, "%2d:%2d:%2d:%2d.%d", hour, minute, second, frame, subframe );
+    for( unsigned int i = 0; i < strlen( Buffer ); i++ )
+        if( Buffer[i] == ' ' )
+            Buffer[i] = '0';
+
+    return bValid;
+}
+
+/**
+ * \brief Decode marker ID
+ * Active Markers:
+ *   ID = ActiveID, correlates to RB ActiveLabels list
+ * Passive Markers:
+ *   If Asset with Legacy Labels
+ *      AssetID     (Hi Word)
+ *      MemberID    (Lo Word)
+ *   Else
+ *      PointCloud ID
+ * \param sourceID - input source ID
+ * \param pOutEntityID - output entity ID
+ * \param pOutMemberID - output member ID
+*/
+void DecodeMarkerID( int sourceID, int* pOutEntityID, int* pOutMemberID )
+{
+    if( pOutEntityID )
+        *pOutEntityID = sourceID >> 16;
+
+    if( pOutMemberID )
+        *pOutMemberID = sourceID & 0x0000ffff;
+}
+
+} // namespace natnet
@@ -0,0 +1,196 @@
+/*
+Copyright © 2012 NaturalPoint Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+/**
+ * \file   NatNetDecoder.h
+ * \brief  Decodes NatNet packets directly into sFrameOfMocapData.
+ * The unpack functions follow the layout handling of PacketClient.cpp, but
+ * store every decoded value instead of printing it. Nothing in this library
+ * writes to the console.
+ */
+
+#pragma once
+
+#include <NatNetTypes.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace natnet
+{
+
+enum ReceiveTimestampSource
+{
+    ReceiveTimestamp_None = 0,          // not available on this platform or socket
+    ReceiveTimestamp_Software,          // taken by the kernel when the datagram arrived
+    ReceiveTimestamp_Hardware           // taken by the NIC (clock of the NIC, see below)
+};
+
+/**
+ * \brief Network arrival time of the datagram a frame was decoded from.
+ * Software timestamps are CLOCK_REALTIME. Hardware timestamps come from the
+ * clock of the NIC and are only comparable with the system clock when that
+ * clock is synchronized to it (e.g. by phc2sys).
+ */
+struct ReceiveTimestamp
+{
+    int64_t nanoseconds;                // since the epoch
+    ReceiveTimestampSource source;
+};
+
+/**
+ * \brief Decoded frame of mocap data.
+ * data uses the SDK frame layout. The variable length arrays its pointers
+ * refer to (markerset markers, other markers, skeleton and asset members)
+ * live in the vectors below, which keep their capacity between frames, so
+ * decoding into the same MocapFrame stops allocating once it has seen the
+ * largest frame of a session.
+ */
+struct MocapFrame
+{
+    MocapFrame();
+    MocapFrame( const MocapFrame& ) = delete;
+    MocapFrame& operator=( const MocapFrame& ) = delete;
+
+    sFrameOfMocapData data;
+
+    std::vector<float> markerSetMarkers;                // data.MocapData[].Markers ( [n][3] )
+    std::vector<float> otherMarkers;                    // data.OtherMarkers ( [n][3] )
+    std::vector<sRigidBodyData> skeletonRigidBodies;    // data.Skeletons[].RigidBodyData
+    std::vector<sRigidBodyData> assetRigidBodies;       // data.Assets[].RigidBodyData
+    std::vector<sMarker> assetMarkers;                  // data.Assets[].MarkerData
+
+    ReceiveTimestamp receiveTimestamp;                  // set by the receiver, not by the decoders
+};
+
+// Number of records to reserve in the storage vectors of a MocapFrame
+struct FrameCapacity
+{
+    int markerSetMarkers;
+    int otherMarkers;
+    int skeletonRigidBodies;
+    int assetRigidBodies;
+    int assetMarkers;
+};
+
+void ReserveFrame( MocapFrame& frame, const FrameCapacity& capacity );
+void CopyFrame( const sFrameOfMocapData& src, MocapFrame& frame );
+
+// Number of entries of a count that fit into a fixed size SDK array
+// ( [capacity] ), negative counts read as 0
+inline int ClampCount( int count, int capacity )
+{
+    return std::max( 0, std::min( count, capacity ) );
+}
+
+// Frame sections, used as a subscription mask when decoding frames.
+// Unsubscribed sections decode as empty and nothing from them is stored. From
+// NatNet 4.1 on every section is preceded by its size in bytes and is skipped
+// without being walked; before, the records are stepped over undecoded.
+enum FrameSection
+{
+    FrameSection_MarkerSets         = 0x01,
+    FrameSection_LegacyOtherMarkers = 0x02,
+    FrameSection_RigidBodies        = 0x04,
+    FrameSection_Skeletons          = 0x08,
+    FrameSection_Assets             = 0x10,
+    FrameSection_LabeledMarkers     = 0x20,
+    FrameSection_ForcePlates        = 0x40,
+    FrameSection_Devices            = 0x80,
+    FrameSection_All                = 0xFF
+};
+
+// Result of checking a packet or frame against the bytes actually received.
+// The decoders trust counts and sizes read from the packet; validate data
+// from the network first (FrameDecoder::unpackChecked does both).
+enum DecodeStatus
+{
+    DecodeStatus_OK = 0,
+    DecodeStatus_Truncated,             // a count, record or section runs past the end of the data
+    DecodeStatus_InvalidCount,          // negative record count
+    DecodeStatus_InvalidSectionSize     // section size disagrees with its records (NatNet 4.1 and later)
+};
+
+const char* DecodeStatusString( DecodeStatus status );
+
+// Packet
+DecodeStatus ValidatePacket( const char* packet, int length );
+const char* UnpackPacketHeader( const char* ptr, int& messageID, int& nBytes, int& nBytesTotal );
+const char* UnpackDataSize( const char* ptr, int major, int minor, int& nBytes, bool skip = false );
+bool HasSectionSizes( int major, int minor );
+uint32_t FrameSectionsOf( int major, int minor );
+const char* SkipFrameSection( const char* ptr, int major, int minor );
+
+// Frame data
+DecodeStatus ValidateFrameData( const char* inptr, int nBytes, int major, int minor );
+const char* UnpackFrameData( const char* inptr, int nBytes, int major, int minor, MocapFrame& frame,
+    uint32_t sections = FrameSection_All );
+
+struct FrameSoA;
+
+typedef DecodeStatus ( *FrameValidator )( const char* inptr, int nBytes );
+typedef const char* ( *FrameUnpacker )( const char* inptr, int nBytes, MocapFrame& frame, uint32_t sections );
+typedef const char* ( *FrameSoAUnpacker )( const char* inptr, int nBytes, FrameSoA& frame, uint32_t sections );
+
+FrameValidator SelectFrameValidator( int major, int minor );
+
+/**
+ * \brief Frame decoders compiled for one bitstream version (see FrameLayout.h).
+ * Select it once per connection, when NAT_SERVERINFO arrives or the bitstream
+ * version changes, rather than re-evaluating the version for every frame.
+ */
+struct FrameDecoder
+{
+    FrameDecoder();
+    FrameDecoder( int major, int minor );
+
+    const char* unpack( const char* inptr, int nBytes, MocapFrame& frame, uint32_t sections = FrameSection_All ) const
+    {
+        return unpackFrame( inptr, nBytes, frame, sections );
+    }
+    const char* unpack( const char* inptr, int nBytes, FrameSoA& frame, uint32_t sections = FrameSection_All ) const
+    {
+        return unpackFrameSoA( inptr, nBytes, frame, sections );
+    }
+
+    // Checked decoding for untrusted payloads: nBytes must be the number of
+    // bytes received. A malformed frame is rejected before anything is
+    // written to frame; the return value is then nullptr.
+    const char* unpackChecked( const char* inptr, int nBytes, MocapFrame& frame, DecodeStatus& status,
+        uint32_t sections = FrameSection_All ) const
+    {
+        status = validateFrame( inptr, nBytes );
+        return ( status == DecodeStatus_OK ) ? unpackFrame( inptr, nBytes, frame, sections ) : nullptr;
+    }
+    const char* unpackChecked( const char* inptr, int nBytes, FrameSoA& frame, DecodeStatus& status,
+        uint32_t sections = FrameSection_All ) const
+    {
+        status = validateFrame( inptr, nBytes );
+        return ( status == DecodeStatus_OK ) ? unpackFrameSoA( inptr, nBytes, frame, sections ) : nullptr;
+    }
+
+    int major;
+    int minor;
+    FrameValidator validateFrame;
+    FrameUnpacker unpackFrame;
+    FrameSoAUnpacker unpackFrameSoA;
+};
+
+// Helpers
+bool DecodeTimecode( unsigned int inTimecode, unsigned int inTimecodeSubframe, int* hour, int* minute, int* second, int* frame, int* subframe );
+bool TimecodeStringify( unsigned int inTimecode, unsigned int inTimecodeSubframe, char* Buffer, int BufferSize );
+void DecodeMarkerID( int sourceID, int* pOutEntityID, int* pOutMemberID );
+
+} // namespace natnet
@@ -0,0 +1,566 @@
+/**
+ * \file   NatNetEncoder.cpp
+ * \brief  Encodes sFrameOfMocapData and sDataDescriptions as NatNet payloads.
+ */
+
+#include "NatNetEncoder.h"
+
+#include "FrameLayout.h"
+#include "NatNetDecoder.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace natnet
+{
+
+namespace
+{
+
+/**
+ * \brief Appends little endian values to a payload, as the decoders read them
+ */
+class PayloadWriter
+{
+public:
+    explicit PayloadWriter( std::vector<char>& out )
+        : out_( out )
+    {
+        out_.clear();
+    }
+
+    template <typename T>
+    void put( T value )
+    {
+        putBytes( &value, sizeof( value ) );
+    }
+
+    void putBytes( const void* data, size_t nBytes )
+    {
+        const char* bytes = static_cast<const char*>( data );
+        out_.insert( out_.end(), bytes, bytes + nBytes );
+    }
+
+    // null terminated string, stored in an SDK array of capacity bytes
+    void putString( const char* str, size_t capacity = MAX_NAMELENGTH )
+    {
+        const char* end = static_cast<const char*>( memchr( str, 0, capacity ) );
+        size_t len = end ? (size_t) ( end - str ) : capacity;
+        putBytes( str, len );
+        out_.push_back( 0 );
+    }
+
+    size_t position() const { return out_.size(); }
+
+    void patch( size_t position, int32_t value )
+    {
+        memcpy( &out_[position], &value, sizeof( value ) );
+    }
+
+private:
+    std::vector<char>& out_;
+};
+
+/**
+ * \brief Write the count of a frame section, followed by a placeholder for its
+ * size from NatNet 4.1 on
+ * \param w - payload
+ * \param count - number of records
+ * \return - position of the size placeholder
+*/
+template <typename Layout>
+size_t BeginSection( PayloadWriter& w, int count )
+{
+    w.put<int32_t>( count );
+    size_t position = w.position();
+    if( Layout::sectionSizes )
+    {
+        w.put<int32_t>( 0 );
+    }
+    return position;
+}
+
+template <typename Layout>
+void EndSection( PayloadWriter& w, size_t position )
+{
+    if( Layout::sectionSizes )
+    {
+        w.patch( position, (int32_t) ( w.position() - position - 4 ) );
+    }
+}
+
+void PackRigidBodyPose( PayloadWriter& w, const sRigidBodyData& rb )
+{
+    w.put<int32_t>( rb.ID );
+    w.put( rb.x );
+    w.put( rb.y );
+    w.put( rb.z );
+    w.put( rb.qx );
+    w.put( rb.qy );
+    w.put( rb.qz );
+    w.put( rb.qw );
+}
+
+void PackAnalogChannels( PayloadWriter& w, const sAnalogChannelData* channels, int nChannels )
+{
+    for( int i = 0; i < nChannels; i++ )
+    {
+        int nFrames = ClampCount( channels[i].nFrames, MAX_ANALOG_SUBFRAMES );
+        w.put<int32_t>( nFrames );
+        w.putBytes( channels[i].Values, nFrames * sizeof( float ) );
+    }
+}
+
+/**
+ * \brief Encode a frame as a NAT_FRAMEOFDATA payload laid out as Layout
+ * \param data - frame
+ * \param out - output payload
+*/
+template <typename Layout>
+void PackFrame( const sFrameOfMocapData& data, std::vector<char>& out )
+{
+    PayloadWriter w( out );
+
+    w.put<int32_t>( data.iFrame );
+
+    // markersets
+    int nMarkerSets = ClampCount( data.nMarkerSets, MAX_MARKERSETS );
+    size_t section = BeginSection<Layout>( w, nMarkerSets );
+    for( int i = 0; i < nMarkerSets; i++ )
+    {
+        const sMarkerSetData& markerSet = data.MocapData[i];
+        int nMarkers = std::max( 0, markerSet.nMarkers );
+        w.putString( markerSet.szName );
+        w.put<int32_t>( nMarkers );
+        if( nMarkers > 0 )
+        {
+            w.putBytes( markerSet.Markers, nMarkers * sizeof( MarkerData ) );
+        }
+    }
+    EndSection<Layout>( w, section );
+
+    // legacy other markers
+    int nOtherMarkers = std::max( 0, data.nOtherMarkers );
+    section = BeginSection<Layout>( w, nOtherMarkers );
+    if( nOtherMarkers > 0 )
+    {
+        w.putBytes( data.OtherMarkers, nOtherMarkers * sizeof( MarkerData ) );
+    }
+    EndSection<Layout>( w, section );
+
+    // rigid bodies
+    int nRigidBodies = ClampCount( data.nRigidBodies, MAX_RIGIDBODIES );
+    section = BeginSection<Layout>( w, nRigidBodies );
+    for( int i = 0; i < nRigidBodies; i++ )
+    {
+        const sRigidBodyData& rb = data.RigidBodies[i];
+        PackRigidBodyPose( w, rb );
+        if( Layout::rigidBodyMarkers )
+        {
+            w.put<int32_t>( 0 );
+        }
+        if( Layout::rigidBodyError )
+        {
+            w.put( rb.MeanError );
+        }
+        if( Layout::params )
+        {
+            w.put<int16_t>( rb.params );
+        }
+    }
+    EndSection<Layout>( w, section );
+
+    // skeletons
+    if( Layout::skeletons )
+    {
+        int nSkeletons = ClampCount( data.nSkeletons, MAX_SKELETONS );
+        section = BeginSection<Layout>( w, nSkeletons );
+        for( int i = 0; i < nSkeletons; i++ )
+        {
+            const sSkeletonData& skeleton = data.Skeletons[i];
+            int nBones = std::max( 0, skeleton.nRigidBodies );
+            w.put<int32_t>( skeleton.skeletonID );
+            w.put<int32_t>( nBones );
+            for( int j = 0; j < nBones; j++ )
+            {
+                const sRigidBodyData& rb = skeleton.RigidBodyData[j];
+                PackRigidBodyPose( w, rb );
+                if( Layout::boneError )
+                {
+                    w.put( rb.MeanError );
+                }
+                if( Layout::params )
+                {
+                    w.put<int16_t>( rb.params );
+                }
+            }
+        }
+        EndSection<Layout>( w, section );
+    }
+
+    // assets
+    if( Layout::assets )
+    {
+        int nAssets = ClampCount( data.nAssets, MAX_ASSETS );
+        section = BeginSection<Layout>( w, nAssets );
+        for( int i = 0; i < nAssets; i++ )
+        {
+            const sAssetData& asset = data.Assets[i];
+            int nAssetRigidBodies = std::max( 0, asset.nRigidBodies );
+            w.put<int32_t>( asset.assetID );
+            w.put<int32_t>( nAssetRigidBodies );
+            for( int j = 0; j < nAssetRigidBodies; j++ )
+            {
+                const sRigidBodyData& rb = asset.RigidBodyData[j];
+                PackRigidBodyPose( w, rb );
+                w.put( rb.MeanError );
+                w.put<int16_t>( rb.params );
+            }
+            int nMarkers = std::max( 0, asset.nMarkers );
+            w.put<int32_t>( nMarkers );
+            for( int j = 0; j < nMarkers; j++ )
+            {
+                const sMarker& marker = asset.MarkerData[j];
+                w.put<int32_t>( marker.ID );
+                w.put( marker.x );
+                w.put( marker.y );
+                w.put( marker.z );
+                w.put( marker.size );
+                w.put<int16_t>( marker.params );
+                w.put( marker.residual );
+            }
+        }
+        EndSection<Layout>( w, section );
+    }
+
+    // labeled markers
+    if( Layout::labeledMarkers )
+    {
+        int nLabeledMarkers = ClampCount( data.nLabeledMarkers, MAX_LABELED_MARKERS );
+        section = BeginSection<Layout>( w, nLabeledMarkers );
+        for( int i = 0; i < nLabeledMarkers; i++ )
+        {
+            const sMarker& marker = data.LabeledMarkers[i];
+            w.put<int32_t>( marker.ID );
+            w.put( marker.x );
+            w.put( marker.y );
+            w.put( marker.z );
+            w.put( marker.size );
+            if( Layout::params )
+            {
+                w.put<int16_t>( marker.params );
+            }
+            if( Layout::markerResidual )
+            {
+                w.put( marker.residual );
+            }
+        }
+        EndSection<Layout>( w, section );
+    }
+
+    // force plates
+    if( Layout::forcePlates )
+    {
+        int nForcePlates = ClampCount( data.nForcePlates, MAX_FORCEPLATES );
+        section = BeginSection<Layout>( w, nForcePlates );
+        for( int i = 0; i < nForcePlates; i++ )
+        {
+            int nChannels = ClampCount( data.ForcePlates[i].nChannels, MAX_ANALOG_CHANNELS );
+            w.put<int32_t>( data.ForcePlates[i].ID );
+            w.put<int32_t>( nChannels );
+            PackAnalogChannels( w, data.ForcePlates[i].ChannelData, nChannels );
+        }
+        EndSection<Layout>( w, section );
+    }
+
+    // devices
+    if( Layout::devices )
+    {
+        int nDevices = ClampCount( data.nDevices, MAX_DEVICES );
+        section = BeginSection<Layout>( w, nDevices );
+        for( int i = 0; i < nDevices; i++ )
+        {
+            int nChannels = ClampCount( data.Devices[i].nChannels, MAX_ANALOG_CHANNELS );
+            w.put<int32_t>( data.Devices[i].ID );
+            w.put<int32_t>( nChannels );
+            PackAnalogChannels( w, data.Devices[i].ChannelData, nChannels );
+        }
+        EndSection<Layout>( w, section );
+    }
+
+    // suffix
+    if( Layout::softwareLatency )
+    {
+        w.put<float>( 0.0f );
+    }
+    w.put<uint32_t>( data.Timecode );
+    w.put<uint32_t>( data.TimecodeSubframe );
+    if( Layout::doubleTimestamp )
+    {
+        w.put<double>( data.fTimestamp );
+    }
+    else
+    {
+        w.put<float>( (float) data.fTimestamp );
+    }
+    if( Layout::highResTimestamps )
+    {
+        w.put<uint64_t>( data.CameraMidExposureTimestamp );
+        w.put<uint64_t>( data.CameraDataReceivedTimestamp );
+        w.put<uint64_t>( data.TransmitTimestamp );
+    }
+    if( Layout::precisionTimestamps )
+    {
+        w.put<uint32_t>( data.PrecisionTimestampSecs );
+        w.put<uint32_t>( data.PrecisionTimestampFractionalSecs );
+    }
+    w.put<int16_t>( data.params );
+
+    // end of data tag
+    w.put<int32_t>( 0 );
+}
+
+typedef void ( *FramePacker )( const sFrameOfMocapData& data, std::vector<char>& out );
+
+template <typename Layout>
+struct SelectFramePacker
+{
+    static FramePacker get() { return &PackFrame<Layout>; }
+};
+
+/**
+ * \brief Encode a rigid body description (also used for skeleton and asset bones)
+ * \param w - payload
+ * \param rb - description
+ * \param major - NatNet major version
+*/
+void PackRigidBodyDescription( PayloadWriter& w, const sRigidBodyDescription& rb, int major )
+{
+    if( ( major >= 2 ) || ( major == 0 ) )
+    {
+        w.putString( rb.szName );
+    }
+    w.put<int32_t>( rb.ID );
+    w.put<int32_t>( rb.parentID );
+    w.put( rb.offsetx );
+    w.put( rb.offsety );
+    w.put( rb.offsetz );
+
+    // marker positions, then required labels, then names (NatNet 3.0 and later)
+    if( ( major >= 3 ) || ( major == 0 ) )
+    {
+        int nMarkers = std::max( 0, rb.nMarkers );
+        w.put<int32_t>( nMarkers );
+        for( int i = 0; i < nMarkers; i++ )
+        {
+            w.putBytes( rb.MarkerPositions[i], sizeof( MarkerData ) );
+        }
+        for( int i = 0; i < nMarkers; i++ )
+        {
+            w.put<int32_t>( rb.MarkerRequiredLabels ? rb.MarkerRequiredLabels[i] : 0 );
+        }
+        if( ( major >= 4 ) || ( major == 0 ) )
+        {
+            for( int i = 0; i < nMarkers; i++ )
+            {
+                w.putString( ( rb.szMarkerNames && rb.szMarkerNames[i] ) ? rb.szMarkerNames[i] : "" );
+            }
+        }
+    }
+}
+
+void PackMarkerSetDescription( PayloadWriter& w, const sMarkerSetDescription& markerSet )
+{
+    int nMarkers = std::max( 0, markerSet.nMarkers );
+    w.putString( markerSet.szName );
+    w.put<int32_t>( nMarkers );
+    for( int i = 0; i < nMarkers; i++ )
+    {
+        w.putString( markerSet.szMarkerNames[i] );
+    }
+}
+
+void PackSkeletonDescription( PayloadWriter& w, const sSkeletonDescription& skeleton, int major )
+{
+    int nRigidBodies = ClampCount( skeleton.nRigidBodies, MAX_SKELRIGIDBODIES );
+    w.putString( skeleton.szName );
+    w.put<int32_t>( skeleton.skeletonID );
+    w.put<int32_t>( nRigidBodies );
+    for( int i = 0; i < nRigidBodies; i++ )
+    {
+        PackRigidBodyDescription( w, skeleton.RigidBodies[i], major );
+    }
+}
+
+void PackForcePlateDescription( PayloadWriter& w, const sForcePlateDescription& plate, int major )
+{
+    if( ( major >= 3 ) || ( major == 0 ) )
+    {
+        int nChannels = ClampCount( plate.nChannels, MAX_ANALOG_CHANNELS );
+        w.put<int32_t>( plate.ID );
+        w.putString( plate.strSerialNo, sizeof( plate.strSerialNo ) );
+        w.put( plate.fWidth );
+        w.put( plate.fLength );
+        w.put( plate.fOriginX );
+        w.put( plate.fOriginY );
+        w.put( plate.fOriginZ );
+        w.putBytes( plate.fCalMat, sizeof( plate.fCalMat ) );
+        w.putBytes( plate.fCorners, sizeof( plate.fCorners ) );
+        w.put<int32_t>( plate.iPlateType );
+        w.put<int32_t>( plate.iChannelDataType );
+        w.put<int32_t>( nChannels );
+        for( int i = 0; i < nChannels; i++ )
+        {
+            w.putString( plate.szChannelNames[i] );
+        }
+    }
+}
+
+void PackDeviceDescription( PayloadWriter& w, const sDeviceDescription& device, int major )
+{
+    if( ( major >= 3 ) || ( major == 0 ) )
+    {
+        int nChannels = ClampCount( device.nChannels, MAX_ANALOG_CHANNELS );
+        w.put<int32_t>( device.ID );
+        w.putString( device.strName, sizeof( device.strName ) );
+        w.putString( device.strSerialNo, sizeof( device.strSerialNo ) );
+        w.put<int32_t>( device.iDeviceType );
+        w.put<int32_t>( device.iChannelDataType );
+        w.put<int32_t>( nChannels );
+        for( int i = 0; i < nChannels; i++ )
+        {
+            w.putString( device.szChannelNames[i] );
+        }
+    }
+}
+
+void PackCameraDescription( PayloadWriter& w, const sCameraDescription& camera )
+{
+    w.putString( camera.strName );
+    w.put( camera.x );
+    w.put( camera.y );
+    w.put( camera.z );
+    w.put( camera.qx );
+    w.put( camera.qy );
+    w.put( camera.qz );
+    w.put( camera.qw );
+}
+
+void PackAssetDescription( PayloadWriter& w, const sAssetDescription& asset, int major )
+{
+    int nRigidBodies = ClampCount( asset.nRigidBodies, MAX_SKELRIGIDBODIES );
+    int nMarkers = ClampCount( asset.nMarkers, MAX_MARKERS );
+    w.putString( asset.szName );
+    w.put<int32_t>( asset.AssetType );
+    w.put<int32_t>( asset.AssetID );
+    w.put<int32_t>( nRigidBodies );
+    for( int i = 0; i < nRigidBodies; i++ )
+    {
+        PackRigidBodyDescription( w, asset.RigidBodies[i], major );
+    }
+    w.put<int32_t>( nMarkers );
+    for( int i = 0; i < nMarkers; i++ )
+    {
+        const sMarkerDescription& marker = asset.Markers[i];
+        w.putString( marker.szName );
+        w.put<int32_t>( marker.ID );
+        w.put( marker.x );
+        w.put( marker.y );
+        w.put( marker.z );
+        w.put( marker.size );
+        w.put<int16_t>( marker.params );
+    }
+}
+
+} // namespace
+
+/**
+ * \brief Encode a frame as a NAT_FRAMEOFDATA payload
+ * \param data - frame
+ * \param major - NatNet major version of the payload
+ * \param minor - NatNet minor version of the payload
+ * \param out - output payload
+*/
+void PackFrameData( const sFrameOfMocapData& data, int major, int minor, std::vector<char>& out )
+{
+    DispatchLayout<SelectFramePacker>( major, minor )( data, out );
+}
+
+/**
+ * \brief Encode data descriptions as a NAT_MODELDEF payload.
+ * Every description is preceded by its type and size in bytes, as
+ * UnpackDescription (PacketClient.cpp) reads them.
+ * \param descriptions - data descriptions
+ * \param major - NatNet major version of the payload
+ * \param minor - NatNet minor version of the payload
+ * \param out - output payload
+*/
+void PackDataDescriptions( const sDataDescriptions& descriptions, int major, int /*minor*/, std::vector<char>& out )
+{
+    PayloadWriter w( out );
+
+    int nDescriptions = ClampCount( descriptions.nDataDescriptions, MAX_MODELS );
+    w.put<int32_t>( nDescriptions );
+    for( int i = 0; i < nDescriptions; i++ )
+    {
+        const sDataDescription& description = descriptions.arrDataDescriptions[i];
+        w.put<int32_t>( description.type );
+        size_t sizePosition = w.position();
+        w.put<int32_t>( 0 );
+
+        switch( description.type )
+        {
+        case Descriptor_MarkerSet:
+            PackMarkerSetDescription( w, *description.Data.MarkerSetDescription );
+            break;
+        case Descriptor_RigidBody:
+            PackRigidBodyDescription( w, *description.Data.RigidBodyDescription, major );
+            break;
+        case Descriptor_Skeleton:
+            PackSkeletonDescription( w, *description.Data.SkeletonDescription, major );
+            break;
+        case Descriptor_ForcePlate:
+            PackForcePlateDescription( w, *description.Data.ForcePlateDescription, major );
+            break;
+        case Descriptor_Device:
+            PackDeviceDescription( w, *description.Data.DeviceDescription, major );
+            break;
+        case Descriptor_Camera:
+            PackCameraDescription( w, *description.Data.CameraDescription );
+            break;
+        case Descriptor_Asset:
+            PackAssetDescription( w, *description.Data.AssetDescription, major );
+            break;
+        default:
+            break;
+        }
+
+        w.patch( sizePosition, (int32_t) ( w.position() - sizePosition - 4 ) );
+    }
+}
+
+/**
+ * \brief Encode a server description as a NAT_SERVERINFO payload (sSender_Server)
+ * \param server - description returned by NatNetClient::GetServerDescription
+ * \param out - output payload
+*/
+void PackServerInfo( const sServerDescription& server, std::vector<char>& out )
+{
+    sSender_Server sender = {};
+    memcpy( sender.Common.szName, server.szHostApp, sizeof( sender.Common.szName ) );
+    memcpy( sender.Common.Version, server.HostAppVersion, sizeof( sender.Common.Version ) );
+    memcpy( sender.Common.NatNetVersion, server.NatNetVersion, sizeof( sender.Common.NatNetVersion ) );
+    sender.HighResClockFrequency = server.HighResClockFrequency;
+    if( server.bConnectionInfoValid )
+    {
+        sender.DataPort = server.ConnectionDataPort;
+        sender.IsMulticast = server.ConnectionMulticast;
+        memcpy( sender.MulticastGroupAddress, server.ConnectionMulticastAddress, sizeof( sender.MulticastGroupAddress ) );
+    }
+
+    out.resize( sizeof( sender ) );
+    memcpy( out.data(), &sender, sizeof( sender ) );
+}
+
+} // namespace natnet
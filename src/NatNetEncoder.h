@@ -0,0 +1,25 @@
+/**
+ * \file   NatNetEncoder.h
+ * \brief  Encodes sFrameOfMocapData and sDataDescriptions as NatNet payloads.
+ * The inverse of the decoders in NatNetDecoder.h and PacketClient.cpp, for
+ * producing NAT_FRAMEOFDATA and NAT_MODELDEF payloads from frames and
+ * descriptions obtained through the SDK (e.g. to record them). Fields that
+ * have no counterpart in the SDK structures (rigid body marker lists before
+ * NatNet 3.0, software latency before 3.0) are written as empty or zero.
+ */
+
+#pragma once
+
+#include <NatNetTypes.h>
+
+#include <vector>
+
+namespace natnet
+{
+
+// Payloads, written to out (replacing its contents)
+void PackFrameData( const sFrameOfMocapData& data, int major, int minor, std::vector<char>& out );
+void PackDataDescriptions( const sDataDescriptions& descriptions, int major, int minor, std::vector<char>& out );
+void PackServerInfo( const sServerDescription& server, std::vector<char>& out );
+
+} // namespace natnet
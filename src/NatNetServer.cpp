@@ -0,0 +1,313 @@
+/**
+ * \file   NatNetServer.cpp
+ * \brief  Server side of the NatNet protocol.
+ */
+
+#include "NatNetServer.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace natnet
+{
+
+namespace
+{
+
+const size_t kPacketHeaderBytes = 4;
+
+void PutPacketHeader( std::array<char, kPacketHeaderBytes>& header, uint16_t messageID, size_t nBytes )
+{
+    uint16_t size = (uint16_t) nBytes;
+    memcpy( header.data(), &messageID, 2 );
+    memcpy( header.data() + 2, &size, 2 );
+}
+
+} // namespace
+
+ServerOptions::ServerOptions()
+    : localAddress( boost::asio::ip::address_v4::any() )
+    , multicastAddress( boost::asio::ip::address::from_string( "239.255.42.99" ) )
+    , multicast( true )
+    , commandPort( 1510 )
+    , dataPort( 1511 )
+    , clientTimeout( 10 )
+{
+}
+
+/**
+ * \brief Bind the command port and start answering commands on ioService
+ * \param ioService - runs the command handler; keep it running while the server is used
+ * \param options - ports, addresses and transport
+*/
+NatNetServer::NatNetServer( boost::asio::io_service& ioService, const ServerOptions& options )
+    : options_( options )
+    , commandSocket_( ioService )
+    , dataSocket_( ioService )
+    , command_( MAX_PACKETSIZE + kPacketHeaderBytes )
+    , serverInfo_()
+    , framesSent_( 0 )
+{
+    using boost::asio::ip::udp;
+
+    udp::endpoint commandEndpoint( options_.localAddress, options_.commandPort );
+    commandSocket_.open( commandEndpoint.protocol() );
+    commandSocket_.bind( commandEndpoint );
+
+    dataSocket_.open( udp::v4() );
+    if( options_.multicast )
+    {
+        // so receivers on this machine see the stream too
+        dataSocket_.set_option( boost::asio::ip::multicast::enable_loopback( true ) );
+        if( options_.localAddress.is_v4() && !options_.localAddress.is_unspecified() )
+        {
+            dataSocket_.set_option( boost::asio::ip::multicast::outbound_interface( options_.localAddress.to_v4() ) );
+        }
+    }
+    dataSocket_.bind( udp::endpoint( options_.localAddress, 0 ) );
+
+    memset( &serverInfo_, 0, sizeof( serverInfo_ ) );
+    setServerInfo( serverInfo_ );
+
+    receiveCommand();
+}
+
+void NatNetServer::setServerInfo( const sSender_Server& server )
+{
+    std::lock_guard<std::mutex> lock( mutex_ );
+    serverInfo_ = server;
+    serverInfo_.DataPort = options_.dataPort;
+    serverInfo_.IsMulticast = options_.multicast;
+    memset( serverInfo_.MulticastGroupAddress, 0, sizeof( serverInfo_.MulticastGroupAddress ) );
+    if( options_.multicastAddress.is_v4() )
+    {
+        std::array<unsigned char, 4> bytes = options_.multicastAddress.to_v4().to_bytes();
+        memcpy( serverInfo_.MulticastGroupAddress, bytes.data(), 4 );
+    }
+}
+
+/**
+ * \param payload - NAT_MODELDEF payload, sent to clients that request model definitions
+ * \param nBytes - payload size
+*/
+void NatNetServer::setModelDef( const char* payload, uint32_t nBytes )
+{
+    std::lock_guard<std::mutex> lock( mutex_ );
+    modelDef_.assign( payload, payload + nBytes );
+}
+
+void NatNetServer::setRequestHandler( const RequestHandler& handler )
+{
+    std::lock_guard<std::mutex> lock( mutex_ );
+    requestHandler_ = handler;
+}
+
+/**
+ * \brief Send a NAT_FRAMEOFDATA packet to the multicast group, or to every connected client
+ * \param payload - frame payload, without the packet header
+ * \param nBytes - payload size, at most MAX_PACKETSIZE
+ * \return - false if the payload does not fit a packet or could not be sent
+*/
+bool NatNetServer::sendFrame( const char* payload, uint32_t nBytes )
+{
+    using boost::asio::ip::udp;
+
+    if( nBytes > MAX_PACKETSIZE )
+    {
+        return false;
+    }
+
+    std::array<char, kPacketHeaderBytes> header;
+    PutPacketHeader( header, NAT_FRAMEOFDATA, nBytes );
+    std::array<boost::asio::const_buffer, 2> packet = { {
+        boost::asio::buffer( header ), boost::asio::buffer( payload, nBytes ) } };
+
+    std::lock_guard<std::mutex> lock( mutex_ );
+    lastFrame_.assign( payload, payload + nBytes );
+    framesSent_++;
+
+    boost::system::error_code ec;
+    if( options_.multicast )
+    {
+        dataSocket_.send_to( packet, udp::endpoint( options_.multicastAddress, options_.dataPort ), 0, ec );
+        return !ec;
+    }
+
+    expireClients( std::chrono::steady_clock::now() );
+    bool sent = true;
+    for( size_t i = 0; i < clients_.size(); i++ )
+    {
+        // clients on one host share its data port
+        const boost::asio::ip::address& address = clients_[i].command.address();
+        bool duplicate = false;
+        for( size_t j = 0; j < i; j++ )
+        {
+            duplicate = duplicate || ( clients_[j].command.address() == address );
+        }
+        if( !duplicate )
+        {
+            dataSocket_.send_to( packet, udp::endpoint( address, options_.dataPort ), 0, ec );
+            sent = sent && !ec;
+        }
+    }
+    return sent;
+}
+
+size_t NatNetServer::clientCount() const
+{
+    std::lock_guard<std::mutex> lock( mutex_ );
+    return clients_.size();
+}
+
+uint64_t NatNetServer::framesSent() const
+{
+    std::lock_guard<std::mutex> lock( mutex_ );
+    return framesSent_;
+}
+
+void NatNetServer::receiveCommand()
+{
+    commandSocket_.async_receive_from( boost::asio::buffer( command_ ), sender_,
+        [this]( boost::system::error_code ec, std::size_t length )
+        {
+            if( ec == boost::asio::error::operation_aborted )
+            {
+                return;
+            }
+            if( !ec )
+            {
+                handleCommand( length );
+            }
+            receiveCommand();
+        } );
+}
+
+// io_service thread
+void NatNetServer::handleCommand( size_t length )
+{
+    if( length < kPacketHeaderBytes )
+    {
+        return;
+    }
+    uint16_t messageID = 0;
+    uint16_t nBytes = 0;
+    memcpy( &messageID, command_.data(), 2 );
+    memcpy( &nBytes, command_.data() + 2, 2 );
+    nBytes = (uint16_t) std::min<size_t>( nBytes, length - kPacketHeaderBytes );
+    const char* payload = command_.data() + kPacketHeaderBytes;
+
+    std::unique_lock<std::mutex> lock( mutex_ );
+    switch( messageID )
+    {
+    case NAT_CONNECT:
+        touchClient( true );
+        reply( NAT_SERVERINFO, &serverInfo_, sizeof( serverInfo_ ) );
+        break;
+
+    case NAT_REQUEST_MODELDEF:
+        touchClient( false );
+        reply( NAT_MODELDEF, modelDef_.data(), modelDef_.size() );
+        break;
+
+    case NAT_REQUEST_FRAMEOFDATA:
+        touchClient( false );
+        reply( NAT_FRAMEOFDATA, lastFrame_.data(), lastFrame_.size() );
+        break;
+
+    case NAT_REQUEST:
+    {
+        touchClient( false );
+        std::string request( payload, strnlen( payload, nBytes ) );
+        RequestHandler handler = requestHandler_;
+        lock.unlock();
+
+        std::vector<char> response;
+        if( handler && handler( request, response ) )
+        {
+            lock.lock();
+            reply( NAT_RESPONSE, response.data(), response.size() );
+        }
+        else
+        {
+            lock.lock();
+            reply( NAT_UNRECOGNIZED_REQUEST, nullptr, 0 );
+        }
+    }
+    break;
+
+    case NAT_KEEPALIVE:
+        touchClient( false );
+        break;
+
+    case NAT_ECHOREQUEST:
+    {
+        // request timestamp, then the time it was received
+        touchClient( false );
+        uint64_t echo[2] = { 0, 0 };
+        memcpy( &echo[0], payload, std::min<size_t>( nBytes, sizeof( echo[0] ) ) );
+        echo[1] = (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch() ).count();
+        reply( NAT_ECHORESPONSE, echo, sizeof( echo ) );
+    }
+    break;
+
+    case NAT_DISCONNECT:
+        dropClient();
+        break;
+
+    default:
+        reply( NAT_UNRECOGNIZED_REQUEST, nullptr, 0 );
+        break;
+    }
+}
+
+// Send a packet back to the sender of the current command. mutex_ held.
+void NatNetServer::reply( uint16_t messageID, const void* payload, size_t nBytes )
+{
+    if( nBytes > MAX_PACKETSIZE )
+    {
+        return;
+    }
+    std::array<char, kPacketHeaderBytes> header;
+    PutPacketHeader( header, messageID, nBytes );
+    std::array<boost::asio::const_buffer, 2> packet = { {
+        boost::asio::buffer( header ), boost::asio::buffer( payload, nBytes ) } };
+
+    boost::system::error_code ec;
+    commandSocket_.send_to( packet, sender_, 0, ec );
+}
+
+// The sender of the current command is alive; connect registers it. mutex_ held.
+void NatNetServer::touchClient( bool connect )
+{
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    for( Client& client : clients_ )
+    {
+        if( client.command == sender_ )
+        {
+            client.lastHeard = now;
+            return;
+        }
+    }
+    if( connect )
+    {
+        clients_.push_back( Client{ sender_, now } );
+    }
+}
+
+// mutex_ held
+void NatNetServer::dropClient()
+{
+    clients_.erase( std::remove_if( clients_.begin(), clients_.end(),
+        [this]( const Client& client ) { return client.command == sender_; } ), clients_.end() );
+}
+
+// Multicast clients need not send keepalives, so only unicast clients expire. mutex_ held.
+void NatNetServer::expireClients( std::chrono::steady_clock::time_point now )
+{
+    std::chrono::steady_clock::duration timeout = options_.clientTimeout;
+    clients_.erase( std::remove_if( clients_.begin(), clients_.end(),
+        [now, timeout]( const Client& client ) { return now - client.lastHeard > timeout; } ), clients_.end() );
+}
+
+} // namespace natnet
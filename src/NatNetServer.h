@@ -0,0 +1,91 @@
+/**
+ * \file   NatNetServer.h
+ * \brief  Server side of the NatNet protocol, for tools that stand in for Motive.
+ * Answers the command port the way Motive does (NAT_CONNECT with
+ * NAT_SERVERINFO, NAT_REQUEST_MODELDEF with NAT_MODELDEF, NAT_REQUEST with
+ * the response of a request handler, keepalive and echo) and sends
+ * NAT_FRAMEOFDATA payloads on the data port, to the multicast group or to
+ * every connected unicast client. Commands are handled on the io_service
+ * thread; sendFrame() and the setters may be called from any thread.
+ */
+
+#pragma once
+
+#include <NatNetTypes.h>
+
+#include <boost/asio.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace natnet
+{
+
+struct ServerOptions
+{
+    ServerOptions();
+
+    boost::asio::ip::address localAddress;          // command socket and outgoing interface
+    boost::asio::ip::address multicastAddress;
+    bool multicast;                                 // false: unicast to connected clients
+    unsigned short commandPort;
+    unsigned short dataPort;
+    std::chrono::seconds clientTimeout;             // unicast clients silent this long are dropped
+};
+
+class NatNetServer
+{
+public:
+    // NAT_REQUEST: fill response (a NAT_RESPONSE payload) and return true,
+    // or return false to answer NAT_UNRECOGNIZED_REQUEST
+    typedef std::function<bool( const std::string& request, std::vector<char>& response )> RequestHandler;
+
+    NatNetServer( boost::asio::io_service& ioService, const ServerOptions& options );
+    NatNetServer( const NatNetServer& ) = delete;
+    NatNetServer& operator=( const NatNetServer& ) = delete;
+
+    // NAT_SERVERINFO; DataPort, IsMulticast and MulticastGroupAddress are filled in from the options
+    void setServerInfo( const sSender_Server& server );
+    void setModelDef( const char* payload, uint32_t nBytes );
+    void setRequestHandler( const RequestHandler& handler );
+
+    bool sendFrame( const char* payload, uint32_t nBytes );
+
+    size_t clientCount() const;
+    uint64_t framesSent() const;
+
+private:
+    struct Client
+    {
+        boost::asio::ip::udp::endpoint command;     // where commands came from, replies go back there
+        std::chrono::steady_clock::time_point lastHeard;
+    };
+
+    void receiveCommand();
+    void handleCommand( size_t length );
+    void reply( uint16_t messageID, const void* payload, size_t nBytes );
+    void touchClient( bool connect );
+    void dropClient();
+    void expireClients( std::chrono::steady_clock::time_point now );
+
+    ServerOptions options_;
+    boost::asio::ip::udp::socket commandSocket_;
+    boost::asio::ip::udp::socket dataSocket_;
+    boost::asio::ip::udp::endpoint sender_;
+    std::vector<char> command_;
+
+    mutable std::mutex mutex_;                      // guards everything below
+    sSender_Server serverInfo_;
+    std::vector<char> modelDef_;
+    std::vector<char> lastFrame_;                   // for NAT_REQUEST_FRAMEOFDATA
+    RequestHandler requestHandler_;
+    std::vector<Client> clients_;
+    uint64_t framesSent_;
+};
+
+} // namespace natnet
@@ -0,0 +1,52 @@
+/**
+ * \file   Recording.h
+ * \brief  Binary recording format for NatNet sessions.
+ * A recording is a RecordingFileHeader followed by records, appended in the
+ * order they were received. Each record is a RecordHeader followed by an
+ * unmodified NatNet payload (NAT_SERVERINFO, NAT_MODELDEF, NAT_FRAMEOFDATA
+ * ...) and padding up to the next multiple of kRecordAlignment bytes. The
+ * payloads are decoded with the same decoders as live data; the bitstream
+ * version comes from the NAT_SERVERINFO record and, when it differs, from a
+ * kRecord_BitstreamVersion record. A recording made from several sockets
+ * at once (multicast groups, SO_REUSEPORT shards) tells them apart by the
+ * stream number of each record. All values are little endian.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace natnet
+{
+
+const char kRecordingMagic[8] = { 'N', 'A', 'T', 'N', 'E', 'T', 'R', 'C' };
+const uint32_t kRecordingFormatVersion = 1;
+const uint32_t kRecordAlignment = 8;
+
+// Record message IDs above the NatNet range
+const uint16_t kRecord_BitstreamVersion = 0x8000;  // payload: uint8_t[4] version of the payloads that follow
+
+struct RecordingFileHeader
+{
+    char magic[8];                      // kRecordingMagic
+    uint32_t formatVersion;             // kRecordingFormatVersion
+    uint32_t headerBytes;               // sizeof( RecordingFileHeader ), the first record starts here
+    int64_t startNanoseconds;           // wall clock time the recording was started, since the epoch
+    uint64_t reserved;
+};
+
+struct RecordHeader
+{
+    int64_t nanoseconds;                // receive time, since the epoch
+    uint16_t messageID;                 // NAT_* message ID or kRecord_*
+    uint16_t stream;                    // receiving socket, 0 when there is only one
+    uint32_t nBytes;                    // payload size, without padding
+};
+
+// Size of a record in the file, header and padding included
+inline uint64_t RecordBytes( uint32_t nBytes )
+{
+    return ( sizeof( RecordHeader ) + (uint64_t) nBytes + kRecordAlignment - 1 ) / kRecordAlignment * kRecordAlignment;
+}
+
+} // namespace natnet
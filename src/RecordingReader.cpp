@@ -0,0 +1,390 @@
+/**
+ * \file   RecordingReader.cpp
+ * \brief  Random access to a recording.
+ */
+
+#include "RecordingReader.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace natnet
+{
+
+RecordingReader::RecordingReader()
+    : data_( nullptr )
+    , size_( 0 )
+#ifdef _WIN32
+    , file_( INVALID_HANDLE_VALUE )
+    , mapping_( nullptr )
+#endif
+    , startNanoseconds_( 0 )
+    , truncated_( false )
+    , serverInfo_()
+{
+}
+
+RecordingReader::~RecordingReader()
+{
+    close();
+}
+
+/**
+ * \brief Map a recording and index its frames
+ * \param path - recording to read
+ * \return - false if the file could not be mapped or is not a recording (see error())
+*/
+bool RecordingReader::open( const char* path )
+{
+    close();
+    error_.clear();
+    if( !map( path ) || !buildIndex() )
+    {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void RecordingReader::close()
+{
+    unmap();
+    startNanoseconds_ = 0;
+    truncated_ = false;
+    frames_.clear();
+    byFrameNumber_.clear();
+    byTime_.clear();
+    contexts_.clear();
+    descriptions_.clear();
+    serverInfo_ = RecordedPayload();
+}
+
+RecordedPayload RecordingReader::framePayload( size_t index ) const
+{
+    const RecordedFrame& f = frames_[index];
+    RecordedPayload payload;
+    payload.data = data_ + f.offset;
+    payload.nBytes = f.nBytes;
+    payload.nanoseconds = f.nanoseconds;
+    return payload;
+}
+
+/**
+ * \brief First recorded frame with the given frame number
+ * \return - frame index, frameCount() if the number was not recorded
+*/
+size_t RecordingReader::findFrameNumber( int32_t frameNumber ) const
+{
+    size_t index = seekFrameNumber( frameNumber );
+    if( ( index == frames_.size() ) || ( frames_[index].frameNumber != frameNumber ) )
+    {
+        return frames_.size();
+    }
+    return index;
+}
+
+/**
+ * \brief First recorded frame with a frame number of at least frameNumber.
+ * Frame numbers are compared as recorded; when they restart (Motive was
+ * restarted, or is looping a take) the earliest recorded frame wins.
+ * \return - frame index, frameCount() if all frame numbers are lower
+*/
+size_t RecordingReader::seekFrameNumber( int32_t frameNumber ) const
+{
+    auto it = std::lower_bound( byFrameNumber_.begin(), byFrameNumber_.end(), frameNumber,
+        [this]( uint32_t index, int32_t value ) { return frames_[index].frameNumber < value; } );
+    return ( it == byFrameNumber_.end() ) ? frames_.size() : *it;
+}
+
+/**
+ * \brief First frame received at or after a time
+ * \param nanoseconds - since the epoch, e.g. startNanoseconds() + offset
+ * \return - frame index, frameCount() if all frames were received earlier
+*/
+size_t RecordingReader::seekTime( int64_t nanoseconds ) const
+{
+    auto it = std::lower_bound( byTime_.begin(), byTime_.end(), nanoseconds,
+        [this]( uint32_t index, int64_t value ) { return frames_[index].nanoseconds < value; } );
+    return ( it == byTime_.end() ) ? frames_.size() : *it;
+}
+
+/**
+ * \brief Decode a recorded frame with the bitstream version it was recorded in.
+ * The recording keeps the receive time but not its source, so the frame's
+ * receiveTimestamp is reported as a software timestamp.
+ * \param index - frame index
+ * \param frame - output frame, unchanged unless the result is DecodeStatus_OK
+ * \param sections - FrameSection mask of the sections to decode
+ * \return - DecodeStatus_OK, or why the payload was rejected
+*/
+DecodeStatus RecordingReader::decodeFrame( size_t index, MocapFrame& frame, uint32_t sections /*= FrameSection_All*/ ) const
+{
+    const RecordedFrame& f = frames_[index];
+    DecodeStatus status = DecodeStatus_OK;
+    contexts_[f.context].decoder().unpackChecked( data_ + f.offset, (int) f.nBytes, frame, status, sections );
+    if( status == DecodeStatus_OK )
+    {
+        frame.receiveTimestamp.nanoseconds = f.nanoseconds;
+        frame.receiveTimestamp.source = ReceiveTimestamp_Software;
+    }
+    return status;
+}
+
+/**
+ * \brief The NAT_MODELDEF record last recorded before a frame
+ * \return - false if no data descriptions were recorded before the frame
+*/
+bool RecordingReader::frameDescriptions( size_t index, RecordedPayload& payload ) const
+{
+    uint32_t descriptions = frames_[index].descriptions;
+    if( descriptions == kNoDescriptions )
+    {
+        return false;
+    }
+    payload = descriptions_[descriptions];
+    return true;
+}
+
+bool RecordingReader::map( const char* path )
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileA( path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL, nullptr );
+    if( file == INVALID_HANDLE_VALUE )
+    {
+        error_ = "unable to open file";
+        return false;
+    }
+    file_ = file;
+
+    LARGE_INTEGER size;
+    if( !GetFileSizeEx( file, &size ) || ( size.QuadPart == 0 ) )
+    {
+        error_ = "unable to read file size, or file is empty";
+        return false;
+    }
+    mapping_ = CreateFileMappingA( file, nullptr, PAGE_READONLY, 0, 0, nullptr );
+    if( !mapping_ )
+    {
+        error_ = "unable to map file";
+        return false;
+    }
+    data_ = static_cast<const char*>( MapViewOfFile( mapping_, FILE_MAP_READ, 0, 0, 0 ) );
+    if( !data_ )
+    {
+        error_ = "unable to map file";
+        return false;
+    }
+    size_ = (uint64_t) size.QuadPart;
+#else
+    int fd = ::open( path, O_RDONLY );
+    if( fd < 0 )
+    {
+        error_ = std::string( "unable to open file: " ) + strerror( errno );
+        return false;
+    }
+
+    struct stat st;
+    if( ( fstat( fd, &st ) != 0 ) || ( st.st_size == 0 ) )
+    {
+        error_ = "unable to read file size, or file is empty";
+        ::close( fd );
+        return false;
+    }
+    void* ptr = mmap( nullptr, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+    ::close( fd );
+    if( ptr == MAP_FAILED )
+    {
+        error_ = std::string( "unable to map file: " ) + strerror( errno );
+        return false;
+    }
+    data_ = static_cast<const char*>( ptr );
+    size_ = (uint64_t) st.st_size;
+#endif
+    return true;
+}
+
+void RecordingReader::unmap()
+{
+#ifdef _WIN32
+    if( data_ )
+    {
+        UnmapViewOfFile( data_ );
+    }
+    if( mapping_ )
+    {
+        CloseHandle( mapping_ );
+        mapping_ = nullptr;
+    }
+    if( file_ != INVALID_HANDLE_VALUE )
+    {
+        CloseHandle( file_ );
+        file_ = INVALID_HANDLE_VALUE;
+    }
+#else
+    if( data_ )
+    {
+        munmap( const_cast<char*>( data_ ), (size_t) size_ );
+    }
+#endif
+    data_ = nullptr;
+    size_ = 0;
+}
+
+// Scan the record headers once, in file order
+bool RecordingReader::buildIndex()
+{
+    RecordingFileHeader header;
+    if( size_ < sizeof( header ) )
+    {
+        error_ = "not a recording";
+        return false;
+    }
+    memcpy( &header, data_, sizeof( header ) );
+    if( memcmp( header.magic, kRecordingMagic, sizeof( header.magic ) ) != 0 )
+    {
+        error_ = "not a recording";
+        return false;
+    }
+    if( header.formatVersion != kRecordingFormatVersion )
+    {
+        error_ = "unsupported recording format version " + std::to_string( header.formatVersion );
+        return false;
+    }
+    if( ( header.headerBytes < sizeof( header ) ) || ( header.headerBytes > size_ ) )
+    {
+        error_ = "invalid recording header";
+        return false;
+    }
+    startNanoseconds_ = header.startNanoseconds;
+
+#ifndef _WIN32
+    // one pass over the whole file, then random access
+    madvise( const_cast<char*>( data_ ), (size_t) size_, MADV_SEQUENTIAL );
+#endif
+
+    contexts_.push_back( DecoderContext() );
+    uint32_t descriptions = kNoDescriptions;
+
+    uint64_t offset = header.headerBytes;
+    while( offset < size_ )
+    {
+        RecordHeader record;
+        if( size_ - offset < sizeof( record ) )
+        {
+            truncated_ = true;
+            break;
+        }
+        memcpy( &record, data_ + offset, sizeof( record ) );
+        uint64_t payloadOffset = offset + sizeof( record );
+        if( size_ - payloadOffset < record.nBytes )
+        {
+            truncated_ = true;
+            break;
+        }
+        const char* payload = data_ + payloadOffset;
+
+        switch( record.messageID )
+        {
+        case NAT_FRAMEOFDATA:
+            if( record.nBytes >= sizeof( int32_t ) )
+            {
+                RecordedFrame f;
+                f.offset = payloadOffset;
+                f.nanoseconds = record.nanoseconds;
+                memcpy( &f.frameNumber, payload, sizeof( f.frameNumber ) );
+                f.nBytes = record.nBytes;
+                f.context = (uint32_t) ( contexts_.size() - 1 );
+                f.descriptions = descriptions;
+                f.stream = record.stream;
+                frames_.push_back( f );
+            }
+            break;
+
+        case NAT_MODELDEF:
+            descriptions = (uint32_t) descriptions_.size();
+            descriptions_.push_back( RecordedPayload{ payload, record.nBytes, record.nanoseconds } );
+            break;
+
+        case NAT_SERVERINFO:
+            if( record.nBytes >= sizeof( sSender ) )
+            {
+                sSender sender;
+                memcpy( &sender, payload, sizeof( sender ) );
+                DecoderContext context = contexts_.back();
+                context.setServerInfo( sender );
+                startContext( context );
+                serverInfo_ = RecordedPayload{ payload, record.nBytes, record.nanoseconds };
+            }
+            break;
+
+        case kRecord_BitstreamVersion:
+            if( record.nBytes >= 4 )
+            {
+                int version[4];
+                for( int i = 0; i < 4; i++ )
+                {
+                    version[i] = (uint8_t) payload[i];
+                }
+                DecoderContext context = contexts_.back();
+                context.setBitstreamVersion( version );
+                startContext( context );
+            }
+            break;
+
+        default:
+            break;
+        }
+
+        offset += RecordBytes( record.nBytes );
+    }
+
+    if( frames_.size() > UINT32_MAX )
+    {
+        error_ = "too many frames";
+        return false;
+    }
+    byFrameNumber_.resize( frames_.size() );
+    for( size_t i = 0; i < frames_.size(); i++ )
+    {
+        byFrameNumber_[i] = (uint32_t) i;
+    }
+    byTime_ = byFrameNumber_;
+    std::stable_sort( byFrameNumber_.begin(), byFrameNumber_.end(),
+        [this]( uint32_t a, uint32_t b ) { return frames_[a].frameNumber < frames_[b].frameNumber; } );
+    std::stable_sort( byTime_.begin(), byTime_.end(),
+        [this]( uint32_t a, uint32_t b ) { return frames_[a].nanoseconds < frames_[b].nanoseconds; } );
+
+#ifndef _WIN32
+    madvise( const_cast<char*>( data_ ), (size_t) size_, MADV_RANDOM );
+#endif
+    return true;
+}
+
+// Context for the frames that follow; replaces the current one if no frame used it
+void RecordingReader::startContext( const DecoderContext& context )
+{
+    if( frames_.empty() || ( frames_.back().context != contexts_.size() - 1 ) )
+    {
+        contexts_.back() = context;
+    }
+    else
+    {
+        contexts_.push_back( context );
+    }
+}
+
+} // namespace natnet
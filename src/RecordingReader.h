@@ -0,0 +1,110 @@
+/**
+ * \file   RecordingReader.h
+ * \brief  Random access to a recording (see Recording.h).
+ * open() maps the file into memory and scans the record headers once,
+ * building an index of the NAT_FRAMEOFDATA records by position, frame number
+ * and receive time. Frames of all streams share the index; RecordedFrame::stream
+ * tells them apart. Payloads are read in place from the mapping; nothing is
+ * copied until a frame is decoded, with the same decoder (and the bitstream
+ * version in effect at that point of the recording) as live data. A
+ * recording cut short by a crash is read up to its last complete record.
+ */
+
+#pragma once
+
+#include "DecoderContext.h"
+#include "Recording.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace natnet
+{
+
+// A record payload inside the mapping
+struct RecordedPayload
+{
+    const char* data;
+    uint32_t nBytes;
+    int64_t nanoseconds;                // receive time, since the epoch
+};
+
+// Index entry of a NAT_FRAMEOFDATA record
+struct RecordedFrame
+{
+    uint64_t offset;                    // of the payload in the file
+    int64_t nanoseconds;                // receive time, since the epoch
+    int32_t frameNumber;
+    uint32_t nBytes;
+    uint32_t context;                   // decoder context (bitstream version) of the payload
+    uint32_t descriptions;              // NAT_MODELDEF record in effect, kNoDescriptions if none
+    uint16_t stream;                    // receiving socket (RecordHeader::stream)
+};
+
+const uint32_t kNoDescriptions = 0xFFFFFFFF;
+
+class RecordingReader
+{
+public:
+    RecordingReader();
+    ~RecordingReader();
+    RecordingReader( const RecordingReader& ) = delete;
+    RecordingReader& operator=( const RecordingReader& ) = delete;
+
+    bool open( const char* path );
+    void close();
+    bool isOpen() const { return data_ != nullptr; }
+    const std::string& error() const { return error_; }
+
+    int64_t startNanoseconds() const { return startNanoseconds_; }
+    bool truncated() const { return truncated_; }
+
+    // Frames, in the order they were recorded
+    size_t frameCount() const { return frames_.size(); }
+    const RecordedFrame& frame( size_t index ) const { return frames_[index]; }
+    RecordedPayload framePayload( size_t index ) const;
+    const DecoderContext& frameContext( size_t index ) const { return contexts_[frames_[index].context]; }
+
+    // Seek, O(log n). Return frameCount() when no frame qualifies.
+    size_t findFrameNumber( int32_t frameNumber ) const;
+    size_t seekFrameNumber( int32_t frameNumber ) const;
+    size_t seekTime( int64_t nanoseconds ) const;
+
+    DecodeStatus decodeFrame( size_t index, MocapFrame& frame, uint32_t sections = FrameSection_All ) const;
+
+    // NAT_MODELDEF records, and the one in effect for a frame
+    size_t descriptionsCount() const { return descriptions_.size(); }
+    RecordedPayload descriptions( size_t index ) const { return descriptions_[index]; }
+    bool frameDescriptions( size_t index, RecordedPayload& payload ) const;
+
+    // NAT_SERVERINFO record, nBytes 0 if the recording has none
+    RecordedPayload serverInfo() const { return serverInfo_; }
+
+private:
+    bool map( const char* path );
+    void unmap();
+    bool buildIndex();
+    void startContext( const DecoderContext& context );
+
+    const char* data_;
+    uint64_t size_;
+#ifdef _WIN32
+    void* file_;
+    void* mapping_;
+#endif
+
+    std::string error_;
+    int64_t startNanoseconds_;
+    bool truncated_;                    // the file ends inside a record
+
+    std::vector<RecordedFrame> frames_;
+    std::vector<uint32_t> byFrameNumber_;   // frames_ indices, stable sorted by frame number
+    std::vector<uint32_t> byTime_;          // frames_ indices, stable sorted by receive time
+    std::vector<DecoderContext> contexts_;
+    std::vector<RecordedPayload> descriptions_;
+    RecordedPayload serverInfo_;
+};
+
+} // namespace natnet
@@ -0,0 +1,303 @@
+/**
+ * \file   RecordingWriter.cpp
+ * \brief  Appends NatNet payloads to a recording.
+ */
+
+#include "RecordingWriter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace natnet
+{
+
+namespace
+{
+
+char* AllocateBuffer( size_t bytes )
+{
+#ifdef _WIN32
+    void* ptr = _aligned_malloc( bytes, kRecordingBufferAlignment );
+#else
+    void* ptr = nullptr;
+    if( posix_memalign( &ptr, kRecordingBufferAlignment, bytes ) != 0 )
+    {
+        ptr = nullptr;
+    }
+#endif
+    if( ptr == nullptr )
+    {
+        throw std::bad_alloc();
+    }
+    return static_cast<char*>( ptr );
+}
+
+void FreeBuffer( char* ptr )
+{
+#ifdef _WIN32
+    _aligned_free( ptr );
+#else
+    free( ptr );
+#endif
+}
+
+} // namespace
+
+/**
+ * \brief Current wall clock time, the timestamp of records without a receive timestamp
+ * \return - nanoseconds since the epoch
+*/
+int64_t WallClockNanoseconds()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch() ).count();
+}
+
+/**
+ * \param bufferBytes - size of each write to the file, a multiple of kRecordingBufferAlignment
+ * \param maxBuffers - buffers allocated at most, at least 2
+*/
+RecordingWriter::RecordingWriter( size_t bufferBytes /*= kRecordingBufferBytes*/,
+    size_t maxBuffers /*= kRecordingMaxBuffers*/ )
+    : bufferBytes_( ( bufferBytes + kRecordingBufferAlignment - 1 ) / kRecordingBufferAlignment * kRecordingBufferAlignment )
+    , maxBuffers_( std::max<size_t>( maxBuffers, 2 ) )
+    , file_( nullptr )
+    , current_()
+    , closing_( true )
+    , failed_( false )
+    , bytesWritten_( 0 )
+    , recordsDropped_( 0 )
+{
+}
+
+RecordingWriter::~RecordingWriter()
+{
+    close();
+    for( char* buffer : allocated_ )
+    {
+        FreeBuffer( buffer );
+    }
+}
+
+/**
+ * \brief Create the recording file, write its header and start the writer thread
+ * \param path - file to create (an existing file is replaced)
+ * \return - false if the file could not be created
+*/
+bool RecordingWriter::open( const char* path )
+{
+    close();
+
+    file_ = fopen( path, "wb" );
+    if( !file_ )
+    {
+        return false;
+    }
+    // every write is a whole buffer, stdio buffering would only add a copy
+    setvbuf( file_, nullptr, _IONBF, 0 );
+
+    failed_.store( false, std::memory_order_relaxed );
+    bytesWritten_.store( 0, std::memory_order_relaxed );
+    recordsDropped_.store( 0, std::memory_order_relaxed );
+
+    RecordingFileHeader header;
+    memset( &header, 0, sizeof( header ) );
+    memcpy( header.magic, kRecordingMagic, sizeof( header.magic ) );
+    header.formatVersion = kRecordingFormatVersion;
+    header.headerBytes = sizeof( header );
+    header.startNanoseconds = WallClockNanoseconds();
+
+    {
+        std::lock_guard<std::mutex> lock( mutex_ );
+        current_ = takeBuffer();
+        append( &header, sizeof( header ) );
+        closing_ = false;
+    }
+
+    thread_ = std::thread( &RecordingWriter::run, this );
+    return true;
+}
+
+/**
+ * \brief Write the records still buffered, stop the writer thread and close the file
+*/
+void RecordingWriter::close()
+{
+    if( !file_ )
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock( mutex_ );
+        if( current_.size > 0 )
+        {
+            full_.push_back( current_ );
+        }
+        else
+        {
+            free_.push_back( current_ );
+        }
+        current_ = Buffer();
+        closing_ = true;
+    }
+    ready_.notify_one();
+    thread_.join();
+
+    fclose( file_ );
+    file_ = nullptr;
+}
+
+/**
+ * \brief Append a record
+ * \param messageID - NAT_* message ID or kRecord_*
+ * \param payload - message payload, without the packet header
+ * \param nBytes - payload size
+ * \param nanoseconds - receive time since the epoch (see WallClockNanoseconds)
+ * \param stream - socket the payload was received on, 0 when there is only one
+*/
+void RecordingWriter::write( int messageID, const void* payload, uint32_t nBytes, int64_t nanoseconds,
+    uint16_t stream /*= 0*/ )
+{
+    RecordHeader header;
+    header.nanoseconds = nanoseconds;
+    header.messageID = (uint16_t) messageID;
+    header.stream = stream;
+    header.nBytes = nBytes;
+
+    static const char kPadding[kRecordAlignment] = {};
+    size_t padding = (size_t) ( RecordBytes( nBytes ) - sizeof( header ) - nBytes );
+
+    std::lock_guard<std::mutex> lock( mutex_ );
+    if( closing_ )
+    {
+        return;
+    }
+    if( !reserve( sizeof( header ) + nBytes + padding ) )
+    {
+        recordsDropped_.fetch_add( 1, std::memory_order_relaxed );
+        return;
+    }
+    append( &header, sizeof( header ) );
+    append( payload, nBytes );
+    append( kPadding, padding );
+}
+
+/**
+ * \brief Append a kRecord_BitstreamVersion record, for when the payloads that
+ * follow use a version other than the one announced by NAT_SERVERINFO
+ * \param version - bitstream version [major.minor.build.revision]
+ * \param nanoseconds - time of the change since the epoch
+*/
+void RecordingWriter::writeBitstreamVersion( const int version[4], int64_t nanoseconds )
+{
+    uint8_t payload[4];
+    for( int i = 0; i < 4; i++ )
+    {
+        payload[i] = (uint8_t) version[i];
+    }
+    write( kRecord_BitstreamVersion, payload, sizeof( payload ), nanoseconds );
+}
+
+// Whether a record fits into the current buffer and the buffers that may
+// still be taken, so records are written whole or not at all. mutex_ held.
+bool RecordingWriter::reserve( size_t nBytes )
+{
+    size_t room = bufferBytes_ - current_.size;
+    if( nBytes < room )
+    {
+        return true;
+    }
+    // append() takes a new buffer whenever one fills up, also after the last byte
+    size_t needed = ( nBytes - room ) / bufferBytes_ + 1;
+    size_t available = free_.size() + ( maxBuffers_ - allocated_.size() );
+    return needed <= available;
+}
+
+// Copy into the current buffer, handing full buffers to the writer thread. mutex_ held.
+void RecordingWriter::append( const void* data, size_t nBytes )
+{
+    const char* bytes = static_cast<const char*>( data );
+    while( nBytes > 0 )
+    {
+        size_t n = std::min( nBytes, bufferBytes_ - current_.size );
+        memcpy( current_.data + current_.size, bytes, n );
+        current_.size += n;
+        bytes += n;
+        nBytes -= n;
+        if( current_.size == bufferBytes_ )
+        {
+            submit();
+        }
+    }
+}
+
+// mutex_ held
+void RecordingWriter::submit()
+{
+    full_.push_back( current_ );
+    current_ = takeBuffer();
+    ready_.notify_one();
+}
+
+// mutex_ held
+RecordingWriter::Buffer RecordingWriter::takeBuffer()
+{
+    Buffer buffer;
+    if( !free_.empty() )
+    {
+        buffer = free_.back();
+        free_.pop_back();
+    }
+    else
+    {
+        buffer.data = AllocateBuffer( bufferBytes_ );
+        allocated_.push_back( buffer.data );
+    }
+    buffer.size = 0;
+    return buffer;
+}
+
+/**
+ * \brief Writer thread: write full buffers until closed
+*/
+void RecordingWriter::run()
+{
+    std::unique_lock<std::mutex> lock( mutex_ );
+    for( ;; )
+    {
+        ready_.wait( lock, [this] { return !full_.empty() || closing_; } );
+        if( full_.empty() )
+        {
+            return;
+        }
+
+        Buffer buffer = full_.front();
+        full_.pop_front();
+        lock.unlock();
+
+        if( ok() )
+        {
+            if( fwrite( buffer.data, 1, buffer.size, file_ ) == buffer.size )
+            {
+                bytesWritten_.fetch_add( buffer.size, std::memory_order_relaxed );
+            }
+            else
+            {
+                failed_.store( true, std::memory_order_relaxed );
+            }
+        }
+
+        lock.lock();
+        free_.push_back( buffer );
+    }
+}
+
+} // namespace natnet
@@ -0,0 +1,90 @@
+/**
+ * \file   RecordingWriter.h
+ * \brief  Appends NatNet payloads to a recording (see Recording.h).
+ * write() copies the record into a large aligned buffer and returns; a
+ * dedicated writer thread writes full buffers to the file in one call each.
+ * When the disk falls behind, more buffers are allocated rather than making
+ * the caller wait for I/O, up to maxBuffers; while all of them wait for the
+ * disk, records are dropped and counted (recordsDropped()) so that a slow
+ * disk cannot grow memory without bound.
+ * write() may be called from any thread, also while the writer is closed
+ * (the record is then discarded); open() and close() belong to one thread.
+ */
+
+#pragma once
+
+#include "Recording.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace natnet
+{
+
+const size_t kRecordingBufferBytes = 1 << 20;
+const size_t kRecordingBufferAlignment = 4096;
+const size_t kRecordingMaxBuffers = 64;        // 64 MB of records waiting for the disk by default
+
+int64_t WallClockNanoseconds();
+
+class RecordingWriter
+{
+public:
+    explicit RecordingWriter( size_t bufferBytes = kRecordingBufferBytes, size_t maxBuffers = kRecordingMaxBuffers );
+    ~RecordingWriter();
+    RecordingWriter( const RecordingWriter& ) = delete;
+    RecordingWriter& operator=( const RecordingWriter& ) = delete;
+
+    bool open( const char* path );
+    void close();
+    bool isOpen() const { return file_ != nullptr; }
+
+    // Any thread
+    void write( int messageID, const void* payload, uint32_t nBytes, int64_t nanoseconds, uint16_t stream = 0 );
+    void writeBitstreamVersion( const int version[4], int64_t nanoseconds );
+
+    // false once a write to the file failed; later records are discarded
+    bool ok() const { return !failed_.load( std::memory_order_relaxed ); }
+    uint64_t bytesWritten() const { return bytesWritten_.load( std::memory_order_relaxed ); }
+    // records discarded because every buffer was waiting for the disk
+    uint64_t recordsDropped() const { return recordsDropped_.load( std::memory_order_relaxed ); }
+
+private:
+    struct Buffer
+    {
+        char* data;
+        size_t size;
+    };
+
+    bool reserve( size_t nBytes );
+    void append( const void* data, size_t nBytes );
+    void submit();
+    Buffer takeBuffer();
+    void run();
+
+    size_t bufferBytes_;
+    size_t maxBuffers_;
+    FILE* file_;
+    std::thread thread_;
+
+    std::mutex mutex_;                  // guards everything below
+    std::condition_variable ready_;     // full_ not empty, or closing_
+    Buffer current_;                    // being filled by write()
+    std::deque<Buffer> full_;           // waiting for the writer thread
+    std::vector<Buffer> free_;
+    std::vector<char*> allocated_;
+    bool closing_;                      // true while not open; write() discards records
+
+    std::atomic<bool> failed_;
+    std::atomic<uint64_t> bytesWritten_;
+    std::atomic<uint64_t> recordsDropped_;
+};
+
+} // namespace natnet
@@ -0,0 +1,188 @@
+/**
+ * \file   ThreadScheduling.cpp
+ * \brief  Where and how urgently receive threads run.
+ */
+
+#include "ThreadScheduling.h"
+
+#include <cerrno>
+#include <cstdlib>
+
+#if defined( _WIN32 )
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined( __linux__ )
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace natnet
+{
+
+namespace
+{
+
+// CPUs a thread can be pinned to (see PinNativeThread)
+#if defined( _WIN32 )
+const long kMaxCpus = 8 * sizeof( DWORD_PTR );
+#elif defined( __linux__ )
+const long kMaxCpus = CPU_SETSIZE;
+#else
+const long kMaxCpus = 1024;
+#endif
+
+#if defined( _WIN32 )
+bool PinNativeThread( HANDLE thread, int cpu )
+{
+    if( ( cpu < 0 ) || ( cpu >= (int) ( 8 * sizeof( DWORD_PTR ) ) ) )
+    {
+        return false;
+    }
+    return SetThreadAffinityMask( thread, (DWORD_PTR) 1 << cpu ) != 0;
+}
+#elif defined( __linux__ )
+bool PinNativeThread( pthread_t thread, int cpu )
+{
+    if( ( cpu < 0 ) || ( cpu >= CPU_SETSIZE ) )
+    {
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO( &set );
+    CPU_SET( cpu, &set );
+    return pthread_setaffinity_np( thread, sizeof( set ), &set ) == 0;
+}
+#endif
+
+#if defined( _WIN32 )
+bool SetNativeRealtimePriority( HANDLE thread, int /*priority*/ )
+{
+    return SetThreadPriority( thread, THREAD_PRIORITY_TIME_CRITICAL ) != 0;
+}
+#elif defined( __linux__ )
+bool SetNativeRealtimePriority( pthread_t thread, int priority )
+{
+    if( ( priority < sched_get_priority_min( SCHED_FIFO ) ) || ( priority > sched_get_priority_max( SCHED_FIFO ) ) )
+    {
+        errno = EINVAL;
+        return false;
+    }
+    sched_param param;
+    param.sched_priority = priority;
+    // report the error in errno like the other calls
+    int error = pthread_setschedparam( thread, SCHED_FIFO, &param );
+    errno = error;
+    return error == 0;
+}
+#endif
+
+} // namespace
+
+/**
+ * \brief Run a thread on one CPU only
+ * \param thread - running thread
+ * \param cpu - CPU number, from 0
+ * \return - false if the CPU does not exist or pinning is not supported
+*/
+bool PinThread( std::thread& thread, int cpu )
+{
+#if defined( _WIN32 ) || defined( __linux__ )
+    return PinNativeThread( thread.native_handle(), cpu );
+#else
+    (void) thread;
+    (void) cpu;
+    return false;
+#endif
+}
+
+bool PinCurrentThread( int cpu )
+{
+#if defined( _WIN32 )
+    return PinNativeThread( GetCurrentThread(), cpu );
+#elif defined( __linux__ )
+    return PinNativeThread( pthread_self(), cpu );
+#else
+    (void) cpu;
+    return false;
+#endif
+}
+
+/**
+ * \brief Schedule a thread ahead of all ordinary threads
+ * \param thread - running thread
+ * \param priority - SCHED_FIFO priority, 1 to 99
+ * \return - false if the priority is out of range, not permitted (see errno) or not supported
+*/
+bool SetRealtimePriority( std::thread& thread, int priority )
+{
+#if defined( _WIN32 ) || defined( __linux__ )
+    return SetNativeRealtimePriority( thread.native_handle(), priority );
+#else
+    (void) thread;
+    (void) priority;
+    return false;
+#endif
+}
+
+bool SetCurrentThreadRealtimePriority( int priority )
+{
+#if defined( _WIN32 )
+    return SetNativeRealtimePriority( GetCurrentThread(), priority );
+#elif defined( __linux__ )
+    return SetNativeRealtimePriority( pthread_self(), priority );
+#else
+    (void) priority;
+    return false;
+#endif
+}
+
+bool ParseCpuList( const std::string& text, std::vector<int>& cpus )
+{
+    cpus.clear();
+    const char* ptr = text.c_str();
+    while( *ptr )
+    {
+        char* end = nullptr;
+        long first = strtol( ptr, &end, 10 );
+        if( ( end == ptr ) || ( first < 0 ) )
+        {
+            return false;
+        }
+        long last = first;
+        ptr = end;
+        if( *ptr == '-' )
+        {
+            last = strtol( ptr + 1, &end, 10 );
+            if( ( end == ptr + 1 ) || ( last < first ) )
+            {
+                return false;
+            }
+            ptr = end;
+        }
+        if( last >= kMaxCpus )
+        {
+            return false;
+        }
+        for( long cpu = first; cpu <= last; cpu++ )
+        {
+            cpus.push_back( (int) cpu );
+        }
+        if( *ptr == ',' )
+        {
+            ptr++;
+            if( !*ptr )
+            {
+                return false;
+            }
+        }
+        else if( *ptr )
+        {
+            return false;
+        }
+    }
+    return !cpus.empty();
+}
+
+} // namespace natnet
@@ -0,0 +1,33 @@
+/**
+ * \file   ThreadScheduling.h
+ * \brief  Where and how urgently receive threads run.
+ * Pins threads to a CPU, so a receive thread keeps its caches and does not
+ * compete with the threads of other streams, and raises them to real-time
+ * priority (SCHED_FIFO on Linux, which needs CAP_SYS_NICE or an rtprio
+ * limit), so they preempt ordinary threads as soon as data arrives. A
+ * real-time thread that spins starves everything else on its CPU: give it
+ * a CPU of its own. Supported on Linux and Windows; elsewhere the calls
+ * fail and the thread runs as the system schedules it.
+ */
+
+#pragma once
+
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace natnet
+{
+
+bool PinThread( std::thread& thread, int cpu );
+bool PinCurrentThread( int cpu );
+
+// priority: SCHED_FIFO priority, 1 (lowest) to 99; Windows uses THREAD_PRIORITY_TIME_CRITICAL
+bool SetRealtimePriority( std::thread& thread, int priority );
+bool SetCurrentThreadRealtimePriority( int priority );
+
+// "2,3,6-8" -> { 2, 3, 6, 7, 8 }; false if the list is malformed or names a CPU
+// that threads cannot be pinned to (CPU_SETSIZE and above on Linux)
+bool ParseCpuList( const std::string& text, std::vector<int>& cpus );
+
+} // namespace natnet
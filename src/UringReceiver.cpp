@@ -0,0 +1,610 @@
+/**
+ * \file   UringReceiver.cpp
+ * \brief  Receives the datagrams of many sockets on one io_uring (Linux).
+ */
+
+#include "UringReceiver.h"
+
+#if defined( __linux__ ) && defined( __has_include )
+#if __has_include( <linux/io_uring.h> )
+#include <linux/io_uring.h>
+#endif
+#endif
+
+// Multishot recvmsg and provided buffer rings came with the Linux 6.0 headers
+#if defined( IORING_RECV_MULTISHOT )
+
+#include "DatagramBatch.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <iostream>
+
+namespace natnet
+{
+
+namespace
+{
+
+const unsigned kSubmissionEntries = 64;
+const unsigned short kBufferGroup = 0;
+const int kMaxBufferCount = 1 << 15;                // buffer ids are 16 bit
+const uint64_t kProbeData = ~(uint64_t) 0 - 1;      // user_data of requests that are not socket receives
+const uint64_t kCancelData = ~(uint64_t) 0;
+
+// There is no glibc wrapper for the io_uring system calls
+int SetupRing( unsigned entries, io_uring_params* params )
+{
+    return (int) syscall( __NR_io_uring_setup, entries, params );
+}
+
+int EnterRing( int fd, unsigned toSubmit, unsigned minComplete, unsigned flags, void* arg, size_t argSize )
+{
+    return (int) syscall( __NR_io_uring_enter, fd, toSubmit, minComplete, flags, arg, argSize );
+}
+
+int RegisterRing( int fd, unsigned opcode, void* arg, unsigned nArgs )
+{
+    return (int) syscall( __NR_io_uring_register, fd, opcode, arg, nArgs );
+}
+
+std::string SystemError( const char* call )
+{
+    return std::string( call ) + ": " + strerror( errno );
+}
+
+} // namespace
+
+struct UringReceiver::Ring
+{
+    struct Socket
+    {
+        int fd;
+        DatagramHandler handler;
+        msghdr msg;                 // sizes of the name and ancillary data areas of each buffer
+    };
+
+    Ring();
+    ~Ring();
+
+    bool setup( int count, int payloadSize, std::string& error );
+    bool probeMultishot();
+    io_uring_sqe* nextSqe();
+    void armReceive( uint64_t index );
+    int enter( unsigned minComplete, int timeoutMilliseconds );
+    int reap();
+    int complete( const io_uring_cqe& cqe );
+    void recycle( unsigned bufferId );
+
+    int fd;
+    void* sqMap;
+    size_t sqMapSize;
+    void* cqMap;
+    size_t cqMapSize;
+    io_uring_sqe* sqes;
+    size_t sqesSize;
+    unsigned* sqHead;
+    unsigned* sqTail;
+    unsigned* sqArray;
+    unsigned sqMask;
+    unsigned sqEntries;
+    unsigned* cqHead;
+    unsigned* cqTail;
+    io_uring_cqe* cqes;
+    unsigned cqMask;
+
+    // Provided buffers: the ring the kernel takes them from, and their memory
+    io_uring_buf_ring* bufferRing;
+    size_t bufferRingSize;
+    unsigned short bufferTail;
+    unsigned bufferMask;
+    size_t bufferSize;
+    std::unique_ptr<char[]> buffers;    // not zeroed
+
+    std::deque<Socket> sockets;         // index is the user_data of their receive
+};
+
+UringReceiver::Ring::Ring()
+    : fd( -1 )
+    , sqMap( MAP_FAILED )
+    , sqMapSize( 0 )
+    , cqMap( MAP_FAILED )
+    , cqMapSize( 0 )
+    , sqes( (io_uring_sqe*) MAP_FAILED )
+    , sqesSize( 0 )
+    , sqHead( nullptr )
+    , sqTail( nullptr )
+    , sqArray( nullptr )
+    , sqMask( 0 )
+    , sqEntries( 0 )
+    , cqHead( nullptr )
+    , cqTail( nullptr )
+    , cqes( nullptr )
+    , cqMask( 0 )
+    , bufferRing( (io_uring_buf_ring*) MAP_FAILED )
+    , bufferRingSize( 0 )
+    , bufferTail( 0 )
+    , bufferMask( 0 )
+    , bufferSize( 0 )
+{
+}
+
+UringReceiver::Ring::~Ring()
+{
+    if( ( fd >= 0 ) && ( sqes != MAP_FAILED ) && !sockets.empty() )
+    {
+        // The receives write into the buffers until they are cancelled;
+        // cancelling completes them before the cancel itself completes
+        io_uring_sqe* sqe = nextSqe();
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->fd = -1;
+        sqe->cancel_flags = IORING_ASYNC_CANCEL_ANY;
+        sqe->user_data = kCancelData;
+        __atomic_store_n( sqTail, *sqTail + 1, __ATOMIC_RELEASE );
+        enter( 1, 1000 );
+    }
+    if( fd >= 0 )
+    {
+        ::close( fd );
+    }
+    if( bufferRing != MAP_FAILED )
+    {
+        munmap( bufferRing, bufferRingSize );
+    }
+    if( sqes != MAP_FAILED )
+    {
+        munmap( sqes, sqesSize );
+    }
+    if( ( cqMap != MAP_FAILED ) && ( cqMap != sqMap ) )
+    {
+        munmap( cqMap, cqMapSize );
+    }
+    if( sqMap != MAP_FAILED )
+    {
+        munmap( sqMap, sqMapSize );
+    }
+}
+
+/**
+ * \brief Create the ring, map its queues and register the provided buffers
+ * \param count - number of buffers, a power of two
+ * \param payloadSize - largest datagram received whole
+ * \param error - what failed
+ * \return - false if io_uring or one of the features used is not available
+*/
+bool UringReceiver::Ring::setup( int count, int payloadSize, std::string& error )
+{
+    if( ( count <= 0 ) || ( count > kMaxBufferCount ) || ( count & ( count - 1 ) ) )
+    {
+        error = "buffer count must be a power of two up to 32768";
+        return false;
+    }
+
+    // Every buffer in use can hold a completion
+    io_uring_params params;
+    memset( &params, 0, sizeof( params ) );
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = std::max( (unsigned) count * 2, kSubmissionEntries * 2 );
+#if defined( IORING_SETUP_COOP_TASKRUN )
+    // Completions are collected when the thread enters the kernel anyway;
+    // do not interrupt it for them (Linux 5.19)
+    params.flags |= IORING_SETUP_COOP_TASKRUN;
+    fd = SetupRing( kSubmissionEntries, &params );
+    if( ( fd < 0 ) && ( errno == EINVAL ) )
+    {
+        params.flags &= ~IORING_SETUP_COOP_TASKRUN;
+        fd = SetupRing( kSubmissionEntries, &params );
+    }
+#else
+    fd = SetupRing( kSubmissionEntries, &params );
+#endif
+    if( fd < 0 )
+    {
+        // ENOSYS: no io_uring, EPERM: disabled by sysctl or seccomp
+        error = SystemError( "io_uring_setup" );
+        return false;
+    }
+    if( !( params.features & IORING_FEAT_EXT_ARG ) || !( params.features & IORING_FEAT_NODROP ) )
+    {
+        error = "kernel too old: io_uring without wait timeouts (Linux 5.11)";
+        return false;
+    }
+
+    sqMapSize = params.sq_off.array + params.sq_entries * sizeof( unsigned );
+    cqMapSize = params.cq_off.cqes + params.cq_entries * sizeof( io_uring_cqe );
+    if( params.features & IORING_FEAT_SINGLE_MMAP )
+    {
+        sqMapSize = cqMapSize = std::max( sqMapSize, cqMapSize );
+    }
+    sqMap = mmap( nullptr, sqMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING );
+    if( sqMap == MAP_FAILED )
+    {
+        error = SystemError( "mmap" );
+        return false;
+    }
+    cqMap = ( params.features & IORING_FEAT_SINGLE_MMAP ) ? sqMap
+        : mmap( nullptr, cqMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING );
+    sqesSize = params.sq_entries * sizeof( io_uring_sqe );
+    sqes = (io_uring_sqe*) mmap( nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES );
+    if( ( cqMap == MAP_FAILED ) || ( sqes == MAP_FAILED ) )
+    {
+        error = SystemError( "mmap" );
+        return false;
+    }
+
+    char* sq = (char*) sqMap;
+    sqHead = (unsigned*) ( sq + params.sq_off.head );
+    sqTail = (unsigned*) ( sq + params.sq_off.tail );
+    sqArray = (unsigned*) ( sq + params.sq_off.array );
+    sqMask = *(unsigned*) ( sq + params.sq_off.ring_mask );
+    sqEntries = params.sq_entries;
+    char* cq = (char*) cqMap;
+    cqHead = (unsigned*) ( cq + params.cq_off.head );
+    cqTail = (unsigned*) ( cq + params.cq_off.tail );
+    cqes = (io_uring_cqe*) ( cq + params.cq_off.cqes );
+    cqMask = *(unsigned*) ( cq + params.cq_off.ring_mask );
+
+    // Each buffer holds an io_uring_recvmsg_out header, the ancillary data
+    // and the payload
+    bufferSize = ( sizeof( io_uring_recvmsg_out ) + kReceiveControlSize + payloadSize + 63 ) & ~(size_t) 63;
+    bufferRingSize = count * sizeof( io_uring_buf );
+    bufferRing = (io_uring_buf_ring*) mmap( nullptr, bufferRingSize, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+    if( bufferRing == MAP_FAILED )
+    {
+        error = SystemError( "mmap" );
+        return false;
+    }
+    io_uring_buf_reg reg;
+    memset( &reg, 0, sizeof( reg ) );
+    reg.ring_addr = (uint64_t) (uintptr_t) bufferRing;
+    reg.ring_entries = count;
+    reg.bgid = kBufferGroup;
+    if( RegisterRing( fd, IORING_REGISTER_PBUF_RING, &reg, 1 ) != 0 )
+    {
+        error = ( errno == EINVAL ) ? "kernel too old: no provided buffer rings (Linux 5.19)"
+            : SystemError( "io_uring_register" );
+        return false;
+    }
+    bufferMask = count - 1;
+    buffers.reset( new char[(size_t) count * bufferSize] );
+    for( int i = 0; i < count; i++ )
+    {
+        recycle( i );
+    }
+
+    if( !probeMultishot() )
+    {
+        error = "kernel too old: no multishot recvmsg (Linux 6.0)";
+        return false;
+    }
+    return true;
+}
+
+// Kernels before 6.0 reject a multishot recvmsg as soon as it is
+// submitted; newer ones keep it pending until a datagram arrives, on an
+// idle loopback socket forever.
+bool UringReceiver::Ring::probeMultishot()
+{
+    int probe = socket( AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0 );
+    if( probe < 0 )
+    {
+        return true;
+    }
+    sockaddr_in address;
+    memset( &address, 0, sizeof( address ) );
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+    bind( probe, (sockaddr*) &address, sizeof( address ) );
+
+    msghdr msg;
+    memset( &msg, 0, sizeof( msg ) );
+    io_uring_sqe* sqe = nextSqe();
+    sqe->opcode = IORING_OP_RECVMSG;
+    sqe->fd = probe;
+    sqe->addr = (uint64_t) (uintptr_t) &msg;
+    sqe->len = 1;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = kBufferGroup;
+    sqe->user_data = kProbeData;
+    __atomic_store_n( sqTail, *sqTail + 1, __ATOMIC_RELEASE );
+    enter( 0, 0 );
+
+    bool supported = true;
+    unsigned head = *cqHead;
+    unsigned tail = __atomic_load_n( cqTail, __ATOMIC_ACQUIRE );
+    for( ; head != tail; head++ )
+    {
+        if( ( cqes[head & cqMask].user_data == kProbeData ) && ( cqes[head & cqMask].res == -EINVAL ) )
+        {
+            supported = false;
+        }
+    }
+    __atomic_store_n( cqHead, head, __ATOMIC_RELEASE );
+
+    if( supported )
+    {
+        sqe = nextSqe();
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->fd = -1;
+        sqe->addr = kProbeData;
+        sqe->user_data = kCancelData;
+        __atomic_store_n( sqTail, *sqTail + 1, __ATOMIC_RELEASE );
+        enter( 2, 1000 );
+        reap();
+    }
+    ::close( probe );
+    return supported;
+}
+
+// A cleared submission queue entry, published by advancing sqTail once it
+// is filled in; submits what is queued first if the queue is full
+io_uring_sqe* UringReceiver::Ring::nextSqe()
+{
+    unsigned tail = *sqTail;
+    if( tail - __atomic_load_n( sqHead, __ATOMIC_ACQUIRE ) >= sqEntries )
+    {
+        EnterRing( fd, sqEntries, 0, 0, nullptr, 0 );
+    }
+    io_uring_sqe* sqe = &sqes[tail & sqMask];
+    memset( sqe, 0, sizeof( *sqe ) );
+    sqArray[tail & sqMask] = tail & sqMask;
+    return sqe;
+}
+
+// One multishot recvmsg for a socket, submitted by the next enter()
+void UringReceiver::Ring::armReceive( uint64_t index )
+{
+    io_uring_sqe* sqe = nextSqe();
+    sqe->opcode = IORING_OP_RECVMSG;
+    sqe->fd = sockets[index].fd;
+    sqe->addr = (uint64_t) (uintptr_t) &sockets[index].msg;
+    sqe->len = 1;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = kBufferGroup;
+    sqe->user_data = index;
+    __atomic_store_n( sqTail, *sqTail + 1, __ATOMIC_RELEASE );
+}
+
+/**
+ * \brief Submit the queued requests and wait for completions
+ * \param minComplete - completions to wait for, 0 to return at once
+ * \param timeoutMilliseconds - longest wait
+ * \return - 0, also on timeout and signals; -1 on error (see errno)
+*/
+int UringReceiver::Ring::enter( unsigned minComplete, int timeoutMilliseconds )
+{
+    unsigned flags = IORING_ENTER_GETEVENTS;
+    __kernel_timespec ts;
+    io_uring_getevents_arg arg;
+    void* argp = nullptr;
+    size_t argSize = 0;
+    if( minComplete > 0 )
+    {
+        ts.tv_sec = timeoutMilliseconds / 1000;
+        ts.tv_nsec = ( timeoutMilliseconds % 1000 ) * 1000000LL;
+        memset( &arg, 0, sizeof( arg ) );
+        arg.ts = (uint64_t) (uintptr_t) &ts;
+        flags |= IORING_ENTER_EXT_ARG;
+        argp = &arg;
+        argSize = sizeof( arg );
+    }
+    unsigned toSubmit = *sqTail - __atomic_load_n( sqHead, __ATOMIC_ACQUIRE );
+    if( EnterRing( fd, toSubmit, minComplete, flags, argp, argSize ) < 0 )
+    {
+        return ( ( errno == ETIME ) || ( errno == EINTR ) ) ? 0 : -1;
+    }
+    return 0;
+}
+
+// Handle the completions queued so far; returns the number of datagrams
+int UringReceiver::Ring::reap()
+{
+    int datagrams = 0;
+    unsigned head = *cqHead;
+    unsigned tail = __atomic_load_n( cqTail, __ATOMIC_ACQUIRE );
+    for( ; head != tail; head++ )
+    {
+        datagrams += complete( cqes[head & cqMask] );
+    }
+    __atomic_store_n( cqHead, head, __ATOMIC_RELEASE );
+    return datagrams;
+}
+
+int UringReceiver::Ring::complete( const io_uring_cqe& cqe )
+{
+    if( cqe.user_data >= sockets.size() )
+    {
+        return 0;
+    }
+    Socket& socket = sockets[cqe.user_data];
+
+    int received = 0;
+    if( cqe.flags & IORING_CQE_F_BUFFER )
+    {
+        unsigned bufferId = cqe.flags >> IORING_CQE_BUFFER_SHIFT;
+        if( cqe.res >= 0 )
+        {
+            // header, name (none), ancillary data, payload
+            char* buffer = &buffers[bufferId * bufferSize];
+            const io_uring_recvmsg_out* out = (const io_uring_recvmsg_out*) buffer;
+            size_t control = sizeof( io_uring_recvmsg_out ) + socket.msg.msg_namelen;
+            size_t payload = control + socket.msg.msg_controllen;
+
+            msghdr msg;
+            memset( &msg, 0, sizeof( msg ) );
+            msg.msg_control = buffer + control;
+            msg.msg_controllen = out->controllen;
+
+            UringDatagram datagram;
+            datagram.data = buffer + payload;
+            datagram.length = cqe.res - (int) payload;
+            datagram.truncated = ( out->flags & MSG_TRUNC ) != 0;
+            datagram.timestamp = ParseReceiveControl( msg, datagram.dropCounter );
+            socket.handler( datagram );
+            received = 1;
+        }
+        recycle( bufferId );
+    }
+
+    if( !( cqe.flags & IORING_CQE_F_MORE ) )
+    {
+        // The receive ended: all buffers were in use (ENOBUFS), the
+        // completion queue overflowed, or it failed
+        if( ( cqe.res >= 0 ) || ( cqe.res == -ENOBUFS ) )
+        {
+            armReceive( cqe.user_data );
+        }
+        else
+        {
+            std::cerr << "io_uring receive on socket " << socket.fd << " failed: " << strerror( -cqe.res ) << std::endl;
+        }
+    }
+    return received;
+}
+
+// Hand a buffer back to the kernel
+void UringReceiver::Ring::recycle( unsigned bufferId )
+{
+    // The entries start at the ring itself; in C++ bufs does not, as the
+    // empty struct of __DECLARE_FLEX_ARRAY takes a byte there
+    io_uring_buf& entry = ( (io_uring_buf*) bufferRing )[bufferTail & bufferMask];
+    entry.addr = (uint64_t) (uintptr_t) &buffers[bufferId * bufferSize];
+    entry.len = (uint32_t) bufferSize;
+    entry.bid = (uint16_t) bufferId;
+    bufferTail++;
+    __atomic_store_n( &bufferRing->tail, bufferTail, __ATOMIC_RELEASE );
+}
+
+UringReceiver::UringReceiver()
+{
+}
+
+UringReceiver::~UringReceiver()
+{
+}
+
+/**
+ * \brief Set up the ring and its receive buffers
+ * \param bufferCount - buffers the kernel receives into, a power of two; bounds
+ * the datagrams received and not yet handled
+ * \param payloadSize - largest datagram received whole
+ * \return - false if io_uring is not available, see error()
+*/
+bool UringReceiver::open( int bufferCount, int payloadSize )
+{
+    close();
+    std::unique_ptr<Ring> ring( new Ring() );
+    if( !ring->setup( bufferCount, payloadSize, error_ ) )
+    {
+        return false;
+    }
+    ring_ = std::move( ring );
+    return true;
+}
+
+// Cancels the receives; the sockets stay open
+void UringReceiver::close()
+{
+    ring_.reset();
+}
+
+/**
+ * \brief Receive the datagrams of a socket, from the next wait() on
+ * \param fd - socket, open as long as the ring is
+ * \param handler - called by wait() with every datagram
+ * \return - false if the ring is not open
+*/
+bool UringReceiver::add( int fd, const DatagramHandler& handler )
+{
+    if( !ring_ )
+    {
+        error_ = "io_uring not open";
+        return false;
+    }
+    ring_->sockets.emplace_back();
+    Ring::Socket& socket = ring_->sockets.back();
+    socket.fd = fd;
+    socket.handler = handler;
+    memset( &socket.msg, 0, sizeof( socket.msg ) );
+    socket.msg.msg_controllen = kReceiveControlSize;
+    ring_->armReceive( ring_->sockets.size() - 1 );
+    return true;
+}
+
+/**
+ * \brief Handle the datagrams received on all sockets, waiting for the first
+ * \param timeoutMilliseconds - longest wait, 0 to only collect what arrived
+ * \return - number of datagrams handled, -1 on error (see errno)
+*/
+int UringReceiver::wait( int timeoutMilliseconds )
+{
+    if( !ring_ )
+    {
+        errno = EBADF;
+        return -1;
+    }
+    // Sleep only if nothing is queued; the same call submits the receives
+    // re-armed meanwhile and, without task interrupts, runs the completions
+    int handled = ring_->reap();
+    if( ring_->enter( ( ( handled == 0 ) && ( timeoutMilliseconds > 0 ) ) ? 1 : 0, timeoutMilliseconds ) < 0 )
+    {
+        return -1;
+    }
+    return handled + ring_->reap();
+}
+
+} // namespace natnet
+
+#else
+
+namespace natnet
+{
+
+struct UringReceiver::Ring
+{
+};
+
+UringReceiver::UringReceiver()
+{
+}
+
+UringReceiver::~UringReceiver()
+{
+}
+
+bool UringReceiver::open( int /*bufferCount*/, int /*payloadSize*/ )
+{
+    error_ = "io_uring needs Linux 6.0 or later";
+    return false;
+}
+
+void UringReceiver::close()
+{
+}
+
+bool UringReceiver::add( int /*fd*/, const DatagramHandler& /*handler*/ )
+{
+    error_ = "io_uring not open";
+    return false;
+}
+
+int UringReceiver::wait( int /*timeoutMilliseconds*/ )
+{
+    return -1;
+}
+
+} // namespace natnet
+
+#endif // IORING_RECV_MULTISHOT
@@ -0,0 +1,70 @@
+/**
+ * \file   UringReceiver.h
+ * \brief  Receives the datagrams of many sockets on one io_uring (Linux).
+ * An alternative to receiving on an io_service: every socket added gets a
+ * single multishot recvmsg request, which keeps receiving datagrams until
+ * it is cancelled, without being submitted again. The kernel picks the
+ * buffer of each datagram from a ring of provided buffers that is
+ * registered once, and a buffer goes back to the ring as soon as the
+ * handler returned. One thread calling wait() services all sockets: a
+ * single io_uring_enter both sleeps until something arrived and collects
+ * every completion queued by then, with no readiness notification and no
+ * receive call per datagram.
+ *
+ * Needs Linux 6.0 (multishot recvmsg, provided buffer rings); open() fails
+ * on older kernels and where io_uring is disabled (kernel.io_uring_disabled,
+ * or a seccomp filter as in many containers), and everywhere else. Callers
+ * then receive with asio instead.
+ *
+ * Not thread-safe: open(), add() and wait() belong to one thread at a time.
+ */
+
+#pragma once
+
+#include "NatNetDecoder.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace natnet
+{
+
+struct UringDatagram
+{
+    char* data;
+    int length;                     // bytes of data, at most the payload size given to open()
+    bool truncated;                 // the datagram was larger than the buffer (MSG_TRUNC)
+    ReceiveTimestamp timestamp;     // with EnableReceiveTimestamps on the socket
+    uint32_t dropCounter;           // with EnableDropCounter on the socket, see DatagramBatch
+};
+
+class UringReceiver
+{
+public:
+    // Called for every datagram; data is valid until the handler returns
+    typedef std::function<void( const UringDatagram& datagram )> DatagramHandler;
+
+    UringReceiver();
+    ~UringReceiver();
+    UringReceiver( const UringReceiver& ) = delete;
+    UringReceiver& operator=( const UringReceiver& ) = delete;
+
+    bool open( int bufferCount, int payloadSize );
+    void close();
+    bool isOpen() const { return ring_ != nullptr; }
+    const std::string& error() const { return error_; }
+
+    bool add( int fd, const DatagramHandler& handler );
+
+    int wait( int timeoutMilliseconds );
+
+private:
+    struct Ring;
+
+    std::unique_ptr<Ring> ring_;
+    std::string error_;
+};
+
+} // namespace natnet
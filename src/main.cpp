@@ -9,20 +9,56 @@
 //
 
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <memory>
 #include <string>
+#include <thread>
+#include <vector>
 #include <boost/asio.hpp>
 #include <inttypes.h>
 #include <stdio.h>
 
+#include "DataReceiver.h"
+#include "DecoderContext.h"
+#include "RecordingWriter.h"
+#include "ThreadScheduling.h"
+#include "UringReceiver.h"
+
 constexpr const char* MULTICAST_ADDRESS = "239.255.42.99";
 constexpr int PORT_COMMAND = 1510;
 constexpr int PORT_DATA = 1511;
-constexpr int MAX_PACKETSIZE = 100000;  // max size of packet (actual packet size is dynamic)
+constexpr int URING_BUFFERS = 256;
 
-void Unpack(char* pData);
+char* Unpack(natnet::DecoderContext& context, natnet::MocapFrame& frame, char* pData, int nBytesReceived);
 void buildConnectPacket(std::vector<char>& buffer);
-void UnpackCommand(char* pData);
+void UnpackCommand(natnet::DecoderContext& context, char* pData);
+
+// Append a whole packet (header included, as received) to the recording,
+// tagged with the number of the receiver it came in on
+void recordPacket(natnet::RecordingWriter& recorder, const char* data, std::size_t length,
+    const natnet::ReceiveTimestamp& timestamp, uint16_t stream)
+{
+  if (!recorder.isOpen())
+    return;
+  sPacket header;
+  if (length < sizeof(header.iMessage) + sizeof(header.nDataBytes))
+    return;
+  std::memcpy(&header, data, sizeof(header.iMessage) + sizeof(header.nDataBytes));
+  std::size_t payload = length - sizeof(header.iMessage) - sizeof(header.nDataBytes);
+  if (header.nDataBytes < payload)
+    payload = header.nDataBytes;
+
+  int64_t nanoseconds = timestamp.source != natnet::ReceiveTimestamp_None
+      ? timestamp.nanoseconds : natnet::WallClockNanoseconds();
+  recorder.write(header.iMessage, data + sizeof(header.iMessage) + sizeof(header.nDataBytes),
+      static_cast<uint32_t>(payload), nanoseconds, stream);
+}
 
 using boost::asio::ip::udp;
 
@@ -30,69 +66,189 @@ class receiver
 {
 public:
   receiver(boost::asio::io_service& io_service,
-      const boost::asio::ip::address& listen_address,
-      const boost::asio::ip::address& multicast_address)
-    : socket_(io_service)
-    , sender_endpoint_()
-    , data_(20000)
+      const natnet::ReceiverOptions& options,
+      const natnet::DecoderContext& context,
+      natnet::RecordingWriter& recorder, uint16_t stream)
+    : context_(context)
+    , frame_(new natnet::MocapFrame())
+    , recorder_(recorder)
+    , stream_(stream)
+    , data_receiver_(io_service, options,
+          [this](char* data, int length, const natnet::ReceiveTimestamp& timestamp)
+          {
+            handle_packet(data, length, timestamp);
+          })
+  {
+  }
+
+  // Spin mode: handle whatever is queued, without blocking
+  int poll() { return data_receiver_.poll(); }
+
+  natnet::ReceiverStatistics statistics() const { return data_receiver_.statistics(); }
+
+private:
+  void handle_packet(char* data, int length, const natnet::ReceiveTimestamp& timestamp)
+  {
+    // std::cout.write(data, length);
+    // std::cout << std::endl;
+    recordPacket(recorder_, data, length, timestamp, stream_);
+    frame_->receiveTimestamp = timestamp;
+    Unpack(context_, *frame_, data, length);
+  }
+
+  natnet::DecoderContext context_;
+  std::unique_ptr<natnet::MocapFrame> frame_;
+  natnet::RecordingWriter& recorder_;
+  uint16_t stream_;
+  natnet::DataReceiver data_receiver_;
+};
+
+// Reports datagrams the kernel dropped on any receiver, once a second
+class drop_reporter
+{
+public:
+  drop_reporter(boost::asio::io_service& io_service,
+      const std::vector<std::unique_ptr<receiver>>& receivers)
+    : timer_(io_service)
+    , receivers_(receivers)
+    , reported_(receivers.size(), 0)
   {
-    // Create the socket so that multiple may be bound to the same address.
-    boost::asio::ip::udp::endpoint listen_endpoint(
-        listen_address, PORT_DATA);
-    socket_.open(listen_endpoint.protocol());
-    socket_.set_option(boost::asio::ip::udp::socket::reuse_address(true));
-    socket_.bind(listen_endpoint);
-
-    // Join the multicast group.
-    socket_.set_option(
-        boost::asio::ip::multicast::join_group(multicast_address));
-
-    do_receive();
+    wait();
   }
 
 private:
-  void do_receive()
+  void wait()
   {
-    socket_.async_receive_from(
-        boost::asio::buffer(data_.data(), data_.size()), sender_endpoint_,
-        [this](boost::system::error_code ec, std::size_t /*length*/)
+    timer_.expires_from_now(std::chrono::seconds(1));
+    timer_.async_wait([this](const boost::system::error_code& ec)
         {
-          if (!ec)
+          if (ec)
+            return;
+          for (std::size_t i = 0; i < receivers_.size(); ++i)
           {
-            // std::cout.write(data_.data(), length);
-            // std::cout << std::endl;
-            Unpack(data_.data());
-
-            do_receive();
-          } else {
-            std::cerr << "async_receive_from error: " << ec.message() << std::endl;
+            natnet::ReceiverStatistics statistics = receivers_[i]->statistics();
+            if (statistics.kernelDrops != reported_[i])
+            {
+              std::cerr << "receiver " << i << ": " << statistics.kernelDrops - reported_[i]
+                        << " datagrams dropped by the kernel (socket buffer full), receive buffer now "
+                        << statistics.receiveBufferBytes << " bytes" << std::endl;
+              reported_[i] = statistics.kernelDrops;
+            }
           }
+          wait();
         });
   }
 
-  boost::asio::ip::udp::socket socket_;
-  boost::asio::ip::udp::endpoint sender_endpoint_;
-  std::vector<char> data_;
+  boost::asio::steady_timer timer_;
+  const std::vector<std::unique_ptr<receiver>>& receivers_;
+  std::vector<uint64_t> reported_;
 };
 
+void print_statistics(const std::vector<std::unique_ptr<receiver>>& receivers)
+{
+  for (std::size_t i = 0; i < receivers.size(); ++i)
+  {
+    natnet::ReceiverStatistics statistics = receivers[i]->statistics();
+    std::cerr << "receiver " << i << ": " << statistics.packets << " packets, " << statistics.bytes
+              << " bytes, " << statistics.malformed << " malformed, " << statistics.truncated
+              << " truncated, " << statistics.kernelDrops
+              << " dropped by the kernel, receive buffer " << statistics.receiveBufferBytes << " bytes" << std::endl;
+  }
+}
+
+void usage()
+{
+  std::cerr << "Usage: natnettest [--group <address>]... [--shards <n>] [--cpus <list>] [--fifo <priority>]\n"
+               "                  [--spin] [--busy-poll <us>] [--rcvbuf <bytes>] [--io-uring] <host> [recording]\n"
+               "  --group   receive this multicast group on its own socket and thread (repeatable)\n"
+               "  --shards  add n-1 sockets on the data port that join no group (SO_REUSEPORT,\n"
+               "            Linux); the kernel spreads unicast servers over them and the\n"
+               "            group sockets, multicast frames arrive once, on their group's socket\n"
+               "  --cpus    pin the receive threads to these CPUs, e.g. 2,3 or 4-7\n"
+               "  --fifo    run the receive threads with this SCHED_FIFO priority (1-99)\n"
+               "  --spin    poll the sockets in a loop instead of blocking (one busy core per thread)\n"
+               "  --busy-poll  SO_BUSY_POLL time in microseconds\n"
+               "  --rcvbuf  fixed SO_RCVBUF size (default: sized from the stream)\n"
+               "  --io-uring  receive on all data sockets from one thread with\n"
+               "            io_uring (Linux 6.0 and later, asio otherwise)\n";
+}
+
 int main(int argc, char* argv[])
 {
   try
   {
-    // Connect to command port to query version
+    std::vector<std::string> groups;
+    int shards = 1;
+    std::vector<int> cpus;
+    int fifo_priority = 0;
+    bool spin = false;
+    int busy_poll = 0;
+    int receive_buffer = 0;
+    bool use_uring = false;
+    std::vector<const char*> positional;
+    for (int i = 1; i < argc; ++i)
+    {
+      std::string arg = argv[i];
+      if (arg == "--group" && i + 1 < argc)
+        groups.push_back(argv[++i]);
+      else if (arg == "--shards" && i + 1 < argc)
+        shards = std::atoi(argv[++i]);
+      else if (arg == "--cpus" && i + 1 < argc && natnet::ParseCpuList(argv[i + 1], cpus))
+        ++i;
+      else if (arg == "--fifo" && i + 1 < argc)
+        fifo_priority = std::atoi(argv[++i]);
+      else if (arg == "--spin")
+        spin = true;
+      else if (arg == "--busy-poll" && i + 1 < argc)
+        busy_poll = std::atoi(argv[++i]);
+      else if (arg == "--rcvbuf" && i + 1 < argc)
+        receive_buffer = std::atoi(argv[++i]);
+      else if (arg == "--io-uring")
+        use_uring = true;
+      else if (arg.compare(0, 2, "--") != 0)
+        positional.push_back(argv[i]);
+      else
+      {
+        usage();
+        return 1;
+      }
+    }
+    if (positional.size() != 1 && positional.size() != 2)
+    {
+      usage();
+      return 1;
+    }
+    if (shards < 1)
+      shards = 1;
+#if !defined(IP_MULTICAST_ALL)
+    // Without it, a socket that joined no group still receives the groups
+    // joined by the others, and every shard would get each multicast frame
+    if (shards > 1)
+    {
+      std::cerr << "--shards needs IP_MULTICAST_ALL (Linux)\n";
+      return 1;
+    }
+#endif
+    if (groups.empty())
+      groups.push_back(MULTICAST_ADDRESS);
+    const char* host = positional[0];
+    const char* recording = positional.size() == 2 ? positional[1] : nullptr;
 
-    if (argc != 2)
+    // Packets are recorded as received, before decoding
+    natnet::RecordingWriter recorder;
+    if (recording && !recorder.open(recording))
     {
-      std::cerr << "Usage: natnettest <host>\n";
+      std::cerr << "Unable to create recording " << recording << ": " << std::strerror(errno) << "\n";
       return 1;
     }
 
+    // Connect to command port to query version
     boost::asio::io_service io_service_cmd;
 
     udp::socket socket_cmd(io_service_cmd, udp::endpoint(udp::v4(), 0));
 
     udp::resolver resolver_cmd(io_service_cmd);
-    udp::endpoint endpoint_cmd = *resolver_cmd.resolve({udp::v4(), argv[1], std::to_string(PORT_COMMAND)});
+    udp::endpoint endpoint_cmd = *resolver_cmd.resolve({udp::v4(), host, std::to_string(PORT_COMMAND)});
 
     std::vector<char> connectCmd;
     buildConnectPacket(connectCmd);
@@ -100,17 +256,107 @@ int main(int argc, char* argv[])
 
     std::vector<char> reply(MAX_PACKETSIZE);
     udp::endpoint sender_endpoint;
-    /*size_t reply_length =*/ socket_cmd.receive_from(
+    size_t reply_length = socket_cmd.receive_from(
         boost::asio::buffer(reply, MAX_PACKETSIZE), sender_endpoint);
+    natnet::DecodeStatus reply_status = natnet::ValidatePacket(reply.data(), static_cast<int>(reply_length));
+    if (reply_status != natnet::DecodeStatus_OK)
+    {
+      std::cerr << "Invalid reply to the connect request: " << natnet::DecodeStatusString(reply_status) << "\n";
+      return 1;
+    }
+    recordPacket(recorder, reply.data(), reply_length, natnet::ReceiveTimestamp(), 0);
+
+    natnet::DecoderContext context;
+    UnpackCommand(context, reply.data());
+
+    natnet::UringReceiver uring;
+    if (use_uring && !uring.open(URING_BUFFERS, natnet::kReceiveBufferSize))
+      std::cerr << "io_uring not available (" << uring.error() << "), receiving with asio" << std::endl;
+
+    // One socket, decoder context and io_service per group, then one per
+    // extra shard, each run by its own thread, or all by one thread on the
+    // ring. Every multicast datagram reaches each socket that joined its
+    // group, so only the group sockets join; the extra shards share the data
+    // port with them and receive unicast only. The recording numbers the
+    // sockets in this order; the handshake reply is stream 0 with the first.
+    std::vector<std::unique_ptr<boost::asio::io_service>> services;
+    std::vector<std::unique_ptr<receiver>> receivers;
+    std::vector<std::string> sockets = groups;
+    sockets.resize(groups.size() + shards - 1);
+    for (const std::string& group : sockets)
+    {
+      natnet::ReceiverOptions options;
+      options.listenAddress = boost::asio::ip::address::from_string("0.0.0.0");
+      options.multicastAddress = group.empty() ? boost::asio::ip::address()
+                                               : boost::asio::ip::address::from_string(group);
+      options.port = PORT_DATA;
+      options.reusePort = shards > 1;
+      options.poll = spin;
+      options.busyPollMicroseconds = busy_poll;
+      options.receiveBufferBytes = receive_buffer;
+      options.uring = &uring;
+      services.emplace_back(new boost::asio::io_service());
+      receivers.emplace_back(new receiver(*services.back(), options, context, recorder,
+          static_cast<uint16_t>(receivers.size())));
+    }
+
+    std::atomic<bool> stopped(false);
+    std::vector<std::thread> threads;
+    if (uring.isOpen())
+    {
+      threads.emplace_back([&uring, &stopped, spin]()
+          {
+            while (!stopped.load(std::memory_order_relaxed))
+            {
+              if (uring.wait(spin ? 0 : 100) < 0)
+              {
+                std::cerr << "io_uring wait error: " << std::strerror(errno) << std::endl;
+                break;
+              }
+            }
+          });
+    }
+    else
+    {
+      for (std::size_t i = 0; i < services.size(); ++i)
+      {
+        boost::asio::io_service& service = *services[i];
+        receiver& r = *receivers[i];
+        threads.emplace_back([&service, &r, &stopped, spin]()
+            {
+              if (spin)
+              {
+                while (!stopped.load(std::memory_order_relaxed))
+                  r.poll();
+              }
+              else
+                service.run();
+            });
+      }
+    }
+    for (std::size_t i = 0; i < threads.size(); ++i)
+    {
+      if (i < cpus.size() && !natnet::PinThread(threads[i], cpus[i]))
+        std::cerr << "unable to pin receive thread " << i << " to CPU " << cpus[i] << std::endl;
+      if (fifo_priority > 0 && !natnet::SetRealtimePriority(threads[i], fifo_priority))
+        std::cerr << "unable to set SCHED_FIFO priority " << fifo_priority << " on receive thread " << i
+                  << ": " << std::strerror(errno) << std::endl;
+    }
 
-    UnpackCommand(reply.data());
+    // Stop on Ctrl-C, so the recording is closed with everything received
+    boost::asio::signal_set signals(io_service_cmd, SIGINT, SIGTERM);
+    signals.async_wait([&io_service_cmd](const boost::system::error_code&, int) { io_service_cmd.stop(); });
+    drop_reporter drops(io_service_cmd, receivers);
+    io_service_cmd.run();
 
-    // Listen on multicast address
-    boost::asio::io_service io_service;
-    receiver r(io_service,
-        boost::asio::ip::address::from_string("0.0.0.0"),
-        boost::asio::ip::address::from_string(MULTICAST_ADDRESS));
-    io_service.run();
+    stopped = true;
+    for (auto& service : services)
+      service->stop();
+    for (auto& thread : threads)
+      thread.join();
+    print_statistics(receivers);
+    if (recorder.recordsDropped() > 0)
+      std::cerr << recorder.recordsDropped() << " packets not recorded: the disk did not keep up" << std::endl;
   }
   catch (std::exception& e)
   {
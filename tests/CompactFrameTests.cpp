@@ -0,0 +1,299 @@
+/**
+ * \file   CompactFrameTests.cpp
+ * \brief  Round trip of FrameSynthesizer frames through CompactFrame.
+ * A frame with several records in every section, nested ones included, is
+ * assigned to a CompactFrame, whose sections and first-entry indices are
+ * checked against the source, and copied back into a MocapFrame, which must
+ * equal the source. A smaller frame is then assigned to the same objects and
+ * the large one again, as a receiver reusing them would. Exits with 1 if any
+ * check failed.
+ */
+
+#include "TestSupport.h"
+
+#include "CompactFrame.h"
+#include "FrameSynthesizer.h"
+
+#include <NatNetTypes.h>
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+namespace
+{
+
+// Every field, those that only some versions stream included
+bool SameRigidBodyRecord( const sRigidBodyData& a, const sRigidBodyData& b )
+{
+    return test::SameRigidBody( a, b ) && ( a.MeanError == b.MeanError ) && ( a.params == b.params );
+}
+
+bool SameMarkerRecord( const sMarker& a, const sMarker& b )
+{
+    return test::SameMarker( a, b ) && ( a.params == b.params ) && ( a.residual == b.residual );
+}
+
+template <typename Device>
+bool SameDevice( const Device& a, const Device& b )
+{
+    return ( a.ID == b.ID ) && ( a.nChannels == b.nChannels ) && ( a.params == b.params ) &&
+        test::SameAnalog( a.ChannelData, b.ChannelData, a.nChannels );
+}
+
+/**
+ * \brief Check the compact sections against the frame they were assigned from
+ */
+template <typename Device>
+void CheckAnalog( const natnet::CompactFrame& compact, natnet::CompactSection section, const Device* src, int nDevices,
+    int& iChannel, int& iValue )
+{
+    const natnet::CompactAnalogDevice* devices = compact.section<natnet::CompactAnalogDevice>( section );
+    const natnet::CompactAnalogChannel* channels = compact.section<natnet::CompactAnalogChannel>( natnet::CompactSection_AnalogChannels );
+    const float* values = compact.section<float>( natnet::CompactSection_AnalogValues );
+
+    CHECK( compact.count( section ) == nDevices );
+    for( int i = 0; ( i < compact.count( section ) ) && ( i < nDevices ); i++ )
+    {
+        CHECK( ( devices[i].ID == src[i].ID ) && ( devices[i].params == src[i].params ) );
+        CHECK( ( devices[i].nChannels == src[i].nChannels ) && ( devices[i].firstChannel == iChannel ) );
+        for( int c = 0; c < src[i].nChannels; c++ )
+        {
+            const natnet::CompactAnalogChannel& channel = channels[devices[i].firstChannel + c];
+            const sAnalogChannelData& expected = src[i].ChannelData[c];
+            CHECK( ( channel.nFrames == expected.nFrames ) && ( channel.firstValue == iValue ) );
+            CHECK( memcmp( values + channel.firstValue, expected.Values, expected.nFrames * sizeof( float ) ) == 0 );
+            iValue += expected.nFrames;
+        }
+        iChannel += src[i].nChannels;
+    }
+}
+
+void CheckCompact( const natnet::CompactFrame& compact, const sFrameOfMocapData& src )
+{
+    const natnet::CompactFrameHeader& header = compact.header();
+    CHECK( ( compact.size() == header.size ) && ( ( header.size % 8 ) == 0 ) );
+    for( int s = 0; s < natnet::CompactSection_Count; s++ )
+    {
+        CHECK( ( ( header.offsets[s] % 8 ) == 0 ) && ( header.offsets[s] <= header.size ) );
+    }
+    CHECK( ( header.iFrame == src.iFrame ) && ( header.Timecode == src.Timecode ) && ( header.params == src.params ) );
+
+    CHECK( compact.count( natnet::CompactSection_MarkerSets ) == src.nMarkerSets );
+    const natnet::CompactMarkerSet* markerSets = compact.markerSets();
+    const MarkerData* markerSetMarkers = compact.section<MarkerData>( natnet::CompactSection_MarkerSetMarkers );
+    int iMarker = 0;
+    for( int i = 0; ( i < compact.count( natnet::CompactSection_MarkerSets ) ) && ( i < src.nMarkerSets ); i++ )
+    {
+        const sMarkerSetData& markerSet = src.MocapData[i];
+        CHECK( strcmp( markerSets[i].szName, markerSet.szName ) == 0 );
+        CHECK( ( markerSets[i].nMarkers == markerSet.nMarkers ) && ( markerSets[i].firstMarker == iMarker ) );
+        CHECK( memcmp( markerSetMarkers + markerSets[i].firstMarker, markerSet.Markers, markerSet.nMarkers * sizeof( MarkerData ) ) == 0 );
+        iMarker += markerSet.nMarkers;
+    }
+    CHECK( compact.count( natnet::CompactSection_MarkerSetMarkers ) == iMarker );
+
+    CHECK( compact.count( natnet::CompactSection_OtherMarkers ) == src.nOtherMarkers );
+    CHECK( memcmp( compact.section<MarkerData>( natnet::CompactSection_OtherMarkers ), src.OtherMarkers,
+        src.nOtherMarkers * sizeof( MarkerData ) ) == 0 );
+
+    CHECK( compact.count( natnet::CompactSection_RigidBodies ) == src.nRigidBodies );
+    for( int i = 0; ( i < compact.count( natnet::CompactSection_RigidBodies ) ) && ( i < src.nRigidBodies ); i++ )
+    {
+        CHECK( SameRigidBodyRecord( compact.rigidBodies()[i], src.RigidBodies[i] ) );
+    }
+
+    CHECK( compact.count( natnet::CompactSection_Skeletons ) == src.nSkeletons );
+    const natnet::CompactSkeleton* skeletons = compact.skeletons();
+    const sRigidBodyData* bones = compact.section<sRigidBodyData>( natnet::CompactSection_SkeletonRigidBodies );
+    int iBone = 0;
+    for( int i = 0; ( i < compact.count( natnet::CompactSection_Skeletons ) ) && ( i < src.nSkeletons ); i++ )
+    {
+        const sSkeletonData& skeleton = src.Skeletons[i];
+        CHECK( skeletons[i].skeletonID == skeleton.skeletonID );
+        CHECK( ( skeletons[i].nRigidBodies == skeleton.nRigidBodies ) && ( skeletons[i].firstRigidBody == iBone ) );
+        for( int k = 0; k < skeleton.nRigidBodies; k++ )
+        {
+            CHECK( SameRigidBodyRecord( bones[skeletons[i].firstRigidBody + k], skeleton.RigidBodyData[k] ) );
+        }
+        iBone += skeleton.nRigidBodies;
+    }
+    CHECK( compact.count( natnet::CompactSection_SkeletonRigidBodies ) == iBone );
+
+    CHECK( compact.count( natnet::CompactSection_Assets ) == src.nAssets );
+    const natnet::CompactAsset* assets = compact.assets();
+    const sRigidBodyData* assetRigidBodies = compact.section<sRigidBodyData>( natnet::CompactSection_AssetRigidBodies );
+    const sMarker* assetMarkers = compact.section<sMarker>( natnet::CompactSection_AssetMarkers );
+    int iAssetRigidBody = 0;
+    int iAssetMarker = 0;
+    for( int i = 0; ( i < compact.count( natnet::CompactSection_Assets ) ) && ( i < src.nAssets ); i++ )
+    {
+        const sAssetData& asset = src.Assets[i];
+        CHECK( assets[i].assetID == asset.assetID );
+        CHECK( ( assets[i].nRigidBodies == asset.nRigidBodies ) && ( assets[i].firstRigidBody == iAssetRigidBody ) );
+        CHECK( ( assets[i].nMarkers == asset.nMarkers ) && ( assets[i].firstMarker == iAssetMarker ) );
+        for( int k = 0; k < asset.nRigidBodies; k++ )
+        {
+            CHECK( SameRigidBodyRecord( assetRigidBodies[assets[i].firstRigidBody + k], asset.RigidBodyData[k] ) );
+        }
+        for( int k = 0; k < asset.nMarkers; k++ )
+        {
+            CHECK( SameMarkerRecord( assetMarkers[assets[i].firstMarker + k], asset.MarkerData[k] ) );
+        }
+        iAssetRigidBody += asset.nRigidBodies;
+        iAssetMarker += asset.nMarkers;
+    }
+    CHECK( compact.count( natnet::CompactSection_AssetRigidBodies ) == iAssetRigidBody );
+    CHECK( compact.count( natnet::CompactSection_AssetMarkers ) == iAssetMarker );
+
+    CHECK( compact.count( natnet::CompactSection_LabeledMarkers ) == src.nLabeledMarkers );
+    for( int i = 0; ( i < compact.count( natnet::CompactSection_LabeledMarkers ) ) && ( i < src.nLabeledMarkers ); i++ )
+    {
+        CHECK( SameMarkerRecord( compact.labeledMarkers()[i], src.LabeledMarkers[i] ) );
+    }
+
+    // force plates and devices share the channel and sample sections, force plates first
+    int iChannel = 0;
+    int iValue = 0;
+    CheckAnalog( compact, natnet::CompactSection_ForcePlates, src.ForcePlates, src.nForcePlates, iChannel, iValue );
+    CheckAnalog( compact, natnet::CompactSection_Devices, src.Devices, src.nDevices, iChannel, iValue );
+    CHECK( compact.count( natnet::CompactSection_AnalogChannels ) == iChannel );
+    CHECK( compact.count( natnet::CompactSection_AnalogValues ) == iValue );
+}
+
+/**
+ * \brief Check a frame expanded by copyTo against the frame that was assigned
+ */
+void CheckCopy( const sFrameOfMocapData& out, const sFrameOfMocapData& src )
+{
+    CHECK( out.iFrame == src.iFrame );
+
+    CHECK( out.nMarkerSets == src.nMarkerSets );
+    for( int i = 0; ( i < out.nMarkerSets ) && ( i < src.nMarkerSets ); i++ )
+    {
+        CHECK( strcmp( out.MocapData[i].szName, src.MocapData[i].szName ) == 0 );
+        CHECK( out.MocapData[i].nMarkers == src.MocapData[i].nMarkers );
+        CHECK( memcmp( out.MocapData[i].Markers, src.MocapData[i].Markers, src.MocapData[i].nMarkers * sizeof( MarkerData ) ) == 0 );
+    }
+
+    CHECK( out.nOtherMarkers == src.nOtherMarkers );
+    CHECK( memcmp( out.OtherMarkers, src.OtherMarkers, src.nOtherMarkers * sizeof( MarkerData ) ) == 0 );
+
+    CHECK( out.nRigidBodies == src.nRigidBodies );
+    for( int i = 0; ( i < out.nRigidBodies ) && ( i < src.nRigidBodies ); i++ )
+    {
+        CHECK( SameRigidBodyRecord( out.RigidBodies[i], src.RigidBodies[i] ) );
+    }
+
+    CHECK( out.nSkeletons == src.nSkeletons );
+    for( int i = 0; ( i < out.nSkeletons ) && ( i < src.nSkeletons ); i++ )
+    {
+        CHECK( out.Skeletons[i].skeletonID == src.Skeletons[i].skeletonID );
+        CHECK( out.Skeletons[i].nRigidBodies == src.Skeletons[i].nRigidBodies );
+        for( int k = 0; k < src.Skeletons[i].nRigidBodies; k++ )
+        {
+            CHECK( SameRigidBodyRecord( out.Skeletons[i].RigidBodyData[k], src.Skeletons[i].RigidBodyData[k] ) );
+        }
+    }
+
+    CHECK( out.nAssets == src.nAssets );
+    for( int i = 0; ( i < out.nAssets ) && ( i < src.nAssets ); i++ )
+    {
+        const sAssetData& a = out.Assets[i];
+        const sAssetData& b = src.Assets[i];
+        CHECK( ( a.assetID == b.assetID ) && ( a.nRigidBodies == b.nRigidBodies ) && ( a.nMarkers == b.nMarkers ) );
+        for( int k = 0; k < b.nRigidBodies; k++ )
+        {
+            CHECK( SameRigidBodyRecord( a.RigidBodyData[k], b.RigidBodyData[k] ) );
+        }
+        for( int k = 0; k < b.nMarkers; k++ )
+        {
+            CHECK( SameMarkerRecord( a.MarkerData[k], b.MarkerData[k] ) );
+        }
+    }
+
+    CHECK( out.nLabeledMarkers == src.nLabeledMarkers );
+    for( int i = 0; ( i < out.nLabeledMarkers ) && ( i < src.nLabeledMarkers ); i++ )
+    {
+        CHECK( SameMarkerRecord( out.LabeledMarkers[i], src.LabeledMarkers[i] ) );
+    }
+
+    CHECK( out.nForcePlates == src.nForcePlates );
+    for( int i = 0; ( i < out.nForcePlates ) && ( i < src.nForcePlates ); i++ )
+    {
+        CHECK( SameDevice( out.ForcePlates[i], src.ForcePlates[i] ) );
+    }
+
+    CHECK( out.nDevices == src.nDevices );
+    for( int i = 0; ( i < out.nDevices ) && ( i < src.nDevices ); i++ )
+    {
+        CHECK( SameDevice( out.Devices[i], src.Devices[i] ) );
+    }
+
+    CHECK( ( out.Timecode == src.Timecode ) && ( out.TimecodeSubframe == src.TimecodeSubframe ) );
+    CHECK( out.fTimestamp == src.fTimestamp );
+    CHECK( out.CameraMidExposureTimestamp == src.CameraMidExposureTimestamp );
+    CHECK( out.CameraDataReceivedTimestamp == src.CameraDataReceivedTimestamp );
+    CHECK( out.TransmitTimestamp == src.TransmitTimestamp );
+    CHECK( out.PrecisionTimestampSecs == src.PrecisionTimestampSecs );
+    CHECK( out.PrecisionTimestampFractionalSecs == src.PrecisionTimestampFractionalSecs );
+    CHECK( out.params == src.params );
+}
+
+void RoundTrip( natnet::CompactFrame& compact, natnet::MocapFrame& frame, const sFrameOfMocapData& src )
+{
+    compact.assign( src );
+    CheckCompact( compact, src );
+    compact.copyTo( frame );
+    CheckCopy( frame.data, src );
+}
+
+// The suffix fields the synthesizer leaves to the caller
+void FillSuffix( sFrameOfMocapData& frame )
+{
+    frame.Timecode = 0x01020304;
+    frame.TimecodeSubframe = 5;
+    frame.CameraMidExposureTimestamp = 1000001;
+    frame.CameraDataReceivedTimestamp = 1000002;
+    frame.TransmitTimestamp = 1000003;
+    frame.PrecisionTimestampSecs = 42;
+    frame.PrecisionTimestampFractionalSecs = 43;
+    frame.params = 0x01;
+}
+
+} // namespace
+
+int main()
+{
+    test::Begin();
+
+    natnet::FrameSynthesizer large( test::TestScene() );
+    natnet::SyntheticScene smallScene;
+    smallScene.markerSets = 1;
+    smallScene.markerSetMarkers = 2;
+    smallScene.rigidBodies = 1;
+    smallScene.skeletons = 1;
+    smallScene.skeletonBones = 2;
+    smallScene.labeledMarkers = 3;         // no assets, legacy markers or analog data
+    natnet::FrameSynthesizer small( smallScene );
+
+    natnet::CompactFrame compact;
+    std::unique_ptr<natnet::MocapFrame> frame( new natnet::MocapFrame() );
+
+    test::SetContext( "every section" );
+    sFrameOfMocapData& first = large.synthesize( 7 );
+    FillSuffix( first );
+    RoundTrip( compact, *frame, first );
+
+    test::SetContext( "smaller frame" );
+    sFrameOfMocapData& second = small.synthesize( 8 );
+    FillSuffix( second );
+    RoundTrip( compact, *frame, second );
+
+    test::SetContext( "every section again" );
+    sFrameOfMocapData& third = large.synthesize( 9 );
+    FillSuffix( third );
+    RoundTrip( compact, *frame, third );
+
+    return test::Finish();
+}
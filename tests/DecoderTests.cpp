@@ -0,0 +1,215 @@
+/**
+ * \file   DecoderTests.cpp
+ * \brief  Checks of the frame decoders against NatNetEncoder payloads.
+ * Every bitstream version from 2.0 to 4.1 is encoded from a FrameSynthesizer
+ * scene that populates every section of that version, then:
+ *  - decoded again with FrameDecoder and compared with the source frame;
+ *  - decoded with each single-section subscription mask by FrameDecoder.
+ * Exits with 1 if any check failed.
+ */
+
+#include "TestSupport.h"
+
+#include "NatNetDecoder.h"
+
+#include <NatNetTypes.h>
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+using test::SameAnalog;
+using test::SameMarker;
+using test::SameRigidBody;
+using test::TestFrame;
+
+namespace
+{
+
+/**
+ * \brief Decode the payload of every version and compare it with the frame it was encoded from
+ */
+void TestRoundTrip( const test::Version& v, const TestFrame& encoded )
+{
+    const int major = v.major;
+    const int minor = v.minor;
+    const uint32_t present = natnet::FrameSectionsOf( major, minor );
+    const sFrameOfMocapData& src = encoded.frame();
+
+    natnet::FrameDecoder decoder( major, minor );
+    std::unique_ptr<natnet::MocapFrame> frame( new natnet::MocapFrame() );
+    const char* end = decoder.unpack( encoded.data(), encoded.nBytes(), *frame );
+    const sFrameOfMocapData& out = frame->data;
+    CHECK( end == encoded.end() );
+
+    CHECK( out.iFrame == src.iFrame );
+
+    CHECK( out.nMarkerSets == src.nMarkerSets );
+    for( int i = 0; ( i < out.nMarkerSets ) && ( i < src.nMarkerSets ); i++ )
+    {
+        CHECK( strcmp( out.MocapData[i].szName, src.MocapData[i].szName ) == 0 );
+        CHECK( out.MocapData[i].nMarkers == src.MocapData[i].nMarkers );
+        CHECK( memcmp( out.MocapData[i].Markers, src.MocapData[i].Markers,
+            src.MocapData[i].nMarkers * sizeof( MarkerData ) ) == 0 );
+    }
+
+    CHECK( out.nOtherMarkers == src.nOtherMarkers );
+    CHECK( memcmp( out.OtherMarkers, src.OtherMarkers, src.nOtherMarkers * sizeof( MarkerData ) ) == 0 );
+
+    CHECK( out.nRigidBodies == src.nRigidBodies );
+    for( int i = 0; ( i < out.nRigidBodies ) && ( i < src.nRigidBodies ); i++ )
+    {
+        CHECK( SameRigidBody( out.RigidBodies[i], src.RigidBodies[i] ) );
+        CHECK( out.RigidBodies[i].MeanError == src.RigidBodies[i].MeanError );
+    }
+
+    if( present & natnet::FrameSection_Skeletons )
+    {
+        CHECK( out.nSkeletons == src.nSkeletons );
+        CHECK( src.nSkeletons > 0 );
+        for( int i = 0; ( i < out.nSkeletons ) && ( i < src.nSkeletons ); i++ )
+        {
+            CHECK( out.Skeletons[i].skeletonID == src.Skeletons[i].skeletonID );
+            CHECK( out.Skeletons[i].nRigidBodies == src.Skeletons[i].nRigidBodies );
+            for( int k = 0; k < src.Skeletons[i].nRigidBodies; k++ )
+            {
+                CHECK( SameRigidBody( out.Skeletons[i].RigidBodyData[k], src.Skeletons[i].RigidBodyData[k] ) );
+            }
+        }
+    }
+
+    if( present & natnet::FrameSection_Assets )
+    {
+        CHECK( out.nAssets == src.nAssets );
+        CHECK( src.nAssets > 0 );
+        for( int i = 0; ( i < out.nAssets ) && ( i < src.nAssets ); i++ )
+        {
+            const sAssetData& a = out.Assets[i];
+            const sAssetData& b = src.Assets[i];
+            CHECK( ( a.assetID == b.assetID ) && ( a.nRigidBodies == b.nRigidBodies ) && ( a.nMarkers == b.nMarkers ) );
+            for( int k = 0; k < b.nRigidBodies; k++ )
+            {
+                CHECK( SameRigidBody( a.RigidBodyData[k], b.RigidBodyData[k] ) );
+            }
+            for( int k = 0; k < b.nMarkers; k++ )
+            {
+                CHECK( SameMarker( a.MarkerData[k], b.MarkerData[k] ) );
+            }
+        }
+    }
+
+    if( present & natnet::FrameSection_LabeledMarkers )
+    {
+        CHECK( out.nLabeledMarkers == src.nLabeledMarkers );
+        CHECK( src.nLabeledMarkers > 0 );
+        for( int i = 0; ( i < out.nLabeledMarkers ) && ( i < src.nLabeledMarkers ); i++ )
+        {
+            CHECK( SameMarker( out.LabeledMarkers[i], src.LabeledMarkers[i] ) );
+        }
+    }
+
+    if( present & natnet::FrameSection_ForcePlates )
+    {
+        CHECK( out.nForcePlates == src.nForcePlates );
+        CHECK( src.nForcePlates > 0 );
+        for( int i = 0; ( i < out.nForcePlates ) && ( i < src.nForcePlates ); i++ )
+        {
+            CHECK( out.ForcePlates[i].ID == src.ForcePlates[i].ID );
+            CHECK( out.ForcePlates[i].nChannels == src.ForcePlates[i].nChannels );
+            CHECK( SameAnalog( out.ForcePlates[i].ChannelData, src.ForcePlates[i].ChannelData,
+                src.ForcePlates[i].nChannels ) );
+        }
+    }
+
+    if( present & natnet::FrameSection_Devices )
+    {
+        CHECK( out.nDevices == src.nDevices );
+        CHECK( src.nDevices > 0 );
+        for( int i = 0; ( i < out.nDevices ) && ( i < src.nDevices ); i++ )
+        {
+            CHECK( out.Devices[i].ID == src.Devices[i].ID );
+            CHECK( out.Devices[i].nChannels == src.Devices[i].nChannels );
+            CHECK( SameAnalog( out.Devices[i].ChannelData, src.Devices[i].ChannelData,
+                src.Devices[i].nChannels ) );
+        }
+    }
+
+    CHECK( out.Timecode == src.Timecode );
+    CHECK( out.TimecodeSubframe == src.TimecodeSubframe );
+    CHECK( (float) out.fTimestamp == (float) src.fTimestamp );
+    if( major >= 3 )
+    {
+        CHECK( out.fTimestamp == src.fTimestamp );
+        CHECK( out.CameraMidExposureTimestamp == src.CameraMidExposureTimestamp );
+        CHECK( out.CameraDataReceivedTimestamp == src.CameraDataReceivedTimestamp );
+        CHECK( out.TransmitTimestamp == src.TransmitTimestamp );
+    }
+    if( natnet::HasSectionSizes( major, minor ) )
+    {
+        CHECK( out.PrecisionTimestampSecs == src.PrecisionTimestampSecs );
+        CHECK( out.PrecisionTimestampFractionalSecs == src.PrecisionTimestampFractionalSecs );
+    }
+    CHECK( out.params == src.params );
+}
+
+/**
+ * \brief Subscribe to one section at a time: it decodes in full, the others read as empty,
+ * and the frame still ends where the full decode ends
+ */
+void TestSubscriptions( const test::Version& v, const TestFrame& encoded )
+{
+    const int major = v.major;
+    const int minor = v.minor;
+    const char* data = encoded.data();
+    const int nBytes = encoded.nBytes();
+    const char* fullEnd = encoded.end();
+
+    natnet::FrameDecoder decoder( major, minor );
+    std::unique_ptr<natnet::MocapFrame> full( new natnet::MocapFrame() );
+    decoder.unpack( data, nBytes, *full );
+    const sFrameOfMocapData& all = full->data;
+
+    std::unique_ptr<natnet::MocapFrame> frame( new natnet::MocapFrame() );
+
+    for( uint32_t section : test::kFrameSections )
+    {
+        const sFrameOfMocapData& out = frame->data;
+        CHECK( decoder.unpack( data, nBytes, *frame, section ) == fullEnd );
+        CHECK( out.nMarkerSets == ( ( section == natnet::FrameSection_MarkerSets ) ? all.nMarkerSets : 0 ) );
+        CHECK( out.nOtherMarkers == ( ( section == natnet::FrameSection_LegacyOtherMarkers ) ? all.nOtherMarkers : 0 ) );
+        CHECK( out.nRigidBodies == ( ( section == natnet::FrameSection_RigidBodies ) ? all.nRigidBodies : 0 ) );
+        CHECK( out.nSkeletons == ( ( section == natnet::FrameSection_Skeletons ) ? all.nSkeletons : 0 ) );
+        CHECK( out.nAssets == ( ( section == natnet::FrameSection_Assets ) ? all.nAssets : 0 ) );
+        CHECK( out.nLabeledMarkers == ( ( section == natnet::FrameSection_LabeledMarkers ) ? all.nLabeledMarkers : 0 ) );
+        CHECK( out.nForcePlates == ( ( section == natnet::FrameSection_ForcePlates ) ? all.nForcePlates : 0 ) );
+        CHECK( out.nDevices == ( ( section == natnet::FrameSection_Devices ) ? all.nDevices : 0 ) );
+        CHECK( ( out.Timecode == all.Timecode ) && ( out.fTimestamp == all.fTimestamp ) && ( out.params == all.params ) );
+        if( ( section == natnet::FrameSection_RigidBodies ) && ( all.nRigidBodies > 0 ) )
+        {
+            CHECK( SameRigidBody( out.RigidBodies[all.nRigidBodies - 1], all.RigidBodies[all.nRigidBodies - 1] ) );
+        }
+        if( ( section == natnet::FrameSection_LabeledMarkers ) && ( all.nLabeledMarkers > 0 ) )
+        {
+            CHECK( SameMarker( out.LabeledMarkers[all.nLabeledMarkers - 1], all.LabeledMarkers[all.nLabeledMarkers - 1] ) );
+        }
+
+    }
+}
+
+} // namespace
+
+int main()
+{
+    test::Begin();
+
+    for( const test::Version& v : test::TestVersions() )
+    {
+        test::SetContext( "NatNet %d.%d", v.major, v.minor );
+        TestFrame encoded( v );
+        TestRoundTrip( v, encoded );
+        TestSubscriptions( v, encoded );
+    }
+
+    return test::Finish();
+}
@@ -0,0 +1,190 @@
+/**
+ * \file   FrameRingTests.cpp
+ * \brief  Two thread stress test of FrameRing under both overflow policies.
+ * A producer pushes numbered frames as fast as it can while a consumer pops
+ * them, now and then holding a frame for a while so that the ring overflows.
+ * The consumer must get frames in strictly increasing order and untorn, the
+ * frames it got plus dropped() must add up to the frames pushed, and the
+ * producer must never be handed the frame the consumer holds. Exits with 1 if
+ * any check failed.
+ */
+
+#include "TestSupport.h"
+
+#include "FrameRing.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+const uint64_t kFrames = 200000;
+
+/**
+ * \brief Frame whose every field is its sequence number once written.
+ * Atomic fields, so that a broken hand-over shows up as a torn frame
+ * rather than as undefined behavior.
+ */
+struct StressFrame
+{
+    std::atomic<uint64_t> seq;
+    std::atomic<uint64_t> copies[7];
+    std::atomic<bool> held;                     // set by the consumer between pop() and release()
+};
+
+void Write( StressFrame& frame, uint64_t seq )
+{
+    frame.seq.store( seq, std::memory_order_relaxed );
+    for( std::atomic<uint64_t>& copy : frame.copies )
+    {
+        copy.store( seq, std::memory_order_relaxed );
+    }
+}
+
+bool Whole( const StressFrame& frame, uint64_t seq )
+{
+    if( frame.seq.load( std::memory_order_relaxed ) != seq )
+    {
+        return false;
+    }
+    for( const std::atomic<uint64_t>& copy : frame.copies )
+    {
+        if( copy.load( std::memory_order_relaxed ) != seq )
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void TestStress( int capacity, natnet::RingOverflowPolicy policy )
+{
+    natnet::FrameRing<StressFrame> ring( capacity, policy );
+    for( int i = 0; i < ring.frameCount(); i++ )
+    {
+        Write( ring.frame( i ), 0 );
+        ring.frame( i ).held.store( false );
+    }
+
+    std::atomic<bool> done( false );
+    uint64_t rejected = 0;                      // push() returned false
+    uint64_t overwritten = 0;                   // producer was handed a held frame
+
+    std::thread producer( [&]() {
+        for( uint64_t seq = 1; seq <= kFrames; seq++ )
+        {
+            StressFrame& frame = ring.writeFrame();
+            if( frame.held.load( std::memory_order_seq_cst ) )
+            {
+                overwritten++;
+            }
+            Write( frame, seq );
+            if( !ring.push() )
+            {
+                rejected++;
+            }
+            if( ( seq % 16 ) == 0 )
+            {
+                std::this_thread::yield();
+            }
+        }
+        done.store( true, std::memory_order_release );
+    } );
+
+    // consumer
+    std::vector<uint64_t> received;
+    received.reserve( kFrames );
+    uint64_t torn = 0;
+    StressFrame* frame = nullptr;
+    for( ;; )
+    {
+        const bool finished = done.load( std::memory_order_acquire );
+        if( frame )
+        {
+            frame->held.store( false, std::memory_order_seq_cst );
+        }
+        frame = ring.pop();
+        if( !frame )
+        {
+            if( finished )
+            {
+                break;
+            }
+            std::this_thread::yield();
+            continue;
+        }
+        frame->held.store( true, std::memory_order_seq_cst );
+
+        const uint64_t seq = frame->seq.load( std::memory_order_relaxed );
+        received.push_back( seq );
+        if( !Whole( *frame, seq ) )
+        {
+            torn++;
+        }
+
+        // hold every 256th frame long enough for the producer to fill the ring
+        if( ( received.size() % 256 ) == 0 )
+        {
+            for( int i = 0; i < 200; i++ )
+            {
+                std::this_thread::yield();
+                if( !Whole( *frame, seq ) )
+                {
+                    torn++;
+                    break;
+                }
+            }
+        }
+    }
+    ring.release();
+    producer.join();
+
+    bool increasing = true;
+    for( size_t i = 1; i < received.size(); i++ )
+    {
+        increasing = increasing && ( received[i - 1] < received[i] );
+    }
+
+    CHECK( increasing );
+    CHECK( torn == 0 );
+    CHECK( overwritten == 0 );
+    CHECK( received.size() + ring.dropped() == kFrames );
+    CHECK( ring.size() == 0 );
+    if( policy == natnet::RingOverflow_DropNewest )
+    {
+        // the oldest frames are kept
+        CHECK( rejected == ring.dropped() );
+        CHECK( !received.empty() && ( received.front() == 1 ) );
+    }
+    else
+    {
+        // the newest frame is kept
+        CHECK( rejected == 0 );
+        CHECK( !received.empty() && ( received.back() == kFrames ) );
+    }
+    printf( "%s, capacity %d: %d received, %d dropped\n",
+        ( policy == natnet::RingOverflow_DropNewest ) ? "drop newest" : "overwrite oldest",
+        capacity, (int) received.size(), (int) ring.dropped() );
+}
+
+} // namespace
+
+int main()
+{
+    test::Begin();
+
+    for( int capacity : { 1, 4, 64 } )
+    {
+        test::SetContext( "drop newest, capacity %d", capacity );
+        TestStress( capacity, natnet::RingOverflow_DropNewest );
+
+        test::SetContext( "overwrite oldest, capacity %d", capacity );
+        TestStress( capacity, natnet::RingOverflow_OverwriteOldest );
+    }
+
+    return test::Finish();
+}
@@ -0,0 +1,180 @@
+/**
+ * \file   FrameSoATests.cpp
+ * \brief  Checks of the structure-of-arrays decoder against NatNetEncoder payloads.
+ * Every bitstream version from 2.0 to 4.1 is encoded from a FrameSynthesizer
+ * scene that populates every section of that version, then decoded into a
+ * FrameSoA: once in full, with every array compared with the source frame,
+ * and once per single-section subscription mask. Exits with 1 if any check
+ * failed.
+ */
+
+#include "TestSupport.h"
+
+#include "FrameSoA.h"
+#include "NatNetDecoder.h"
+
+#include <NatNetTypes.h>
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+using test::TestFrame;
+
+namespace
+{
+
+bool SameRigidBody( const natnet::RigidBodyArrays& arrays, int i, const sRigidBodyData& rb )
+{
+    return ( arrays.id[i] == rb.ID ) && ( arrays.x[i] == rb.x ) && ( arrays.y[i] == rb.y ) && ( arrays.z[i] == rb.z ) &&
+        ( arrays.qx[i] == rb.qx ) && ( arrays.qy[i] == rb.qy ) && ( arrays.qz[i] == rb.qz ) && ( arrays.qw[i] == rb.qw );
+}
+
+bool SameMarker( const natnet::MarkerArrays& arrays, int i, const sMarker& marker )
+{
+    return ( arrays.id[i] == marker.ID ) && ( arrays.x[i] == marker.x ) && ( arrays.y[i] == marker.y ) &&
+        ( arrays.z[i] == marker.z ) && ( arrays.size[i] == marker.size );
+}
+
+/**
+ * \brief Decode the whole frame and compare every array with the source frame
+ */
+void TestFrameSoA( const test::Version& v, const TestFrame& encoded )
+{
+    const int major = v.major;
+    const int minor = v.minor;
+    const sFrameOfMocapData& src = encoded.frame();
+
+    natnet::FrameDecoder decoder( major, minor );
+    std::unique_ptr<natnet::FrameSoA> soa( new natnet::FrameSoA() );
+    CHECK( decoder.unpack( encoded.data(), encoded.nBytes(), *soa ) == encoded.end() );
+    CHECK( soa->iFrame == src.iFrame );
+
+    CHECK( soa->otherMarkers.count == src.nOtherMarkers );
+    for( int i = 0; ( i < soa->otherMarkers.count ) && ( i < src.nOtherMarkers ); i++ )
+    {
+        CHECK( ( soa->otherMarkers.x[i] == src.OtherMarkers[i][0] ) && ( soa->otherMarkers.y[i] == src.OtherMarkers[i][1] ) &&
+            ( soa->otherMarkers.z[i] == src.OtherMarkers[i][2] ) );
+    }
+
+    CHECK( soa->rigidBodies.count == src.nRigidBodies );
+    for( int i = 0; ( i < soa->rigidBodies.count ) && ( i < src.nRigidBodies ); i++ )
+    {
+        CHECK( SameRigidBody( soa->rigidBodies, i, src.RigidBodies[i] ) );
+        CHECK( soa->rigidBodies.meanError[i] == src.RigidBodies[i].MeanError );
+    }
+
+    // nested records are ranges into one array per record type
+    CHECK( (int) soa->skeletons.size() == src.nSkeletons );
+    int bones = 0;
+    for( int i = 0; ( i < (int) soa->skeletons.size() ) && ( i < src.nSkeletons ); i++ )
+    {
+        const natnet::SkeletonRange& range = soa->skeletons[i];
+        CHECK( range.skeletonID == src.Skeletons[i].skeletonID );
+        CHECK( ( range.firstRigidBody == bones ) && ( range.nRigidBodies == src.Skeletons[i].nRigidBodies ) );
+        for( int k = 0; k < src.Skeletons[i].nRigidBodies; k++ )
+        {
+            CHECK( SameRigidBody( soa->skeletonRigidBodies, range.firstRigidBody + k, src.Skeletons[i].RigidBodyData[k] ) );
+        }
+        bones += range.nRigidBodies;
+    }
+    CHECK( soa->skeletonRigidBodies.count == bones );
+
+    CHECK( (int) soa->assets.size() == src.nAssets );
+    int assetRigidBodies = 0;
+    int assetMarkers = 0;
+    for( int i = 0; ( i < (int) soa->assets.size() ) && ( i < src.nAssets ); i++ )
+    {
+        const natnet::AssetRange& range = soa->assets[i];
+        const sAssetData& a = src.Assets[i];
+        CHECK( range.assetID == a.assetID );
+        CHECK( ( range.firstRigidBody == assetRigidBodies ) && ( range.nRigidBodies == a.nRigidBodies ) );
+        CHECK( ( range.firstMarker == assetMarkers ) && ( range.nMarkers == a.nMarkers ) );
+        for( int k = 0; k < a.nRigidBodies; k++ )
+        {
+            CHECK( SameRigidBody( soa->assetRigidBodies, range.firstRigidBody + k, a.RigidBodyData[k] ) );
+        }
+        for( int k = 0; k < a.nMarkers; k++ )
+        {
+            CHECK( SameMarker( soa->assetMarkers, range.firstMarker + k, a.MarkerData[k] ) );
+        }
+        assetRigidBodies += range.nRigidBodies;
+        assetMarkers += range.nMarkers;
+    }
+    CHECK( ( soa->assetRigidBodies.count == assetRigidBodies ) && ( soa->assetMarkers.count == assetMarkers ) );
+
+    CHECK( soa->labeledMarkers.count == src.nLabeledMarkers );
+    for( int i = 0; ( i < soa->labeledMarkers.count ) && ( i < src.nLabeledMarkers ); i++ )
+    {
+        CHECK( SameMarker( soa->labeledMarkers, i, src.LabeledMarkers[i] ) );
+    }
+
+    CHECK( soa->Timecode == src.Timecode );
+    CHECK( soa->TimecodeSubframe == src.TimecodeSubframe );
+    CHECK( (float) soa->fTimestamp == (float) src.fTimestamp );
+    if( major >= 3 )
+    {
+        CHECK( soa->fTimestamp == src.fTimestamp );
+        CHECK( soa->CameraMidExposureTimestamp == src.CameraMidExposureTimestamp );
+        CHECK( soa->CameraDataReceivedTimestamp == src.CameraDataReceivedTimestamp );
+        CHECK( soa->TransmitTimestamp == src.TransmitTimestamp );
+    }
+    if( natnet::HasSectionSizes( major, minor ) )
+    {
+        CHECK( soa->PrecisionTimestampSecs == src.PrecisionTimestampSecs );
+        CHECK( soa->PrecisionTimestampFractionalSecs == src.PrecisionTimestampFractionalSecs );
+    }
+    CHECK( soa->params == src.params );
+}
+
+/**
+ * \brief Subscribe to one section at a time: it decodes in full, the others read as empty,
+ * and the frame still ends where the full decode ends. FrameSoA has no markerset,
+ * force plate or device arrays; those sections are always stepped over.
+ */
+void TestFrameSoASubscriptions( const test::Version& v, const TestFrame& encoded )
+{
+    const int major = v.major;
+    const int minor = v.minor;
+    const sFrameOfMocapData& all = encoded.frame();
+
+    natnet::FrameDecoder decoder( major, minor );
+    std::unique_ptr<natnet::FrameSoA> soa( new natnet::FrameSoA() );
+    for( uint32_t section : test::kFrameSections )
+    {
+        CHECK( decoder.unpack( encoded.data(), encoded.nBytes(), *soa, section ) == encoded.end() );
+        CHECK( soa->otherMarkers.count == ( ( section == natnet::FrameSection_LegacyOtherMarkers ) ? all.nOtherMarkers : 0 ) );
+        CHECK( soa->rigidBodies.count == ( ( section == natnet::FrameSection_RigidBodies ) ? all.nRigidBodies : 0 ) );
+        CHECK( (int) soa->skeletons.size() == ( ( section == natnet::FrameSection_Skeletons ) ? all.nSkeletons : 0 ) );
+        CHECK( (int) soa->assets.size() == ( ( section == natnet::FrameSection_Assets ) ? all.nAssets : 0 ) );
+        CHECK( soa->labeledMarkers.count == ( ( section == natnet::FrameSection_LabeledMarkers ) ? all.nLabeledMarkers : 0 ) );
+        CHECK( ( soa->Timecode == all.Timecode ) && ( (float) soa->fTimestamp == (float) all.fTimestamp ) && ( soa->params == all.params ) );
+        if( ( section == natnet::FrameSection_RigidBodies ) && ( all.nRigidBodies > 0 ) )
+        {
+            const int last = all.nRigidBodies - 1;
+            CHECK( SameRigidBody( soa->rigidBodies, last, all.RigidBodies[last] ) );
+        }
+        if( ( section == natnet::FrameSection_LabeledMarkers ) && ( all.nLabeledMarkers > 0 ) )
+        {
+            const int last = all.nLabeledMarkers - 1;
+            CHECK( SameMarker( soa->labeledMarkers, last, all.LabeledMarkers[last] ) );
+        }
+    }
+}
+
+} // namespace
+
+int main()
+{
+    test::Begin();
+
+    for( const test::Version& v : test::TestVersions() )
+    {
+        test::SetContext( "NatNet %d.%d", v.major, v.minor );
+        TestFrame encoded( v );
+        TestFrameSoA( v, encoded );
+        TestFrameSoASubscriptions( v, encoded );
+    }
+
+    return test::Finish();
+}
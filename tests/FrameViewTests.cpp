@@ -0,0 +1,229 @@
+/**
+ * \file   FrameViewTests.cpp
+ * \brief  Checks of FrameView against NatNetEncoder payloads.
+ * Every bitstream version from 2.0 to 4.1 is encoded from a FrameSynthesizer
+ * scene that populates every section of that version, then indexed by
+ * FrameView: once in full, with every accessor compared with the source
+ * frame, and once per single-section subscription mask. Exits with 1 if any
+ * check failed.
+ */
+
+#include "TestSupport.h"
+
+#include "FrameView.h"
+#include "NatNetDecoder.h"
+
+#include <NatNetTypes.h>
+
+#include <cstdint>
+#include <cstring>
+
+using test::TestFrame;
+
+namespace
+{
+
+bool SameRigidBody( const natnet::RigidBodyView& view, const sRigidBodyData& rb )
+{
+    natnet::Vec3 position = view.position();
+    natnet::Quat orientation = view.orientation();
+    return ( view.id() == rb.ID ) && ( position.x == rb.x ) && ( position.y == rb.y ) && ( position.z == rb.z ) &&
+        ( orientation.qx == rb.qx ) && ( orientation.qy == rb.qy ) && ( orientation.qz == rb.qz ) &&
+        ( orientation.qw == rb.qw );
+}
+
+bool SameMarker( const natnet::MarkerView& view, const sMarker& marker )
+{
+    natnet::Vec3 position = view.position();
+    return ( view.id() == marker.ID ) && ( position.x == marker.x ) && ( position.y == marker.y ) &&
+        ( position.z == marker.z ) && ( view.size() == marker.size );
+}
+
+bool SameAnalog( const natnet::AnalogDataView& view, int32_t id, int nChannels, const sAnalogChannelData* channels )
+{
+    if( ( view.id() != id ) || ( view.channelCount() != nChannels ) )
+    {
+        return false;
+    }
+    for( int c = 0; c < nChannels; c++ )
+    {
+        natnet::AnalogChannelView channel = view.channel( c );
+        if( channel.frameCount() != channels[c].nFrames )
+        {
+            return false;
+        }
+        for( int j = 0; j < channels[c].nFrames; j++ )
+        {
+            if( channel.value( j ) != channels[c].Values[j] )
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * \brief Index the whole frame and read every record back through the view
+ */
+void TestView( const test::Version& v, const TestFrame& encoded )
+{
+    const int major = v.major;
+    const int minor = v.minor;
+    const sFrameOfMocapData& src = encoded.frame();
+
+    natnet::FrameView view;
+    CHECK( view.parse( encoded.data(), encoded.nBytes(), major, minor ) == encoded.end() );
+    CHECK( view.frameNumber() == src.iFrame );
+
+    CHECK( view.markerSetCount() == src.nMarkerSets );
+    for( int i = 0; ( i < view.markerSetCount() ) && ( i < src.nMarkerSets ); i++ )
+    {
+        natnet::MarkerSetView markerSet = view.markerSet( i );
+        CHECK( strcmp( markerSet.name(), src.MocapData[i].szName ) == 0 );
+        CHECK( markerSet.markerCount() == src.MocapData[i].nMarkers );
+        for( int k = 0; k < src.MocapData[i].nMarkers; k++ )
+        {
+            natnet::Vec3 marker = markerSet.marker( k );
+            CHECK( memcmp( &marker, src.MocapData[i].Markers[k], sizeof( MarkerData ) ) == 0 );
+        }
+    }
+
+    CHECK( view.otherMarkerCount() == src.nOtherMarkers );
+    for( int i = 0; ( i < view.otherMarkerCount() ) && ( i < src.nOtherMarkers ); i++ )
+    {
+        natnet::Vec3 marker = view.otherMarker( i );
+        CHECK( memcmp( &marker, src.OtherMarkers[i], sizeof( MarkerData ) ) == 0 );
+    }
+
+    CHECK( view.rigidBodyCount() == src.nRigidBodies );
+    for( int i = 0; ( i < view.rigidBodyCount() ) && ( i < src.nRigidBodies ); i++ )
+    {
+        CHECK( SameRigidBody( view.rigidBody( i ), src.RigidBodies[i] ) );
+        CHECK( view.rigidBody( i ).meanError() == src.RigidBodies[i].MeanError );
+        CHECK( view.findRigidBody( src.RigidBodies[i].ID ) == i );
+    }
+
+    CHECK( view.skeletonCount() == src.nSkeletons );
+    for( int i = 0; ( i < view.skeletonCount() ) && ( i < src.nSkeletons ); i++ )
+    {
+        natnet::SkeletonView skeleton = view.skeleton( i );
+        CHECK( skeleton.id() == src.Skeletons[i].skeletonID );
+        CHECK( skeleton.rigidBodyCount() == src.Skeletons[i].nRigidBodies );
+        for( int k = 0; k < src.Skeletons[i].nRigidBodies; k++ )
+        {
+            CHECK( SameRigidBody( skeleton.rigidBody( k ), src.Skeletons[i].RigidBodyData[k] ) );
+        }
+    }
+
+    CHECK( view.assetCount() == src.nAssets );
+    for( int i = 0; ( i < view.assetCount() ) && ( i < src.nAssets ); i++ )
+    {
+        natnet::AssetView asset = view.asset( i );
+        const sAssetData& a = src.Assets[i];
+        CHECK( ( asset.id() == a.assetID ) && ( asset.rigidBodyCount() == a.nRigidBodies ) && ( asset.markerCount() == a.nMarkers ) );
+        for( int k = 0; k < a.nRigidBodies; k++ )
+        {
+            CHECK( SameRigidBody( asset.rigidBody( k ), a.RigidBodyData[k] ) );
+        }
+        for( int k = 0; k < a.nMarkers; k++ )
+        {
+            CHECK( SameMarker( asset.marker( k ), a.MarkerData[k] ) );
+        }
+    }
+
+    CHECK( view.labeledMarkerCount() == src.nLabeledMarkers );
+    for( int i = 0; ( i < view.labeledMarkerCount() ) && ( i < src.nLabeledMarkers ); i++ )
+    {
+        CHECK( SameMarker( view.labeledMarker( i ), src.LabeledMarkers[i] ) );
+    }
+
+    CHECK( view.forcePlateCount() == src.nForcePlates );
+    for( int i = 0; ( i < view.forcePlateCount() ) && ( i < src.nForcePlates ); i++ )
+    {
+        const sForcePlateData& plate = src.ForcePlates[i];
+        CHECK( SameAnalog( view.forcePlate( i ), plate.ID, plate.nChannels, plate.ChannelData ) );
+    }
+
+    CHECK( view.deviceCount() == src.nDevices );
+    for( int i = 0; ( i < view.deviceCount() ) && ( i < src.nDevices ); i++ )
+    {
+        const sDeviceData& device = src.Devices[i];
+        CHECK( SameAnalog( view.device( i ), device.ID, device.nChannels, device.ChannelData ) );
+    }
+
+    CHECK( view.timecode() == src.Timecode );
+    CHECK( view.timecodeSubframe() == src.TimecodeSubframe );
+    CHECK( (float) view.timestamp() == (float) src.fTimestamp );
+    if( major >= 3 )
+    {
+        CHECK( view.timestamp() == src.fTimestamp );
+        CHECK( view.cameraMidExposureTimestamp() == src.CameraMidExposureTimestamp );
+        CHECK( view.cameraDataReceivedTimestamp() == src.CameraDataReceivedTimestamp );
+        CHECK( view.transmitTimestamp() == src.TransmitTimestamp );
+    }
+    if( natnet::HasSectionSizes( major, minor ) )
+    {
+        CHECK( view.precisionTimestampSecs() == src.PrecisionTimestampSecs );
+        CHECK( view.precisionTimestampFractionalSecs() == src.PrecisionTimestampFractionalSecs );
+    }
+    CHECK( view.params() == src.params );
+
+    // the frame does not end within fewer bytes
+    CHECK( view.parse( encoded.data(), encoded.nBytes() - 1, major, minor ) == nullptr );
+}
+
+/**
+ * \brief Index one section at a time: it is indexed in full, the others read as empty,
+ * and the frame still ends where the full index ends
+ */
+void TestViewSubscriptions( const test::Version& v, const TestFrame& encoded )
+{
+    const int major = v.major;
+    const int minor = v.minor;
+    const sFrameOfMocapData& all = encoded.frame();
+
+    natnet::FrameView view;
+    for( uint32_t section : test::kFrameSections )
+    {
+        CHECK( view.parse( encoded.data(), encoded.nBytes(), major, minor, section ) == encoded.end() );
+        CHECK( view.markerSetCount() == ( ( section == natnet::FrameSection_MarkerSets ) ? all.nMarkerSets : 0 ) );
+        CHECK( view.otherMarkerCount() == ( ( section == natnet::FrameSection_LegacyOtherMarkers ) ? all.nOtherMarkers : 0 ) );
+        CHECK( view.rigidBodyCount() == ( ( section == natnet::FrameSection_RigidBodies ) ? all.nRigidBodies : 0 ) );
+        CHECK( view.skeletonCount() == ( ( section == natnet::FrameSection_Skeletons ) ? all.nSkeletons : 0 ) );
+        CHECK( view.assetCount() == ( ( section == natnet::FrameSection_Assets ) ? all.nAssets : 0 ) );
+        CHECK( view.labeledMarkerCount() == ( ( section == natnet::FrameSection_LabeledMarkers ) ? all.nLabeledMarkers : 0 ) );
+        CHECK( view.forcePlateCount() == ( ( section == natnet::FrameSection_ForcePlates ) ? all.nForcePlates : 0 ) );
+        CHECK( view.deviceCount() == ( ( section == natnet::FrameSection_Devices ) ? all.nDevices : 0 ) );
+        CHECK( ( view.timecode() == all.Timecode ) && ( (float) view.timestamp() == (float) all.fTimestamp ) );
+        CHECK( view.params() == all.params );
+        if( ( section == natnet::FrameSection_RigidBodies ) && ( all.nRigidBodies > 0 ) )
+        {
+            const int last = all.nRigidBodies - 1;
+            CHECK( SameRigidBody( view.rigidBody( last ), all.RigidBodies[last] ) );
+            CHECK( view.rigidBody( last ).meanError() == all.RigidBodies[last].MeanError );
+        }
+        if( ( section == natnet::FrameSection_Devices ) && ( all.nDevices > 0 ) )
+        {
+            const sDeviceData& device = all.Devices[all.nDevices - 1];
+            CHECK( SameAnalog( view.device( all.nDevices - 1 ), device.ID, device.nChannels, device.ChannelData ) );
+        }
+    }
+}
+
+} // namespace
+
+int main()
+{
+    test::Begin();
+
+    for( const test::Version& v : test::TestVersions() )
+    {
+        test::SetContext( "NatNet %d.%d", v.major, v.minor );
+        TestFrame encoded( v );
+        TestView( v, encoded );
+        TestViewSubscriptions( v, encoded );
+    }
+
+    return test::Finish();
+}
@@ -0,0 +1,157 @@
+/**
+ * \file   LatestFrameTests.cpp
+ * \brief  Writer/reader stress test of LatestFrame.
+ * A writer publishes numbered frames as fast as it can while a reader keeps
+ * reading the latest one, now and then holding it for a while. The reader
+ * must never see a torn frame or an older frame than it saw before, the
+ * writer must never be handed the frame the reader holds, and the last frame
+ * published must be the last one read. Exits with 1 if any check failed.
+ */
+
+#include "TestSupport.h"
+
+#include "LatestFrame.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+
+namespace
+{
+
+const uint64_t kFrames = 200000;
+
+/**
+ * \brief Frame whose every field is its sequence number once written.
+ * Atomic fields, so that a broken hand-over shows up as a torn frame
+ * rather than as undefined behavior.
+ */
+struct StressFrame
+{
+    std::atomic<uint64_t> seq;
+    std::atomic<uint64_t> copies[7];
+};
+
+void Write( StressFrame& frame, uint64_t seq )
+{
+    frame.seq.store( seq, std::memory_order_relaxed );
+    for( std::atomic<uint64_t>& copy : frame.copies )
+    {
+        copy.store( seq, std::memory_order_relaxed );
+    }
+}
+
+bool Whole( const StressFrame& frame, uint64_t seq )
+{
+    if( frame.seq.load( std::memory_order_relaxed ) != seq )
+    {
+        return false;
+    }
+    for( const std::atomic<uint64_t>& copy : frame.copies )
+    {
+        if( copy.load( std::memory_order_relaxed ) != seq )
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void TestStress()
+{
+    natnet::LatestFrame<StressFrame> latest;
+    for( int i = 0; i < latest.frameCount(); i++ )
+    {
+        Write( latest.frame( i ), 0 );
+    }
+    CHECK( !latest.hasNewFrame() );
+    CHECK( latest.read() == nullptr );
+
+    std::atomic<bool> done( false );
+    std::atomic<const StressFrame*> held( nullptr );    // frame the reader is reading
+    uint64_t overwritten = 0;                           // writer was handed the held frame
+
+    std::thread writer( [&]() {
+        for( uint64_t seq = 1; seq <= kFrames; seq++ )
+        {
+            StressFrame& frame = latest.writeFrame();
+            if( held.load( std::memory_order_seq_cst ) == &frame )
+            {
+                overwritten++;
+            }
+            Write( frame, seq );
+            latest.publish();
+            if( ( seq % 16 ) == 0 )
+            {
+                std::this_thread::yield();
+            }
+        }
+        done.store( true, std::memory_order_release );
+    } );
+
+    // reader
+    uint64_t last = 0;
+    uint64_t reads = 0;
+    uint64_t torn = 0;
+    uint64_t backwards = 0;
+    for( ;; )
+    {
+        const bool finished = done.load( std::memory_order_acquire );
+        held.store( nullptr, std::memory_order_seq_cst );
+        const StressFrame* frame = latest.read();
+        if( !frame )
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        held.store( frame, std::memory_order_seq_cst );
+
+        const uint64_t seq = frame->seq.load( std::memory_order_relaxed );
+        reads++;
+        if( !Whole( *frame, seq ) )
+        {
+            torn++;
+        }
+        if( seq < last )
+        {
+            backwards++;
+        }
+        last = seq;
+
+        // hold every 256th frame long enough for the writer to publish over it
+        if( ( reads % 256 ) == 0 )
+        {
+            for( int i = 0; i < 200; i++ )
+            {
+                std::this_thread::yield();
+                if( !Whole( *frame, seq ) )
+                {
+                    torn++;
+                    break;
+                }
+            }
+        }
+        if( finished && !latest.hasNewFrame() )
+        {
+            break;
+        }
+    }
+    writer.join();
+
+    CHECK( torn == 0 );
+    CHECK( backwards == 0 );
+    CHECK( overwritten == 0 );
+    CHECK( last == kFrames );
+    printf( "latest frame: %d reads\n", (int) reads );
+}
+
+} // namespace
+
+int main()
+{
+    test::Begin();
+    test::SetContext( "latest frame" );
+    TestStress();
+    return test::Finish();
+}
@@ -0,0 +1,99 @@
+/**
+ * \file   MarkerKernelTests.cpp
+ * \brief  Checks of the SSE2 and AVX2 marker kernels against the scalar kernels.
+ * Every vector kernel this CPU supports converts the same random records as
+ * the scalar kernel, for counts around every block size and destination
+ * offsets that are not block aligned. Exits with 1 if any check failed.
+ */
+
+#include "TestSupport.h"
+
+#include "FrameSoA.h"
+#include "MarkerKernels.h"
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+template <typename T>
+bool SameRange( const natnet::AlignedArray<T>& a, const natnet::AlignedArray<T>& b, int first, int count )
+{
+    return memcmp( a.data() + first, b.data() + first, count * sizeof( T ) ) == 0;
+}
+
+bool SamePoints( const natnet::PointArrays& a, const natnet::PointArrays& b, int first, int count )
+{
+    return SameRange( a.x, b.x, first, count ) && SameRange( a.y, b.y, first, count ) &&
+        SameRange( a.z, b.z, first, count );
+}
+
+bool SameMarkers( const natnet::MarkerArrays& a, const natnet::MarkerArrays& b, int first, int count )
+{
+    return SameRange( a.id, b.id, first, count ) && SameRange( a.x, b.x, first, count ) &&
+        SameRange( a.y, b.y, first, count ) && SameRange( a.z, b.z, first, count ) &&
+        SameRange( a.size, b.size, first, count ) && SameRange( a.params, b.params, first, count ) &&
+        SameRange( a.residual, b.residual, first, count );
+}
+
+/**
+ * \brief The vector kernels this CPU runs produce the scalar kernels' arrays,
+ * for counts around every block size and records at odd addresses
+ */
+void TestMarkerKernels()
+{
+    std::mt19937 random( 1511 );
+    std::uniform_int_distribution<int> byte( 0, 255 );
+    const int kMaxCount = 67;
+    std::vector<char> records( 1 + kMaxCount * 26 );
+    for( char& c : records )
+    {
+        c = (char) byte( random );
+    }
+
+    const natnet::MarkerKernels& scalar = natnet::GetMarkerKernels( natnet::MarkerKernel_Scalar );
+    const natnet::MarkerKernelLevel detected = natnet::DetectMarkerKernelLevel();
+    for( int level = natnet::MarkerKernel_SSE2; level <= detected; level++ )
+    {
+        const natnet::MarkerKernels& kernels = natnet::GetMarkerKernels( (natnet::MarkerKernelLevel) level );
+        if( kernels.level != level )
+        {
+            continue;
+        }
+        test::SetContext( "%s marker kernels", kernels.name );
+        for( int count = 0; count <= kMaxCount; count++ )
+        {
+            for( int first = 0; first < 3; first++ )
+            {
+                const char* ptr = records.data() + 1;
+
+                natnet::PointArrays expectedPoints, points;
+                expectedPoints.resize( first + count );
+                points.resize( first + count );
+                scalar.unpackPoints( ptr, count, expectedPoints, first );
+                kernels.unpackPoints( ptr, count, points, first );
+                CHECK( SamePoints( expectedPoints, points, first, count ) );
+
+                natnet::MarkerArrays expectedMarkers, markers;
+                expectedMarkers.resize( first + count );
+                markers.resize( first + count );
+                scalar.unpackMarkers( ptr, count, expectedMarkers, first );
+                kernels.unpackMarkers( ptr, count, markers, first );
+                CHECK( SameMarkers( expectedMarkers, markers, first, count ) );
+            }
+        }
+        printf( "marker kernels: %s matches scalar\n", kernels.name );
+    }
+}
+
+} // namespace
+
+int main()
+{
+    test::Begin();
+    TestMarkerKernels();
+    return test::Finish();
+}
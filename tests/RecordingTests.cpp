@@ -0,0 +1,249 @@
+/**
+ * \file   RecordingTests.cpp
+ * \brief  Round trip of a recording through RecordingWriter and RecordingReader.
+ * A short session is recorded with buffers small enough that records cross
+ * them: server info announcing NatNet 3.1, data descriptions, frames from two
+ * streams, a switch to bitstream 4.1 and frames whose numbers restart. The
+ * reopened recording must index every frame with its stream, version and
+ * receive time, seek by frame number (earliest recording first) and by time,
+ * and decode each frame. Copies of the file cut inside the last record must
+ * read as truncated, up to the last complete record. Exits with 1 if any
+ * check failed.
+ */
+
+#include "TestSupport.h"
+
+#include "NatNetDecoder.h"
+#include "NatNetEncoder.h"
+#include "RecordingReader.h"
+#include "RecordingWriter.h"
+
+#include <NatNetTypes.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+using test::TestFrame;
+
+namespace
+{
+
+const char* kPath = "recordingTests.natrec";
+const char* kTruncatedPath = "recordingTests.truncated.natrec";
+const size_t kBufferBytes = 4096;
+const int64_t kStart = 1000000000;
+const int64_t kFramePeriod = 8333333;
+
+// A frame as it was written
+struct Recorded
+{
+    test::Version version;
+    int32_t frameNumber;
+    uint16_t stream;
+    int64_t nanoseconds;
+    int nRigidBodies;
+    std::vector<char> payload;
+};
+
+void WriteFrame( natnet::RecordingWriter& writer, std::vector<Recorded>& recorded, const test::Version& version,
+    int32_t frameNumber, uint16_t stream, int64_t nanoseconds )
+{
+    TestFrame encoded( version, frameNumber );
+    writer.write( NAT_FRAMEOFDATA, encoded.data(), (uint32_t) encoded.nBytes(), nanoseconds, stream );
+    recorded.push_back( Recorded{ version, frameNumber, stream, nanoseconds, encoded.frame().nRigidBodies, encoded.payload() } );
+}
+
+/**
+ * \brief Record the session
+ * \param recorded - frames in the order they were written
+ * \param descriptions - NAT_MODELDEF payload written before the frames
+ */
+void WriteRecording( std::vector<Recorded>& recorded, std::vector<char>& descriptions )
+{
+    const test::Version v31 = { 3, 1 };
+    const test::Version v41 = { 4, 1 };
+
+    natnet::RecordingWriter writer( kBufferBytes );
+    CHECK( writer.open( kPath ) );
+
+    sServerDescription server = {};
+    strcpy( server.szHostApp, "RecordingTests" );
+    server.NatNetVersion[0] = 3;
+    server.NatNetVersion[1] = 1;
+    std::vector<char> serverInfo;
+    natnet::PackServerInfo( server, serverInfo );
+    writer.write( NAT_SERVERINFO, serverInfo.data(), (uint32_t) serverInfo.size(), kStart );
+
+    natnet::FrameSynthesizer synthesizer( test::TestScene() );
+    natnet::PackDataDescriptions( synthesizer.descriptions(), 3, 1, descriptions );
+    writer.write( NAT_MODELDEF, descriptions.data(), (uint32_t) descriptions.size(), kStart );
+
+    // two sockets receive every frame
+    int64_t t = kStart + kFramePeriod;
+    for( int32_t frameNumber = 100; frameNumber < 103; frameNumber++ )
+    {
+        WriteFrame( writer, recorded, v31, frameNumber, 0, t );
+        WriteFrame( writer, recorded, v31, frameNumber, 1, t + 1000 );
+        t += kFramePeriod;
+    }
+
+    // the client asks for 4.1, and the take restarts at frame 100
+    const int version[4] = { 4, 1, 0, 0 };
+    writer.writeBitstreamVersion( version, t );
+    for( int32_t frameNumber : { 100, 101, 103 } )
+    {
+        WriteFrame( writer, recorded, v41, frameNumber, 0, t );
+        t += kFramePeriod;
+    }
+
+    writer.close();
+    CHECK( writer.ok() );
+    CHECK( writer.recordsDropped() == 0 );
+    CHECK( writer.bytesWritten() > 2 * kBufferBytes );
+}
+
+void TestIndex( const natnet::RecordingReader& reader, const std::vector<Recorded>& recorded, const std::vector<char>& descriptions )
+{
+    CHECK( !reader.truncated() );
+    CHECK( reader.serverInfo().nBytes >= sizeof( sSender ) );
+    CHECK( reader.descriptionsCount() == 1 );
+
+    CHECK( reader.frameCount() == recorded.size() );
+    std::unique_ptr<natnet::MocapFrame> frame( new natnet::MocapFrame() );
+    for( size_t i = 0; ( i < reader.frameCount() ) && ( i < recorded.size() ); i++ )
+    {
+        const natnet::RecordedFrame& f = reader.frame( i );
+        const Recorded& r = recorded[i];
+        test::SetContext( "frame %d", (int) i );
+        CHECK( ( f.frameNumber == r.frameNumber ) && ( f.stream == r.stream ) && ( f.nanoseconds == r.nanoseconds ) );
+        CHECK( ( reader.frameContext( i ).major() == r.version.major ) && ( reader.frameContext( i ).minor() == r.version.minor ) );
+
+        natnet::RecordedPayload payload = reader.framePayload( i );
+        CHECK( ( payload.nBytes == r.payload.size() ) && ( memcmp( payload.data, r.payload.data(), r.payload.size() ) == 0 ) );
+
+        natnet::RecordedPayload modelDef;
+        CHECK( reader.frameDescriptions( i, modelDef ) );
+        CHECK( ( modelDef.nBytes == descriptions.size() ) && ( memcmp( modelDef.data, descriptions.data(), descriptions.size() ) == 0 ) );
+
+        frame->data.iFrame = -1;
+        CHECK( reader.decodeFrame( i, *frame ) == natnet::DecodeStatus_OK );
+        CHECK( ( frame->data.iFrame == r.frameNumber ) && ( frame->data.nRigidBodies == r.nRigidBodies ) );
+        CHECK( frame->receiveTimestamp.nanoseconds == r.nanoseconds );
+    }
+}
+
+/**
+ * \brief Frame numbers 100 and 101 were recorded three times each, 102 twice
+ * and 103 once: the earliest recording of a number wins
+ */
+void TestSeek( const natnet::RecordingReader& reader, const std::vector<Recorded>& recorded )
+{
+    test::SetContext( "seek" );
+    const size_t count = reader.frameCount();
+    CHECK( reader.findFrameNumber( 100 ) == 0 );
+    CHECK( reader.findFrameNumber( 101 ) == 2 );
+    CHECK( reader.findFrameNumber( 102 ) == 4 );
+    CHECK( reader.findFrameNumber( 103 ) == 8 );
+    CHECK( reader.findFrameNumber( 99 ) == count );
+    CHECK( reader.findFrameNumber( 104 ) == count );
+    CHECK( reader.seekFrameNumber( 0 ) == 0 );
+    CHECK( reader.seekFrameNumber( 103 ) == 8 );
+    CHECK( reader.seekFrameNumber( 104 ) == count );
+
+    CHECK( reader.seekTime( 0 ) == 0 );
+    for( size_t i = 0; i < recorded.size(); i++ )
+    {
+        CHECK( reader.seekTime( recorded[i].nanoseconds ) == i );
+        CHECK( reader.seekTime( recorded[i].nanoseconds + 1 ) == i + 1 );
+    }
+}
+
+/**
+ * \brief Copy the first nBytes of the recording and read the copy
+ * \return - frames indexed in the copy
+ */
+size_t ReadTruncated( const std::vector<char>& file, size_t nBytes, bool& truncated )
+{
+    FILE* out = fopen( kTruncatedPath, "wb" );
+    CHECK( out != nullptr );
+    if( !out )
+    {
+        return 0;
+    }
+    fwrite( file.data(), 1, nBytes, out );
+    fclose( out );
+
+    natnet::RecordingReader reader;
+    CHECK( reader.open( kTruncatedPath ) );
+    truncated = reader.truncated();
+    for( size_t i = 0; i < reader.frameCount(); i++ )
+    {
+        std::unique_ptr<natnet::MocapFrame> frame( new natnet::MocapFrame() );
+        CHECK( reader.decodeFrame( i, *frame ) == natnet::DecodeStatus_OK );
+    }
+    return reader.frameCount();
+}
+
+void TestTruncated( const natnet::RecordingReader& reader )
+{
+    test::SetContext( "truncated" );
+    std::vector<char> file;
+    FILE* in = fopen( kPath, "rb" );
+    CHECK( in != nullptr );
+    if( !in )
+    {
+        return;
+    }
+    char chunk[4096];
+    size_t n = 0;
+    while( ( n = fread( chunk, 1, sizeof( chunk ), in ) ) > 0 )
+    {
+        file.insert( file.end(), chunk, chunk + n );
+    }
+    fclose( in );
+
+    const size_t count = reader.frameCount();
+    const natnet::RecordedFrame& last = reader.frame( count - 1 );
+    const size_t lastRecord = (size_t) last.offset - sizeof( natnet::RecordHeader );
+    CHECK( file.size() == last.offset + natnet::RecordBytes( last.nBytes ) - sizeof( natnet::RecordHeader ) );
+
+    // within the payload, within the record header, and right after the previous record
+    bool truncated = false;
+    CHECK( ReadTruncated( file, file.size() - 5, truncated ) == count - 1 );
+    CHECK( truncated );
+    CHECK( ReadTruncated( file, lastRecord + 4, truncated ) == count - 1 );
+    CHECK( truncated );
+    CHECK( ReadTruncated( file, lastRecord, truncated ) == count - 1 );
+    CHECK( !truncated );
+
+    remove( kTruncatedPath );
+}
+
+} // namespace
+
+int main()
+{
+    test::Begin();
+
+    std::vector<Recorded> recorded;
+    std::vector<char> descriptions;
+    test::SetContext( "write" );
+    WriteRecording( recorded, descriptions );
+
+    natnet::RecordingReader reader;
+    test::SetContext( "open" );
+    CHECK( reader.open( kPath ) );
+    if( reader.isOpen() )
+    {
+        TestIndex( reader, recorded, descriptions );
+        TestSeek( reader, recorded );
+        TestTruncated( reader );
+    }
+    reader.close();
+    remove( kPath );
+
+    return test::Finish();
+}
@@ -0,0 +1,141 @@
+/**
+ * \file   TestSupport.cpp
+ * \brief  Checks and fixtures shared by the test programs.
+ */
+
+#include "TestSupport.h"
+
+#include "NatNetDecoder.h"
+#include "NatNetEncoder.h"
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+namespace test
+{
+
+namespace
+{
+
+int gChecks = 0;
+int gFailures = 0;
+char gContext[64] = "";                 // what is being checked, for failure messages
+
+} // namespace
+
+void Begin()
+{
+    // failures stay visible if a later check crashes
+    setvbuf( stdout, nullptr, _IOLBF, 0 );
+}
+
+/**
+ * \brief Name what the following checks are about, printf style
+*/
+void SetContext( const char* format, ... )
+{
+    va_list args;
+    va_start( args, format );
+    vsnprintf( gContext, sizeof( gContext ), format, args );
+    va_end( args );
+}
+
+void Check( bool ok, const char* condition, int line )
+{
+    gChecks++;
+    if( !ok )
+    {
+        gFailures++;
+        printf( "FAILED (%s) line %d: %s\n", gContext, line, condition );
+    }
+}
+
+/**
+ * \brief Print the totals
+ * \return - exit code of the test program, 1 if any check failed
+*/
+int Finish()
+{
+    printf( "%d checks, %d failed\n", gChecks, gFailures );
+    return ( gFailures == 0 ) ? 0 : 1;
+}
+
+const std::vector<Version>& TestVersions()
+{
+    static const std::vector<Version> versions = {
+        { 2, 0 }, { 2, 1 }, { 2, 3 }, { 2, 6 }, { 2, 7 }, { 2, 9 }, { 2, 11 },
+        { 3, 0 }, { 3, 1 }, { 4, 0 }, { 4, 1 }
+    };
+    return versions;
+}
+
+const uint32_t kFrameSections[8] = {
+    natnet::FrameSection_MarkerSets, natnet::FrameSection_LegacyOtherMarkers,
+    natnet::FrameSection_RigidBodies, natnet::FrameSection_Skeletons,
+    natnet::FrameSection_Assets, natnet::FrameSection_LabeledMarkers,
+    natnet::FrameSection_ForcePlates, natnet::FrameSection_Devices
+};
+
+// Several records in every section, nested ones included
+natnet::SyntheticScene TestScene()
+{
+    natnet::SyntheticScene scene;
+    scene.markerSets = 2;
+    scene.markerSetMarkers = 5;
+    scene.otherMarkers = 7;
+    scene.rigidBodies = 3;
+    scene.skeletons = 2;
+    scene.skeletonBones = 4;
+    scene.assets = 2;
+    scene.assetRigidBodies = 2;
+    scene.assetMarkers = 3;
+    scene.labeledMarkers = 11;
+    scene.forcePlates = 2;
+    scene.forcePlateChannels = 3;
+    scene.devices = 1;
+    scene.deviceChannels = 2;
+    scene.analogSamples = 4;
+    return scene;
+}
+
+TestFrame::TestFrame( const Version& version, int32_t frameNumber /*= 7*/ )
+    : synthesizer_( TestScene(), natnet::FrameSectionsOf( version.major, version.minor ) )
+    , frame_( &synthesizer_.synthesize( frameNumber ) )
+{
+    frame_->Timecode = 0x01020304;
+    frame_->TimecodeSubframe = 5;
+    frame_->CameraMidExposureTimestamp = 1000001;
+    frame_->CameraDataReceivedTimestamp = 1000002;
+    frame_->TransmitTimestamp = 1000003;
+    frame_->PrecisionTimestampSecs = 42;
+    frame_->PrecisionTimestampFractionalSecs = 43;
+    frame_->params = 0x01;
+    natnet::PackFrameData( *frame_, version.major, version.minor, payload_ );
+}
+
+bool SameRigidBody( const sRigidBodyData& a, const sRigidBodyData& b )
+{
+    return ( a.ID == b.ID ) && ( a.x == b.x ) && ( a.y == b.y ) && ( a.z == b.z ) &&
+        ( a.qx == b.qx ) && ( a.qy == b.qy ) && ( a.qz == b.qz ) && ( a.qw == b.qw );
+}
+
+bool SameMarker( const sMarker& a, const sMarker& b )
+{
+    return ( a.ID == b.ID ) && ( a.x == b.x ) && ( a.y == b.y ) && ( a.z == b.z ) && ( a.size == b.size );
+}
+
+bool SameAnalog( const sAnalogChannelData* a, const sAnalogChannelData* b, int nChannels )
+{
+    for( int c = 0; c < nChannels; c++ )
+    {
+        if( ( a[c].nFrames != b[c].nFrames ) ||
+            ( memcmp( a[c].Values, b[c].Values, a[c].nFrames * sizeof( float ) ) != 0 ) )
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace test
@@ -0,0 +1,73 @@
+/**
+ * \file   TestSupport.h
+ * \brief  Checks and fixtures shared by the test programs.
+ * Each test program is a plain executable registered with CTest: CHECK
+ * counts and reports failed conditions, and Finish() turns them into the
+ * exit code. TestFrame encodes a FrameSynthesizer scene that populates
+ * every section a bitstream version has, for the decoder tests.
+ */
+
+#pragma once
+
+#include "FrameSynthesizer.h"
+
+#include <NatNetTypes.h>
+
+#include <cstdint>
+#include <vector>
+
+#define CHECK( condition ) \
+    test::Check( ( condition ), #condition, __LINE__ )
+
+namespace test
+{
+
+// Checks
+void Begin();
+void SetContext( const char* format, ... );
+void Check( bool ok, const char* condition, int line );
+int Finish();
+
+struct Version
+{
+    int major;
+    int minor;
+};
+
+// One version per frame layout (see DispatchLayout), plus 3.1
+const std::vector<Version>& TestVersions();
+
+// Every FrameSection, one bit each
+extern const uint32_t kFrameSections[8];
+
+natnet::SyntheticScene TestScene();
+
+/**
+ * \brief A frame of TestScene() and its NAT_FRAMEOFDATA payload in one bitstream version.
+ * The suffix fields the synthesizer leaves to the caller are filled in too.
+ */
+class TestFrame
+{
+public:
+    TestFrame( const Version& version, int32_t frameNumber = 7 );
+    TestFrame( const TestFrame& ) = delete;
+    TestFrame& operator=( const TestFrame& ) = delete;
+
+    const sFrameOfMocapData& frame() const { return *frame_; }
+    const std::vector<char>& payload() const { return payload_; }
+    const char* data() const { return payload_.data(); }
+    int nBytes() const { return (int) payload_.size(); }
+    const char* end() const { return payload_.data() + payload_.size(); }
+
+private:
+    natnet::FrameSynthesizer synthesizer_;
+    sFrameOfMocapData* frame_;
+    std::vector<char> payload_;
+};
+
+// Record comparisons, on the fields every version streams
+bool SameRigidBody( const sRigidBodyData& a, const sRigidBodyData& b );
+bool SameMarker( const sMarker& a, const sMarker& b );
+bool SameAnalog( const sAnalogChannelData* a, const sAnalogChannelData* b, int nChannels );
+
+} // namespace test
@@ -0,0 +1,131 @@
+/**
+ * \file   ValidationTests.cpp
+ * \brief  Checks of the bounds checked decode against malformed payloads.
+ * Every bitstream version from 2.0 to 4.1 is encoded from a FrameSynthesizer
+ * scene that populates every section of that version, then truncated to
+ * every shorter length and given corrupt counts and section sizes, all of
+ * which FrameDecoder::unpackChecked must reject without touching its output.
+ * Exits with 1 if any check failed.
+ */
+
+#include "TestSupport.h"
+
+#include "FrameSoA.h"
+#include "NatNetDecoder.h"
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+using test::TestFrame;
+
+namespace
+{
+
+/**
+ * \brief Every proper prefix of a frame is rejected by unpackChecked without touching the output
+ */
+void TestTruncation( const test::Version& v, const TestFrame& encoded )
+{
+    const std::vector<char>& payload = encoded.payload();
+    const int major = v.major;
+    const int minor = v.minor;
+    natnet::FrameDecoder decoder( major, minor );
+    std::unique_ptr<natnet::MocapFrame> frame( new natnet::MocapFrame() );
+    std::unique_ptr<natnet::FrameSoA> soa( new natnet::FrameSoA() );
+
+    // a copy of each prefix, so that reads past it show up under sanitizers
+    for( size_t n = 0; n < payload.size(); n++ )
+    {
+        std::vector<char> prefix( payload.begin(), payload.begin() + n );
+        frame->data.iFrame = -1;
+        natnet::DecodeStatus status = natnet::DecodeStatus_OK;
+        const char* end = decoder.unpackChecked( prefix.data(), (int) n, *frame, status );
+        CHECK( ( end == nullptr ) && ( status != natnet::DecodeStatus_OK ) && ( frame->data.iFrame == -1 ) );
+
+        soa->iFrame = -1;
+        end = decoder.unpackChecked( prefix.data(), (int) n, *soa, status );
+        CHECK( ( end == nullptr ) && ( status != natnet::DecodeStatus_OK ) && ( soa->iFrame == -1 ) );
+    }
+
+    natnet::DecodeStatus status = natnet::DecodeStatus_Truncated;
+    const char* end = decoder.unpackChecked( payload.data(), (int) payload.size(), *frame, status );
+    CHECK( ( status == natnet::DecodeStatus_OK ) && ( end == payload.data() + payload.size() ) );
+}
+
+/**
+ * \brief Reject the payload with one int32 field overwritten
+ * \param offset - byte offset of the field in the payload
+ * \return - status unpackChecked reported
+ */
+natnet::DecodeStatus CheckCorrupt( const test::Version& v, const TestFrame& encoded, size_t offset, int32_t value )
+{
+    std::vector<char> payload = encoded.payload();
+    memcpy( payload.data() + offset, &value, 4 );
+
+    natnet::FrameDecoder decoder( v.major, v.minor );
+    std::unique_ptr<natnet::MocapFrame> frame( new natnet::MocapFrame() );
+    frame->data.iFrame = -1;
+    natnet::DecodeStatus status = natnet::DecodeStatus_OK;
+    CHECK( decoder.unpackChecked( payload.data(), (int) payload.size(), *frame, status ) == nullptr );
+    CHECK( frame->data.iFrame == -1 );
+    CHECK( natnet::ValidateFrameData( payload.data(), (int) payload.size(), v.major, v.minor ) == status );
+    return status;
+}
+
+/**
+ * \brief Corrupt the markerset section header, the first after the frame number
+ */
+void TestCorruptCounts( const test::Version& v, const TestFrame& encoded )
+{
+    const size_t countOffset = 4;
+    CHECK( CheckCorrupt( v, encoded, countOffset, -1 ) == natnet::DecodeStatus_InvalidCount );
+    CHECK( CheckCorrupt( v, encoded, countOffset, 1 << 30 ) != natnet::DecodeStatus_OK );
+
+    if( natnet::HasSectionSizes( v.major, v.minor ) )
+    {
+        const size_t sizeOffset = countOffset + 4;
+        int32_t sectionBytes = 0;
+        memcpy( &sectionBytes, encoded.data() + sizeOffset, 4 );
+        CHECK( CheckCorrupt( v, encoded, sizeOffset, -1 ) == natnet::DecodeStatus_InvalidSectionSize );
+        CHECK( CheckCorrupt( v, encoded, sizeOffset, sectionBytes - 1 ) == natnet::DecodeStatus_InvalidSectionSize );
+        CHECK( CheckCorrupt( v, encoded, sizeOffset, sectionBytes + 4 ) == natnet::DecodeStatus_InvalidSectionSize );
+        CHECK( CheckCorrupt( v, encoded, sizeOffset, encoded.nBytes() ) == natnet::DecodeStatus_Truncated );
+    }
+}
+
+/**
+ * \brief A packet is complete only when its header size fits in the bytes received
+ */
+void TestPacket( const TestFrame& encoded )
+{
+    std::vector<char> packet( 4 + encoded.payload().size() );
+    const uint16_t messageID = NAT_FRAMEOFDATA;
+    const uint16_t nBytes = (uint16_t) encoded.payload().size();
+    memcpy( packet.data(), &messageID, 2 );
+    memcpy( packet.data() + 2, &nBytes, 2 );
+    memcpy( packet.data() + 4, encoded.data(), encoded.payload().size() );
+
+    CHECK( natnet::ValidatePacket( packet.data(), (int) packet.size() ) == natnet::DecodeStatus_OK );
+    CHECK( natnet::ValidatePacket( packet.data(), (int) packet.size() - 1 ) == natnet::DecodeStatus_Truncated );
+    CHECK( natnet::ValidatePacket( packet.data(), 3 ) == natnet::DecodeStatus_Truncated );
+}
+
+} // namespace
+
+int main()
+{
+    test::Begin();
+
+    for( const test::Version& v : test::TestVersions() )
+    {
+        test::SetContext( "NatNet %d.%d", v.major, v.minor );
+        TestFrame encoded( v );
+        TestTruncation( v, encoded );
+        TestCorruptCounts( v, encoded );
+        TestPacket( encoded );
+    }
+
+    return test::Finish();
+}
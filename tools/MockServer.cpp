@@ -0,0 +1,545 @@
+/**
+ * \file   MockServer.cpp
+ * \brief  Stands in for Motive: streams a synthetic scene as a NatNet server.
+ * Answers the command port like Motive (server info, model definitions, the
+ * NATNET_REQUEST_* commands of NatNetRequests.h, bitstream version requests,
+ * keepalive) and streams frames of a FrameSynthesizer scene in any
+ * bitstream version, for end to end tests and benchmarks on a machine
+ * without mocap hardware. High resolution timestamps are steady clock
+ * nanoseconds (HighResClockFrequency 1e9), taken when the frame is built.
+ * Usage:
+ *  mockServer [options]
+ *  --version M.m           bitstream version (default 4.1)
+ *  --rate HZ               frames per second (default 120)
+ *  --max                   send as fast as possible
+ *  --frames N              stop after N frames
+ *  --marker-sets N         --marker-set-markers N      --other-markers N
+ *  --rigid-bodies N        --rigid-body-markers N
+ *  --skeletons N           --bones N
+ *  --assets N              --asset-rigid-bodies N      --asset-markers N
+ *  --labeled-markers N
+ *  --force-plates N        --force-plate-channels N
+ *  --devices N             --device-channels N         --analog-samples N
+ *  --unicast               send to connected clients instead of the multicast group
+ *  --local IP              address of the interface to serve on
+ *  --multicast IP          multicast group (default 239.255.42.99)
+ *  --command-port N        (default 1510)
+ *  --data-port N           (default 1511)
+ */
+
+#include "FrameSynthesizer.h"
+#include "NatNetEncoder.h"
+#include "NatNetServer.h"
+
+#include <NatNetRequests.h>
+
+#include <boost/asio.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+struct MockOptions
+{
+    int version[2] = { 4, 1 };
+    double rate = 120.0;                // 0: as fast as possible
+    uint64_t frames = 0;                // 0: until stopped
+    natnet::SyntheticScene scene;
+    natnet::ServerOptions server;
+};
+
+// What clients can change through requests. Guarded by mutex.
+struct MockState
+{
+    std::mutex mutex;
+    int version[2] = { 4, 1 };          // requested bitstream version
+    bool recording = false;
+    bool editMode = false;
+    bool playing = true;                // timeline, edit mode only
+    int32_t seekFrame = -1;             // SetPlaybackCurrentFrame, -1 if none pending
+    std::vector<std::string> assetNames;
+    std::map<std::string, std::string> properties;  // "node,property" -> value
+};
+
+std::atomic<bool> gStop( false );
+
+void PrintUsage()
+{
+    printf( "Usage: mockServer [--version M.m] [--rate HZ | --max] [--frames N]\n"
+            "       [--marker-sets N] [--marker-set-markers N] [--other-markers N]\n"
+            "       [--rigid-bodies N] [--rigid-body-markers N] [--skeletons N] [--bones N]\n"
+            "       [--assets N] [--asset-rigid-bodies N] [--asset-markers N] [--labeled-markers N]\n"
+            "       [--force-plates N] [--force-plate-channels N] [--devices N] [--device-channels N]\n"
+            "       [--analog-samples N] [--unicast] [--local IP] [--multicast IP]\n"
+            "       [--command-port N] [--data-port N]\n" );
+}
+
+bool ParseVersion( const char* text, int version[2] )
+{
+    int major = 0;
+    int minor = 0;
+    if( ( sscanf( text, "%d.%d", &major, &minor ) < 1 ) || ( major < 2 ) || ( major > 4 ) || ( minor < 0 ) )
+    {
+        return false;
+    }
+    version[0] = major;
+    version[1] = minor;
+    return true;
+}
+
+bool ParseArgs( int argc, char* argv[], MockOptions& options )
+{
+    natnet::SyntheticScene& scene = options.scene;
+    struct Count
+    {
+        const char* name;
+        int* value;
+    };
+    const Count counts[] = {
+        { "--marker-sets", &scene.markerSets },
+        { "--marker-set-markers", &scene.markerSetMarkers },
+        { "--other-markers", &scene.otherMarkers },
+        { "--rigid-bodies", &scene.rigidBodies },
+        { "--rigid-body-markers", &scene.rigidBodyMarkers },
+        { "--skeletons", &scene.skeletons },
+        { "--bones", &scene.skeletonBones },
+        { "--assets", &scene.assets },
+        { "--asset-rigid-bodies", &scene.assetRigidBodies },
+        { "--asset-markers", &scene.assetMarkers },
+        { "--labeled-markers", &scene.labeledMarkers },
+        { "--force-plates", &scene.forcePlates },
+        { "--force-plate-channels", &scene.forcePlateChannels },
+        { "--devices", &scene.devices },
+        { "--device-channels", &scene.deviceChannels },
+        { "--analog-samples", &scene.analogSamples },
+    };
+
+    for( int i = 1; i < argc; i++ )
+    {
+        std::string arg = argv[i];
+        bool hasValue = ( i + 1 < argc );
+        bool parsed = false;
+        for( const Count& count : counts )
+        {
+            if( ( arg == count.name ) && hasValue )
+            {
+                *count.value = atoi( argv[++i] );
+                parsed = true;
+            }
+        }
+        if( parsed )
+        {
+            continue;
+        }
+
+        if( arg == "--version" && hasValue )
+        {
+            if( !ParseVersion( argv[++i], options.version ) )
+            {
+                return false;
+            }
+        }
+        else if( arg == "--rate" && hasValue )
+        {
+            options.rate = atof( argv[++i] );
+            if( options.rate <= 0.0 )
+            {
+                return false;
+            }
+        }
+        else if( arg == "--max" )
+        {
+            options.rate = 0.0;
+        }
+        else if( arg == "--frames" && hasValue )
+        {
+            options.frames = strtoull( argv[++i], nullptr, 10 );
+        }
+        else if( arg == "--unicast" )
+        {
+            options.server.multicast = false;
+        }
+        else if( arg == "--local" && hasValue )
+        {
+            options.server.localAddress = boost::asio::ip::address::from_string( argv[++i] );
+        }
+        else if( arg == "--multicast" && hasValue )
+        {
+            options.server.multicastAddress = boost::asio::ip::address::from_string( argv[++i] );
+        }
+        else if( arg == "--command-port" && hasValue )
+        {
+            options.server.commandPort = (unsigned short) atoi( argv[++i] );
+        }
+        else if( arg == "--data-port" && hasValue )
+        {
+            options.server.dataPort = (unsigned short) atoi( argv[++i] );
+        }
+        else
+        {
+            return false;
+        }
+    }
+    if( options.rate > 0.0 )
+    {
+        options.scene.frameRate = options.rate;
+    }
+    return true;
+}
+
+void RespondInt( std::vector<char>& response, int32_t value )
+{
+    response.resize( sizeof( value ) );
+    memcpy( response.data(), &value, sizeof( value ) );
+}
+
+void RespondFloat( std::vector<char>& response, float value )
+{
+    response.resize( sizeof( value ) );
+    memcpy( response.data(), &value, sizeof( value ) );
+}
+
+void RespondString( std::vector<char>& response, const std::string& value )
+{
+    response.assign( value.c_str(), value.c_str() + value.size() + 1 );
+}
+
+bool SameCommand( const std::string& command, const char* name )
+{
+#ifdef _WIN32
+    return _stricmp( command.c_str(), name ) == 0;
+#else
+    return strcasecmp( command.c_str(), name ) == 0;
+#endif
+}
+
+/**
+ * \brief Answer a NAT_REQUEST the way Motive does
+ * \param request - "Command[,argument...]"
+ * \param response - NAT_RESPONSE payload
+ * \return - false for commands Motive would not recognize
+*/
+bool HandleRequest( MockState& state, double frameRate, const std::string& request, std::vector<char>& response )
+{
+    std::vector<std::string> args;
+    std::stringstream stream( request );
+    std::string token;
+    while( std::getline( stream, token, ',' ) )
+    {
+        args.push_back( token );
+    }
+    if( args.empty() )
+    {
+        return false;
+    }
+    const std::string& command = args[0];
+    std::string arg1 = ( args.size() > 1 ) ? args[1] : std::string();
+
+    std::lock_guard<std::mutex> lock( state.mutex );
+    if( SameCommand( command, "Bitstream" ) )
+    {
+        if( args.size() == 1 )
+        {
+            RespondString( response, "Bitstream," + std::to_string( state.version[0] ) + "." +
+                std::to_string( state.version[1] ) + ".0.0" );
+            return true;
+        }
+        int version[2];
+        bool ok = ParseVersion( arg1.c_str(), version );
+        if( ok )
+        {
+            state.version[0] = version[0];
+            state.version[1] = version[1];
+        }
+        RespondInt( response, ok ? 0 : 1 );
+    }
+    else if( SameCommand( command, NATNET_REQUEST_GETUNITSTOMILLIMETERS ) )
+    {
+        RespondFloat( response, 1000.0f );
+    }
+    else if( SameCommand( command, NATNET_REQUEST_GETFRAMERATE ) )
+    {
+        RespondFloat( response, (float) frameRate );
+    }
+    else if( SameCommand( command, NATNET_REQUEST_GETCURRENTMODE ) )
+    {
+        RespondInt( response, state.editMode ? 2 : ( state.recording ? 1 : 0 ) );
+    }
+    else if( SameCommand( command, NATNET_REQUEST_STARTRECORDING ) || SameCommand( command, NATNET_REQUEST_STOPRECORDING ) )
+    {
+        state.recording = SameCommand( command, NATNET_REQUEST_STARTRECORDING );
+        RespondInt( response, 0 );
+    }
+    else if( SameCommand( command, NATNET_REQUEST_SWITCHTOLIVEMODE ) || SameCommand( command, NATNET_REQUEST_SWITCHTOEDITMODE ) )
+    {
+        state.editMode = SameCommand( command, NATNET_REQUEST_SWITCHTOEDITMODE );
+        state.playing = true;
+        RespondInt( response, 0 );
+    }
+    else if( SameCommand( command, NATNET_REQUEST_TIMELINEPLAY ) || SameCommand( command, NATNET_REQUEST_TIMELINESTOP ) )
+    {
+        state.playing = SameCommand( command, NATNET_REQUEST_TIMELINEPLAY );
+        RespondInt( response, 0 );
+    }
+    else if( SameCommand( command, NATNET_REQUEST_SETPLAYBACKCURRENTFRAME ) )
+    {
+        state.seekFrame = atoi( arg1.c_str() );
+        RespondInt( response, 0 );
+    }
+    else if( SameCommand( command, NATNET_REQUEST_SETPLAYBACKTAKENAME ) || SameCommand( command, NATNET_REQUEST_SETRECORDTAKENAME ) ||
+             SameCommand( command, NATNET_REQUEST_SETCURRENTSESSION ) || SameCommand( command, NATNET_REQUEST_SETPLAYBACKSTARTFRAME ) ||
+             SameCommand( command, NATNET_REQUEST_SETPLAYBACKSTOPFRAME ) || SameCommand( command, NATNET_REQUEST_SETPLAYBACKLOOPING ) )
+    {
+        // accepted, no effect on the synthetic scene
+        RespondInt( response, 0 );
+    }
+    else if( SameCommand( command, NATNET_REQUEST_CURRENTSESSIONPATH ) )
+    {
+        RespondString( response, "/mockServer/Session/" );
+    }
+    else if( SameCommand( command, NATNET_REQUEST_ENABLEASSET ) || SameCommand( command, NATNET_REQUEST_DISABLEASSET ) ||
+             SameCommand( command, NATNET_REQUEST_RECALIBRATEASSET ) || SameCommand( command, NATNET_REQUEST_RESETASSETORIENTATION ) )
+    {
+        bool found = false;
+        for( const std::string& name : state.assetNames )
+        {
+            found = found || ( name == arg1 );
+        }
+        RespondInt( response, found ? 0 : 1 );
+    }
+    else if( SameCommand( command, NATNET_REQUEST_GETPROPERTY ) )
+    {
+        std::string key = arg1 + "," + ( ( args.size() > 2 ) ? args[2] : std::string() );
+        auto it = state.properties.find( key );
+        RespondString( response, ( it != state.properties.end() ) ? it->second : std::string() );
+    }
+    else if( SameCommand( command, NATNET_REQUEST_SETPROPETRY ) )
+    {
+        if( args.size() < 4 )
+        {
+            RespondInt( response, 1 );
+            return true;
+        }
+        state.properties[arg1 + "," + args[2]] = args[3];
+        RespondInt( response, 0 );
+    }
+    else if( SameCommand( command, NATNET_REQUEST_GETTAKEPROPERTY ) )
+    {
+        RespondString( response, std::string() );
+    }
+    else if( SameCommand( command, NATNET_REQUEST_GETCURRENTTAKELENGTH ) )
+    {
+        RespondInt( response, 0 );
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+// Names that asset requests (EnableAsset, RecalibrateAsset ...) can refer to
+std::vector<std::string> AssetNames( const sDataDescriptions& descriptions )
+{
+    std::vector<std::string> names;
+    for( int i = 0; i < descriptions.nDataDescriptions; i++ )
+    {
+        const sDataDescription& description = descriptions.arrDataDescriptions[i];
+        switch( description.type )
+        {
+        case Descriptor_RigidBody:
+            names.push_back( description.Data.RigidBodyDescription->szName );
+            break;
+        case Descriptor_Skeleton:
+            names.push_back( description.Data.SkeletonDescription->szName );
+            break;
+        case Descriptor_Asset:
+            names.push_back( description.Data.AssetDescription->szName );
+            break;
+        default:
+            break;
+        }
+    }
+    return names;
+}
+
+uint64_t SteadyNanoseconds()
+{
+    return (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+} // namespace
+
+int main( int argc, char* argv[] )
+{
+    MockOptions options;
+    try
+    {
+        if( !ParseArgs( argc, argv, options ) )
+        {
+            PrintUsage();
+            return 1;
+        }
+    }
+    catch( std::exception& e )
+    {
+        printf( "Invalid address: %s\n", e.what() );
+        return 1;
+    }
+
+    MockState state;
+    state.version[0] = options.version[0];
+    state.version[1] = options.version[1];
+
+    try
+    {
+        boost::asio::io_service ioService;
+        natnet::NatNetServer server( ioService, options.server );
+
+        sSender_Server serverInfo;
+        memset( &serverInfo, 0, sizeof( serverInfo ) );
+        strncpy( serverInfo.Common.szName, "mockServer", sizeof( serverInfo.Common.szName ) - 1 );
+        serverInfo.Common.Version[0] = 3;
+        serverInfo.Common.Version[1] = 1;
+        serverInfo.Common.NatNetVersion[0] = (uint8_t) options.version[0];
+        serverInfo.Common.NatNetVersion[1] = (uint8_t) options.version[1];
+        serverInfo.HighResClockFrequency = 1000000000;
+        server.setServerInfo( serverInfo );
+
+        double frameRate = options.scene.frameRate;
+        server.setRequestHandler( [&state, frameRate]( const std::string& request, std::vector<char>& response )
+        {
+            return HandleRequest( state, frameRate, request, response );
+        } );
+
+        boost::asio::signal_set signals( ioService, SIGINT, SIGTERM );
+        signals.async_wait( [&ioService]( const boost::system::error_code&, int )
+        {
+            gStop = true;
+            ioService.stop();
+        } );
+        std::thread commandThread( [&ioService] { ioService.run(); } );
+
+        printf( "mockServer: NatNet %d.%d, %s, %.0f frames/s\n", options.version[0], options.version[1],
+            options.server.multicast ? "multicast" : "unicast", options.rate );
+
+        std::unique_ptr<natnet::FrameSynthesizer> synthesizer;
+        int version[2] = { 0, 0 };
+        std::vector<char> payload;
+        int16_t pendingParams = 0;
+        int32_t frameNumber = 0;
+        uint64_t sent = 0;
+        uint64_t oversized = 0;
+
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        std::chrono::steady_clock::time_point next = begin;
+        std::chrono::nanoseconds period( options.rate > 0.0 ? (int64_t) ( 1e9 / options.rate ) : 0 );
+
+        while( !gStop && ( ( options.frames == 0 ) || ( sent < options.frames ) ) )
+        {
+            int16_t params = 0;
+            bool advance = true;
+            {
+                std::lock_guard<std::mutex> lock( state.mutex );
+                if( ( state.version[0] != version[0] ) || ( state.version[1] != version[1] ) )
+                {
+                    // first frame in a new version carries the change flags
+                    pendingParams = synthesizer ? 0x02 | 0x08 : 0;
+                    version[0] = state.version[0];
+                    version[1] = state.version[1];
+                    serverInfo.Common.NatNetVersion[0] = (uint8_t) version[0];
+                    serverInfo.Common.NatNetVersion[1] = (uint8_t) version[1];
+                    server.setServerInfo( serverInfo );
+                    synthesizer.reset( new natnet::FrameSynthesizer( options.scene, natnet::FrameSectionsOf( version[0], version[1] ) ) );
+                    state.assetNames = AssetNames( synthesizer->descriptions() );
+
+                    std::vector<char> modelDef;
+                    natnet::PackDataDescriptions( synthesizer->descriptions(), version[0], version[1], modelDef );
+                    server.setModelDef( modelDef.data(), (uint32_t) modelDef.size() );
+                }
+                if( state.seekFrame >= 0 )
+                {
+                    frameNumber = state.seekFrame;
+                    state.seekFrame = -1;
+                }
+                params = ( state.recording ? 0x01 : 0 ) | ( state.editMode ? 0x04 : 0 );
+                advance = !state.editMode || state.playing;
+            }
+
+            sFrameOfMocapData& frame = synthesizer->synthesize( frameNumber );
+            uint64_t now = SteadyNanoseconds();
+            frame.CameraMidExposureTimestamp = now;
+            frame.CameraDataReceivedTimestamp = now;
+            frame.TransmitTimestamp = now;
+            int64_t wallClock = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch() ).count();
+            frame.PrecisionTimestampSecs = (uint32_t) ( wallClock / 1000000000 );
+            frame.PrecisionTimestampFractionalSecs = (uint32_t) ( ( wallClock % 1000000000 ) * 4294967296.0 / 1e9 );
+            frame.params = params | pendingParams;
+            pendingParams = 0;
+
+            natnet::PackFrameData( frame, version[0], version[1], payload );
+            if( server.sendFrame( payload.data(), (uint32_t) payload.size() ) )
+            {
+                sent++;
+            }
+            else if( payload.size() > MAX_PACKETSIZE )
+            {
+                if( oversized++ == 0 )
+                {
+                    printf( "Frames of %zu bytes do not fit a packet (%d bytes); reduce the scene\n", payload.size(), MAX_PACKETSIZE );
+                }
+                if( options.frames != 0 )
+                {
+                    break;
+                }
+            }
+            if( advance )
+            {
+                frameNumber++;
+            }
+
+            if( options.rate > 0.0 )
+            {
+                next += period;
+                std::chrono::steady_clock::time_point current = std::chrono::steady_clock::now();
+                if( next < current - period )
+                {
+                    // fell behind by more than a frame: skip ahead rather than burst
+                    next = current;
+                }
+                std::this_thread::sleep_until( next );
+            }
+        }
+
+        double seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - begin ).count();
+        printf( "Sent %" PRIu64 " frames of %zu bytes in %.3f s (%.1f frames/s)\n", sent, payload.size(), seconds,
+            seconds > 0.0 ? sent / seconds : 0.0 );
+
+        ioService.stop();
+        commandThread.join();
+    }
+    catch( std::exception& e )
+    {
+        printf( "Exception: %s\n", e.what() );
+        return 1;
+    }
+
+    return 0;
+}
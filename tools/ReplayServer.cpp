@@ -0,0 +1,237 @@
+/**
+ * \file   ReplayServer.cpp
+ * \brief  Replays a recording (see src/Recording.h) as a NatNet server.
+ * Sends the recorded NAT_FRAMEOFDATA payloads on the data port and answers
+ * the command port like Motive, so packetClient, sampleClient or any other
+ * NatNet client can be run against recorded data without Motive.
+ * Frames are sent unmodified, in recorded order, paced by their receive
+ * times (scaled by --speed) or back to back (--max). Their timestamps are
+ * those of the original session.
+ * Usage:
+ *  replayServer <recording> [options]
+ *  --speed N           replay at N times the recorded rate (default 1)
+ *  --max               send as fast as possible
+ *  --loop              start over at the end of the recording
+ *  --start FRAME       start at the first frame numbered FRAME or later
+ *  --unicast           send to connected clients instead of the multicast group
+ *  --local IP          address of the interface to serve on
+ *  --multicast IP      multicast group (default 239.255.42.99)
+ *  --command-port N    (default 1510)
+ *  --data-port N       (default 1511)
+ */
+
+#include "NatNetServer.h"
+#include "RecordingReader.h"
+
+#include <boost/asio.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <string>
+#include <thread>
+
+namespace
+{
+
+struct ReplayOptions
+{
+    const char* path = nullptr;
+    double speed = 1.0;                 // 0: as fast as possible
+    bool loop = false;
+    bool seek = false;
+    int32_t startFrame = 0;
+    natnet::ServerOptions server;
+};
+
+void PrintUsage()
+{
+    printf( "Usage: replayServer <recording> [--speed N | --max] [--loop] [--start FRAME]\n"
+            "       [--unicast] [--local IP] [--multicast IP] [--command-port N] [--data-port N]\n" );
+}
+
+bool ParseArgs( int argc, char* argv[], ReplayOptions& options )
+{
+    for( int i = 1; i < argc; i++ )
+    {
+        std::string arg = argv[i];
+        bool hasValue = ( i + 1 < argc );
+        if( arg == "--speed" && hasValue )
+        {
+            options.speed = atof( argv[++i] );
+            if( options.speed <= 0.0 )
+            {
+                return false;
+            }
+        }
+        else if( arg == "--max" )
+        {
+            options.speed = 0.0;
+        }
+        else if( arg == "--loop" )
+        {
+            options.loop = true;
+        }
+        else if( arg == "--start" && hasValue )
+        {
+            options.seek = true;
+            options.startFrame = atoi( argv[++i] );
+        }
+        else if( arg == "--unicast" )
+        {
+            options.server.multicast = false;
+        }
+        else if( arg == "--local" && hasValue )
+        {
+            options.server.localAddress = boost::asio::ip::address::from_string( argv[++i] );
+        }
+        else if( arg == "--multicast" && hasValue )
+        {
+            options.server.multicastAddress = boost::asio::ip::address::from_string( argv[++i] );
+        }
+        else if( arg == "--command-port" && hasValue )
+        {
+            options.server.commandPort = (unsigned short) atoi( argv[++i] );
+        }
+        else if( arg == "--data-port" && hasValue )
+        {
+            options.server.dataPort = (unsigned short) atoi( argv[++i] );
+        }
+        else if( !options.path && arg[0] != '-' )
+        {
+            options.path = argv[i];
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return options.path != nullptr;
+}
+
+// Recorded server info, announcing the bitstream version of the frames that are sent
+sSender_Server ServerInfo( const natnet::RecordingReader& reader, size_t frame )
+{
+    sSender_Server server;
+    memset( &server, 0, sizeof( server ) );
+    natnet::RecordedPayload recorded = reader.serverInfo();
+    if( recorded.nBytes >= sizeof( server ) )
+    {
+        memcpy( &server, recorded.data, sizeof( server ) );
+    }
+    else
+    {
+        strncpy( server.Common.szName, "replayServer", sizeof( server.Common.szName ) - 1 );
+    }
+    const int* version = reader.frameContext( frame ).natNetVersion();
+    for( int i = 0; i < 4; i++ )
+    {
+        server.Common.NatNetVersion[i] = (uint8_t) version[i];
+    }
+    return server;
+}
+
+std::atomic<bool> gStop( false );
+
+} // namespace
+
+int main( int argc, char* argv[] )
+{
+    ReplayOptions options;
+    try
+    {
+        if( !ParseArgs( argc, argv, options ) )
+        {
+            PrintUsage();
+            return 1;
+        }
+    }
+    catch( std::exception& e )
+    {
+        printf( "Invalid address: %s\n", e.what() );
+        return 1;
+    }
+
+    natnet::RecordingReader reader;
+    if( !reader.open( options.path ) )
+    {
+        printf( "Unable to open %s: %s\n", options.path, reader.error().c_str() );
+        return 1;
+    }
+    size_t first = options.seek ? reader.seekFrameNumber( options.startFrame ) : 0;
+    if( first >= reader.frameCount() )
+    {
+        printf( "%s: no frames to replay\n", options.path );
+        return 1;
+    }
+    printf( "%s: %zu frames%s\n", options.path, reader.frameCount(), reader.truncated() ? " (truncated)" : "" );
+
+    try
+    {
+        boost::asio::io_service ioService;
+        natnet::NatNetServer server( ioService, options.server );
+
+        boost::asio::signal_set signals( ioService, SIGINT, SIGTERM );
+        signals.async_wait( [&ioService]( const boost::system::error_code&, int )
+        {
+            gStop = true;
+            ioService.stop();
+        } );
+        std::thread commandThread( [&ioService] { ioService.run(); } );
+
+        const natnet::DecoderContext* context = nullptr;
+        const char* modelDef = nullptr;
+        uint64_t sent = 0;
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+
+        do
+        {
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            int64_t firstNanoseconds = reader.frame( first ).nanoseconds;
+
+            for( size_t i = first; ( i < reader.frameCount() ) && !gStop; i++ )
+            {
+                if( &reader.frameContext( i ) != context )
+                {
+                    context = &reader.frameContext( i );
+                    server.setServerInfo( ServerInfo( reader, i ) );
+                }
+                natnet::RecordedPayload descriptions;
+                if( reader.frameDescriptions( i, descriptions ) && ( descriptions.data != modelDef ) )
+                {
+                    modelDef = descriptions.data;
+                    server.setModelDef( descriptions.data, descriptions.nBytes );
+                }
+
+                natnet::RecordedPayload frame = reader.framePayload( i );
+                if( options.speed > 0.0 )
+                {
+                    std::chrono::nanoseconds offset( (int64_t) ( ( frame.nanoseconds - firstNanoseconds ) / options.speed ) );
+                    std::this_thread::sleep_until( start + offset );
+                }
+                if( server.sendFrame( frame.data, frame.nBytes ) )
+                {
+                    sent++;
+                }
+            }
+        } while( options.loop && !gStop );
+
+        double seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - begin ).count();
+        printf( "Sent %" PRIu64 " frames in %.3f s (%.1f frames/s)\n", sent, seconds, seconds > 0.0 ? sent / seconds : 0.0 );
+
+        ioService.stop();
+        commandThread.join();
+    }
+    catch( std::exception& e )
+    {
+        printf( "Exception: %s\n", e.what() );
+        return 1;
+    }
+
+    return 0;
+}